@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tnt::dsp
+{
+
+/*!
+\brief Size (in bytes) of a cache line
+*/
+constexpr size_t cache_line_size = 64;
+
+/*!
+\brief Allocator that aligns every allocation to the specified boundary
+
+Aligned storage allows SIMD loads and stores to use their aligned forms and keeps samples from
+being split across cache lines.
+*/
+template <typename T, size_t Alignment = cache_line_size>
+class aligned_allocator
+{
+public:
+    static_assert(Alignment >= alignof(T), "Alignment must satisfy the alignment of T");
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of 2");
+
+    /*!
+    \brief Value type
+    */
+    using value_type = T;
+
+    /*!
+    \brief Alignment (in bytes) of every allocation
+    */
+    static constexpr size_t alignment = Alignment;
+
+    /*!
+    \brief Rebinds the allocator to another value type
+    */
+    template <typename U>
+    struct rebind
+    {
+        using other = aligned_allocator<U, Alignment>;
+    };
+
+    /*!
+    \brief Constructor
+    */
+    aligned_allocator() noexcept = default;
+
+    /*!
+    \brief Converting constructor
+    */
+    template <typename U>
+    aligned_allocator(const aligned_allocator<U, Alignment>&) noexcept
+    {}
+
+    /*!
+    \brief Allocates aligned storage
+    \param[in] size Number of elements to allocate storage for
+    \return Pointer to the allocated storage
+    */
+    T* allocate(const size_t size)
+    {
+        return static_cast<T*>(::operator new(size * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    /*!
+    \brief Deallocates storage obtained from allocate()
+    \param[in] data Pointer to the storage
+    \param[in] size Number of elements the storage was allocated for
+    */
+    void deallocate(T* const data, const size_t size) noexcept
+    {
+        ::operator delete(data, size * sizeof(T), std::align_val_t(Alignment));
+    }
+};
+
+/*!
+\brief Compares two aligned allocators
+\return True (memory from one can always be deallocated by the other)
+*/
+template <typename T, typename U, size_t Alignment>
+bool operator==(const aligned_allocator<T, Alignment>&, const aligned_allocator<U, Alignment>&)
+{
+    return true;
+}
+
+/*!
+\brief Compares two aligned allocators
+\return False (memory from one can always be deallocated by the other)
+*/
+template <typename T, typename U, size_t Alignment>
+bool operator!=(const aligned_allocator<T, Alignment>&, const aligned_allocator<U, Alignment>&)
+{
+    return false;
+}
+
+namespace impl
+{
+
+// Vector whose storage is aligned to a cache line
+template <typename T>
+using aligned_vector = std::vector<T, aligned_allocator<T>>;
+
+// Adapts an allocator so that elements constructed without a value are
+// default initialized instead of value initialized. Samples that are about to
+// be overwritten are then not zeroed first. Trivially copyable types are left
+// untouched entirely (the default constructor of std::complex would zero it).
+template <typename Allocator>
+class default_init_allocator : public Allocator
+{
+    using traits = std::allocator_traits<Allocator>;
+
+public:
+    template <typename U>
+    struct rebind
+    {
+        using other = default_init_allocator<typename traits::template rebind_alloc<U>>;
+    };
+
+    using Allocator::Allocator;
+
+    default_init_allocator() = default;
+
+    default_init_allocator(const Allocator& allocator) noexcept
+        : Allocator(allocator)
+    {}
+
+    template <typename B>
+    default_init_allocator(const default_init_allocator<B>& allocator) noexcept
+        : Allocator(static_cast<const B&>(allocator))
+    {}
+
+    template <typename U>
+    void construct(U* const data) noexcept(std::is_nothrow_default_constructible_v<U>)
+    {
+        if constexpr (!std::is_trivially_copyable_v<U> || !std::is_trivially_destructible_v<U>)
+        {
+            ::new (static_cast<void*>(data)) U;
+        }
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* const data, Args&&... args)
+    {
+        traits::construct(static_cast<Allocator&>(*this), data, std::forward<Args>(args)...);
+    }
+};
+
+template <typename A, typename B>
+bool operator==(const default_init_allocator<A>& a, const default_init_allocator<B>& b)
+{
+    return static_cast<const A&>(a) == static_cast<const B&>(b);
+}
+
+template <typename A, typename B>
+bool operator!=(const default_init_allocator<A>& a, const default_init_allocator<B>& b)
+{
+    return !(a == b);
+}
+
+// Vector that leaves elements constructed without a value uninitialized
+template <typename T, typename Allocator>
+using default_init_vector = std::vector<T, default_init_allocator<Allocator>>;
+
+// Checks whether a pointer is aligned to the specified boundary
+inline bool is_aligned(const void* const data, const size_t alignment = cache_line_size)
+{
+    return reinterpret_cast<std::uintptr_t>(data) % alignment == 0;
+}
+
+// Tells the compiler that a pointer is aligned to the specified boundary so
+// that it can skip the unaligned prologue of vectorized loops. The pointer
+// must actually be aligned (see is_aligned).
+template <size_t Alignment = cache_line_size, typename T>
+T* assume_aligned(T* const data)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<T*>(__builtin_assume_aligned(data, Alignment));
+#else
+    return data;
+#endif
+}
+
+}  // namespace impl
+
+}  // namespace tnt::dsp
@@ -1,14 +1,164 @@
 #pragma once
 
+#include "aligned_allocator.hpp"
+#include "impl/type_traits.hpp"
+#include "impl/vector_math.hpp"
 #include "signal.hpp"
+#include "signal_expression.hpp"
+#include "signal_view.hpp"
 
 #include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <complex>
+#include <cstddef>
 #include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
 
 namespace tnt::dsp
 {
 
+/*!
+\brief Precision policies of the vectorized analysis functions
+*/
+namespace precision
+{
+
+/*!
+\brief Results within a few units in the last place over the whole domain of the library functions
+(see spectral_stats())
+*/
+struct exact_t
+{};
+
+/*!
+\brief Faster approximations with small, bounded errors (stated by each function)
+*/
+struct fast_t
+{};
+
+/*!
+\brief Selects results within a few units in the last place
+*/
+inline constexpr exact_t exact{};
+
+/*!
+\brief Selects faster approximations with small, bounded errors
+*/
+inline constexpr fast_t fast{};
+
+}  // namespace precision
+
+namespace impl
+{
+
+// Calculates the magnitude of a sample inside an expression. Complex samples
+// are written out as sqrt(re^2 + im^2) instead of std::abs (which avoids
+// intermediate overflow at the cost of vectorization).
+struct magnitude_map
+{
+    template <typename T>
+    auto operator()(const T& sample) const
+    {
+        if constexpr (is_complex_v<T>)
+        {
+            return std::sqrt(sample.real() * sample.real() + sample.imag() * sample.imag());
+        }
+        else
+        {
+            return std::abs(sample);
+        }
+    }
+};
+
+// Calculates the power of a sample inside an expression
+struct power_map
+{
+    template <typename T>
+    auto operator()(const T& sample) const
+    {
+        if constexpr (is_complex_v<T>)
+        {
+            return sample.real() * sample.real() + sample.imag() * sample.imag();
+        }
+        else
+        {
+            return sample * sample;
+        }
+    }
+};
+
+template <typename P>
+struct is_precision : std::false_type
+{};
+
+template <>
+struct is_precision<precision::exact_t> : std::true_type
+{};
+
+template <>
+struct is_precision<precision::fast_t> : std::true_type
+{};
+
+template <typename P>
+constexpr bool is_precision_v = is_precision<P>::value;
+
+// Functions used to calculate the results of each precision
+template <typename Precision>
+struct math_policy;
+
+template <>
+struct math_policy<precision::exact_t>
+{
+    template <typename T>
+    static T sqrt(const T x)
+    {
+        return vector_sqrt(x);
+    }
+
+    template <typename T>
+    static T atan2(const T y, const T x)
+    {
+        return vector_atan2(y, x);
+    }
+
+    template <typename T>
+    static T log(const T x)
+    {
+        return vector_log(x);
+    }
+};
+
+template <>
+struct math_policy<precision::fast_t>
+{
+    template <typename T>
+    static T sqrt(const T x)
+    {
+        return fast_sqrt(x);
+    }
+
+    template <typename T>
+    static T atan2(const T y, const T x)
+    {
+        return fast_atan2(y, x);
+    }
+
+    template <typename T>
+    static T log(const T x)
+    {
+        return fast_log(x);
+    }
+};
+
+// Number of samples that spectral_stats() works on at a time, small enough
+// that a block and everything calculated from it stays in the L1 cache
+inline constexpr size_t spectral_block_size = 256;
+
+}  // namespace impl
+
 /*!
 \brief Calculates the magnitude of a real sample
 \param[in] sample - Real sample
@@ -31,18 +181,57 @@ T magnitude(const std::complex<T>& sample)
     return std::abs(sample);
 }
 
+/*!
+\brief Calculates the magnitude spectrum of a real signal
+\param[in] x - View of the real samples
+\return Magnitude of the signal
+*/
+template <typename T>
+signal<T> magnitude(const signal_view<const T>& x)
+{
+    signal<T> x_magnitude(x.sample_rate(), x.size(), uninitialized);
+    magnitude(x, x_magnitude.view());
+
+    return x_magnitude;
+}
+
 /*!
 \brief Calculates the magnitude spectrum of a real signal
 \param[in] x - Real signal
 \return Magnitude of the signal
 */
+template <typename T, typename Allocator>
+signal<T> magnitude(const signal<T, Allocator>& x)
+{
+    return magnitude(x.view());
+}
+
+/*!
+\brief Calculates the magnitude spectrum of a real signal in place
+
+The result is calculated in the storage of \a x, which is then returned, so nothing is allocated.
+
+\param[in] x - Real signal (moved from)
+\return Magnitude of the signal
+*/
+template <typename T, typename Allocator, typename = std::enable_if_t<!impl::is_complex_v<T>>>
+signal<T, Allocator> magnitude(signal<T, Allocator>&& x)
+{
+    magnitude(x.view(), x.view());
+
+    return std::move(x);
+}
+
+/*!
+\brief Calculates the magnitude spectrum of a complex signal
+\param[in] x - View of the complex samples
+\return Magnitude of the signal
+*/
 template <typename T>
-signal<T> magnitude(const signal<T>& x)
+signal<T> magnitude(const signal_view<const std::complex<T>>& x)
 {
-    signal<T> x_magnitude(x.sample_rate(), x.size());
-    std::transform(x.begin(), x.end(), x_magnitude.begin(), [](const auto& sample) {
-        return magnitude(sample);
-    });
+    signal<T> x_magnitude(x.sample_rate(), x.size(), uninitialized);
+    magnitude(x, x_magnitude.view());
 
     return x_magnitude;
 }
@@ -52,15 +241,130 @@ signal<T> magnitude(const signal<T>& x)
 \param[in] x - Complex signal
 \return Magnitude of the signal
 */
+template <typename T, typename Allocator>
+signal<T> magnitude(const signal<std::complex<T>, Allocator>& x)
+{
+    return magnitude(x.view());
+}
+
+/*!
+\brief Calculates the magnitude spectrum of a view of mutable samples
+\param[in] x - View of the input samples
+\return Magnitude of the signal
+*/
+template <typename T, typename = std::enable_if_t<!std::is_const_v<T>>>
+auto magnitude(const signal_view<T>& x)
+{
+    return magnitude(signal_view<const T>(x));
+}
+
+/*!
+\brief Calculates the magnitude spectrum of a signal into an existing view
+
+Nothing is allocated. For real samples \a y may be the same view as \a x, in which case the
+magnitude spectrum is calculated in place.
+
+\param[in] x - View of the input samples
+\param[out] y - View of the magnitudes to write (the same size as \a x)
+*/
 template <typename T>
-signal<T> magnitude(const signal<std::complex<T>>& x)
+void magnitude(const signal_view<const T>& x, const signal_view<impl::real_type_t<T>>& y)
 {
-    signal<T> x_magnitude(x.sample_rate(), x.size());
-    std::transform(x.begin(), x.end(), x_magnitude.begin(), [](const auto& sample) {
+    assert(y.size() == x.size());
+
+    std::transform(x.begin(), x.end(), y.begin(), [](const auto& sample) {
         return magnitude(sample);
     });
+}
 
-    return x_magnitude;
+/*!
+\brief Calculates the magnitude spectrum of a signal into an existing view
+\param[in] x - Input signal
+\param[out] y - View of the magnitudes to write (the same size as \a x)
+*/
+template <typename T, typename Allocator>
+void magnitude(const signal<T, Allocator>& x, const signal_view<impl::real_type_t<T>>& y)
+{
+    magnitude(x.view(), y);
+}
+
+/*!
+\brief Calculates the magnitude spectrum of a view of mutable samples into an existing view
+\param[in] x - View of the input samples
+\param[out] y - View of the magnitudes to write (the same size as \a x)
+*/
+template <typename T, typename = std::enable_if_t<!std::is_const_v<T>>>
+void magnitude(const signal_view<T>& x, const signal_view<impl::real_type_t<T>>& y)
+{
+    magnitude(signal_view<const T>(x), y);
+}
+
+/*!
+\brief Calculates the magnitude spectrum of a signal into an existing signal
+
+\a y is resized to the size of \a x, which only allocates if it does not have the capacity, so
+reusing the same output for inputs of the same size allocates nothing.
+
+\param[in] x - View of the input samples
+\param[out] y - Signal of the magnitudes to write (with the sample rate of \a x)
+*/
+template <typename T, typename Allocator>
+void magnitude(const signal_view<const T>& x, signal<impl::real_type_t<T>, Allocator>& y)
+{
+    assert(y.sample_rate() == x.sample_rate());
+
+    y.resize(x.size(), uninitialized);
+    magnitude(x, y.view());
+}
+
+/*!
+\brief Calculates the magnitude spectrum of a signal into an existing signal
+\param[in] x - Input signal
+\param[out] y - Signal of the magnitudes to write (with the sample rate of \a x)
+*/
+template <typename T, typename Allocator1, typename Allocator2>
+void magnitude(const signal<T, Allocator1>& x, signal<impl::real_type_t<T>, Allocator2>& y)
+{
+    magnitude(x.view(), y);
+}
+
+/*!
+\brief Calculates the magnitude spectrum of a view of mutable samples into an existing signal
+\param[in] x - View of the input samples
+\param[out] y - Signal of the magnitudes to write (with the sample rate of \a x)
+*/
+template <typename T, typename Allocator, typename = std::enable_if_t<!std::is_const_v<T>>>
+void magnitude(const signal_view<T>& x, signal<impl::real_type_t<T>, Allocator>& y)
+{
+    magnitude(signal_view<const T>(x), y);
+}
+
+/*!
+\brief Calculates the magnitude of each sample of an expression
+
+The result is another expression, so the magnitude is fused into the loop that evaluates it.
+
+\param[in] e - Expression
+\return Expression representing the magnitude of each sample
+*/
+template <typename Op, typename... Operands>
+auto magnitude(const signal_expression<Op, Operands...>& e)
+{
+    return impl::make_expression<impl::magnitude_map>(e);
+}
+
+/*!
+\brief Calculates the magnitude of each sample of an expression
+
+The result is another expression, so the magnitude is fused into the loop that evaluates it.
+
+\param[in] e - Expression
+\return Expression representing the magnitude of each sample
+*/
+template <typename Op, typename... Operands>
+auto magnitude(signal_expression<Op, Operands...>&& e)
+{
+    return impl::make_expression<impl::magnitude_map>(std::move(e));
 }
 
 /*!
@@ -69,7 +373,7 @@ signal<T> magnitude(const signal<std::complex<T>>& x)
 \param[in] epsilon Values below epsilon will be treated as 0
 \return Phase angle (in radians) of the sample
 */
-template <typename T>
+template <typename T, typename = std::enable_if_t<!impl::is_signal_like_v<T>>>
 T phase(const T& sample, const T& epsilon)
 {
     const auto x = std::abs(sample) < epsilon ? 0 : sample;
@@ -121,18 +425,57 @@ T phase(const std::complex<T>& sample)
     return phase(sample, std::numeric_limits<T>::epsilon() * 100);
 }
 
+/*!
+\brief Calculates the phase spectrum (in radians) of a real signal
+\param[in] x - View of the real samples
+\return Phase spectrum (in radians) of the signal
+*/
+template <typename T>
+signal<T> phase(const signal_view<const T>& x)
+{
+    signal<T> x_phase(x.sample_rate(), x.size(), uninitialized);
+    phase(x, x_phase.view());
+
+    return x_phase;
+}
+
 /*!
 \brief Calculates the phase spectrum (in radians) of a real signal
 \param[in] x - Real signal
 \return Phase spectrum (in radians) of the signal
 */
+template <typename T, typename Allocator>
+signal<T> phase(const signal<T, Allocator>& x)
+{
+    return phase(x.view());
+}
+
+/*!
+\brief Calculates the phase spectrum (in radians) of a real signal in place
+
+The result is calculated in the storage of \a x, which is then returned, so nothing is allocated.
+
+\param[in] x - Real signal (moved from)
+\return Phase spectrum (in radians) of the signal
+*/
+template <typename T, typename Allocator, typename = std::enable_if_t<!impl::is_complex_v<T>>>
+signal<T, Allocator> phase(signal<T, Allocator>&& x)
+{
+    phase(x.view(), x.view());
+
+    return std::move(x);
+}
+
+/*!
+\brief Calculates the phase spectrum (in radians) of a complex signal
+\param[in] x - View of the complex samples
+\return Phase spectrum (in radians) of the signal
+*/
 template <typename T>
-signal<T> phase(const signal<T>& x)
+signal<T> phase(const signal_view<const std::complex<T>>& x)
 {
-    signal<T> x_phase(x.sample_rate(), x.size());
-    std::transform(x.begin(), x.end(), x_phase.begin(), [](const auto& sample) {
-        return phase(sample);
-    });
+    signal<T> x_phase(x.sample_rate(), x.size(), uninitialized);
+    phase(x, x_phase.view());
 
     return x_phase;
 }
@@ -142,15 +485,103 @@ signal<T> phase(const signal<T>& x)
 \param[in] x - Complex signal
 \return Phase spectrum (in radians) of the signal
 */
+template <typename T, typename Allocator>
+signal<T> phase(const signal<std::complex<T>, Allocator>& x)
+{
+    return phase(x.view());
+}
+
+/*!
+\brief Calculates the phase spectrum (in radians) of a view of mutable samples
+\param[in] x - View of the input samples
+\return Phase spectrum (in radians) of the signal
+*/
+template <typename T, typename = std::enable_if_t<!std::is_const_v<T>>>
+auto phase(const signal_view<T>& x)
+{
+    return phase(signal_view<const T>(x));
+}
+
+/*!
+\brief Calculates the phase spectrum (in radians) of a signal into an existing view
+
+Nothing is allocated. For real samples \a y may be the same view as \a x, in which case the
+phase spectrum (in radians) is calculated in place.
+
+\param[in] x - View of the input samples
+\param[out] y - View of the phase angles (in radians) to write (the same size as \a x)
+*/
 template <typename T>
-signal<T> phase(const signal<std::complex<T>>& x)
+void phase(const signal_view<const T>& x, const signal_view<impl::real_type_t<T>>& y)
 {
-    signal<T> x_phase(x.sample_rate(), x.size());
-    std::transform(x.begin(), x.end(), x_phase.begin(), [](const auto& sample) {
+    assert(y.size() == x.size());
+
+    std::transform(x.begin(), x.end(), y.begin(), [](const auto& sample) {
         return phase(sample);
     });
+}
 
-    return x_phase;
+/*!
+\brief Calculates the phase spectrum (in radians) of a signal into an existing view
+\param[in] x - Input signal
+\param[out] y - View of the phase angles (in radians) to write (the same size as \a x)
+*/
+template <typename T, typename Allocator>
+void phase(const signal<T, Allocator>& x, const signal_view<impl::real_type_t<T>>& y)
+{
+    phase(x.view(), y);
+}
+
+/*!
+\brief Calculates the phase spectrum (in radians) of a view of mutable samples into an existing view
+\param[in] x - View of the input samples
+\param[out] y - View of the phase angles (in radians) to write (the same size as \a x)
+*/
+template <typename T, typename = std::enable_if_t<!std::is_const_v<T>>>
+void phase(const signal_view<T>& x, const signal_view<impl::real_type_t<T>>& y)
+{
+    phase(signal_view<const T>(x), y);
+}
+
+/*!
+\brief Calculates the phase spectrum (in radians) of a signal into an existing signal
+
+\a y is resized to the size of \a x, which only allocates if it does not have the capacity, so
+reusing the same output for inputs of the same size allocates nothing.
+
+\param[in] x - View of the input samples
+\param[out] y - Signal of the phase angles (in radians) to write (with the sample rate of \a x)
+*/
+template <typename T, typename Allocator>
+void phase(const signal_view<const T>& x, signal<impl::real_type_t<T>, Allocator>& y)
+{
+    assert(y.sample_rate() == x.sample_rate());
+
+    y.resize(x.size(), uninitialized);
+    phase(x, y.view());
+}
+
+/*!
+\brief Calculates the phase spectrum (in radians) of a signal into an existing signal
+\param[in] x - Input signal
+\param[out] y - Signal of the phase angles (in radians) to write (with the sample rate of \a x)
+*/
+template <typename T, typename Allocator1, typename Allocator2>
+void phase(const signal<T, Allocator1>& x, signal<impl::real_type_t<T>, Allocator2>& y)
+{
+    phase(x.view(), y);
+}
+
+/*!
+\brief Calculates the phase spectrum (in radians) of a view of mutable samples into an existing
+signal
+\param[in] x - View of the input samples
+\param[out] y - Signal of the phase angles (in radians) to write (with the sample rate of \a x)
+*/
+template <typename T, typename Allocator, typename = std::enable_if_t<!std::is_const_v<T>>>
+void phase(const signal_view<T>& x, signal<impl::real_type_t<T>, Allocator>& y)
+{
+    phase(signal_view<const T>(x), y);
 }
 
 /*!
@@ -175,18 +606,57 @@ T power(const std::complex<T>& sample)
     return std::norm(sample);
 }
 
+/*!
+\brief Calculates the power spectrum of a real signal
+\param[in] x - View of the real samples
+\return Power spectrum of the signal
+*/
+template <typename T>
+signal<T> power(const signal_view<const T>& x)
+{
+    signal<T> x_power(x.sample_rate(), x.size(), uninitialized);
+    power(x, x_power.view());
+
+    return x_power;
+}
+
 /*!
 \brief Calculates the power spectrum of a real signal
 \param[in] x - Real signal
 \return Power spectrum of the signal
 */
+template <typename T, typename Allocator>
+signal<T> power(const signal<T, Allocator>& x)
+{
+    return power(x.view());
+}
+
+/*!
+\brief Calculates the power spectrum of a real signal in place
+
+The result is calculated in the storage of \a x, which is then returned, so nothing is allocated.
+
+\param[in] x - Real signal (moved from)
+\return Power spectrum of the signal
+*/
+template <typename T, typename Allocator, typename = std::enable_if_t<!impl::is_complex_v<T>>>
+signal<T, Allocator> power(signal<T, Allocator>&& x)
+{
+    power(x.view(), x.view());
+
+    return std::move(x);
+}
+
+/*!
+\brief Calculates the power spectrum of a complex signal
+\param[in] x - View of the complex samples
+\return Power spectrum of the signal
+*/
 template <typename T>
-signal<T> power(const signal<T>& x)
+signal<T> power(const signal_view<const std::complex<T>>& x)
 {
-    signal<T> x_power(x.sample_rate(), x.size());
-    std::transform(x.begin(), x.end(), x_power.begin(), [](const auto& sample) {
-        return power(sample);
-    });
+    signal<T> x_power(x.sample_rate(), x.size(), uninitialized);
+    power(x, x_power.view());
 
     return x_power;
 }
@@ -196,15 +666,624 @@ signal<T> power(const signal<T>& x)
 \param[in] x - Complex signal
 \return Power spectrum of the signal
 */
+template <typename T, typename Allocator>
+signal<T> power(const signal<std::complex<T>, Allocator>& x)
+{
+    return power(x.view());
+}
+
+/*!
+\brief Calculates the power spectrum of a view of mutable samples
+\param[in] x - View of the input samples
+\return Power spectrum of the signal
+*/
+template <typename T, typename = std::enable_if_t<!std::is_const_v<T>>>
+auto power(const signal_view<T>& x)
+{
+    return power(signal_view<const T>(x));
+}
+
+/*!
+\brief Calculates the power spectrum of a signal into an existing view
+
+Nothing is allocated. For real samples \a y may be the same view as \a x, in which case the
+power spectrum is calculated in place.
+
+\param[in] x - View of the input samples
+\param[out] y - View of the powers to write (the same size as \a x)
+*/
 template <typename T>
-signal<T> power(const signal<std::complex<T>>& x)
+void power(const signal_view<const T>& x, const signal_view<impl::real_type_t<T>>& y)
 {
-    signal<T> x_power(x.sample_rate(), x.size());
-    std::transform(x.begin(), x.end(), x_power.begin(), [](const auto& sample) {
+    assert(y.size() == x.size());
+
+    std::transform(x.begin(), x.end(), y.begin(), [](const auto& sample) {
         return power(sample);
     });
+}
 
-    return x_power;
+/*!
+\brief Calculates the power spectrum of a signal into an existing view
+\param[in] x - Input signal
+\param[out] y - View of the powers to write (the same size as \a x)
+*/
+template <typename T, typename Allocator>
+void power(const signal<T, Allocator>& x, const signal_view<impl::real_type_t<T>>& y)
+{
+    power(x.view(), y);
+}
+
+/*!
+\brief Calculates the power spectrum of a view of mutable samples into an existing view
+\param[in] x - View of the input samples
+\param[out] y - View of the powers to write (the same size as \a x)
+*/
+template <typename T, typename = std::enable_if_t<!std::is_const_v<T>>>
+void power(const signal_view<T>& x, const signal_view<impl::real_type_t<T>>& y)
+{
+    power(signal_view<const T>(x), y);
+}
+
+/*!
+\brief Calculates the power spectrum of a signal into an existing signal
+
+\a y is resized to the size of \a x, which only allocates if it does not have the capacity, so
+reusing the same output for inputs of the same size allocates nothing.
+
+\param[in] x - View of the input samples
+\param[out] y - Signal of the powers to write (with the sample rate of \a x)
+*/
+template <typename T, typename Allocator>
+void power(const signal_view<const T>& x, signal<impl::real_type_t<T>, Allocator>& y)
+{
+    assert(y.sample_rate() == x.sample_rate());
+
+    y.resize(x.size(), uninitialized);
+    power(x, y.view());
+}
+
+/*!
+\brief Calculates the power spectrum of a signal into an existing signal
+\param[in] x - Input signal
+\param[out] y - Signal of the powers to write (with the sample rate of \a x)
+*/
+template <typename T, typename Allocator1, typename Allocator2>
+void power(const signal<T, Allocator1>& x, signal<impl::real_type_t<T>, Allocator2>& y)
+{
+    power(x.view(), y);
+}
+
+/*!
+\brief Calculates the power spectrum of a view of mutable samples into an existing signal
+\param[in] x - View of the input samples
+\param[out] y - Signal of the powers to write (with the sample rate of \a x)
+*/
+template <typename T, typename Allocator, typename = std::enable_if_t<!std::is_const_v<T>>>
+void power(const signal_view<T>& x, signal<impl::real_type_t<T>, Allocator>& y)
+{
+    power(signal_view<const T>(x), y);
+}
+
+/*!
+\brief Calculates the power of each sample of an expression
+
+The result is another expression, so the power is fused into the loop that evaluates it.
+
+\param[in] e - Expression
+\return Expression representing the power of each sample
+*/
+template <typename Op, typename... Operands>
+auto power(const signal_expression<Op, Operands...>& e)
+{
+    return impl::make_expression<impl::power_map>(e);
+}
+
+/*!
+\brief Calculates the power of each sample of an expression
+
+The result is another expression, so the power is fused into the loop that evaluates it.
+
+\param[in] e - Expression
+\return Expression representing the power of each sample
+*/
+template <typename Op, typename... Operands>
+auto power(signal_expression<Op, Operands...>&& e)
+{
+    return impl::make_expression<impl::power_map>(std::move(e));
+}
+
+/*!
+\brief Outputs of spectral_stats()
+
+Every output is optional. Only the outputs that are set are calculated, and each one must be the
+same size as the input.
+*/
+template <typename T>
+struct spectral_outputs
+{
+    /*!
+    \brief Magnitude of each sample
+    */
+    std::optional<signal_view<T>> magnitude;
+
+    /*!
+    \brief Phase angle (in radians) of each sample
+    */
+    std::optional<signal_view<T>> phase;
+
+    /*!
+    \brief Power of each sample
+    */
+    std::optional<signal_view<T>> power;
+
+    /*!
+    \brief Power of each sample in decibels (10 log10 of the power)
+    */
+    std::optional<signal_view<T>> decibels;
+
+    /*!
+    \brief Natural logarithm of the magnitude of each sample
+    */
+    std::optional<signal_view<T>> log_magnitude;
+};
+
+/*!
+\brief Calculates the magnitude, phase, power and logarithms of a complex signal in one pass
+
+The signal is processed a block at a time, and every requested output is calculated from the block
+while it is in the cache, so the signal is read only once however many outputs are written. Nothing
+is allocated. The calculations are written as plain arithmetic (see impl/vector_math.hpp) so that
+they vectorize, unlike std::abs, std::arg and std::log10.
+
+Every finite sample is in the domain:
+
+- The power re^2 + im^2 is the only output that overflows (to infinity) or is subnormal, when the
+  components are above or below about the square roots of the largest and smallest normal values.
+  The magnitude and logarithms of those samples are calculated from the components scaled by a
+  power of 2, so, like std::abs, they are accurate as long as the result itself is in range.
+- The phase treats real/imaginary components close to 0 as 0, the same way as phase().
+- Silent samples are treated as having the magnitude of the smallest subnormal value in the
+  logarithms, so they give a large negative value rather than -infinity.
+- Infinite components give an infinite magnitude, power and logarithms.
+
+With precision::exact the errors are within a few units in the last place, except that close to 0
+dB the decibels and log magnitude inherit the rounding error of the power as an absolute error (as
+std::log10(std::norm(x)) does). With precision::fast the errors are bounded by:
+
+- Magnitude: relative error below 5e-6
+- Phase: absolute error below 1.2e-5 radians
+- Decibels: absolute error below 1e-4 dB
+- Log magnitude: absolute error below 1e-5
+
+\param[in] X - View of the complex samples
+\param[out] y - Views of the outputs to calculate
+\param[in] policy - Precision (precision::exact or precision::fast)
+*/
+template <typename T,
+          typename Precision = precision::exact_t,
+          typename           = std::enable_if_t<impl::is_precision_v<Precision>>>
+void spectral_stats(const signal_view<const std::complex<T>>& X,
+                    const spectral_outputs<T>&                y,
+                    [[maybe_unused]] const Precision&         policy = {})
+{
+    using math = impl::math_policy<Precision>;
+
+    constexpr auto B = impl::spectral_block_size;
+
+    const auto N = X.size();
+
+    assert(!y.magnitude || y.magnitude->size() == N);
+    assert(!y.phase || y.phase->size() == N);
+    assert(!y.power || y.power->size() == N);
+    assert(!y.decibels || y.decibels->size() == N);
+    assert(!y.log_magnitude || y.log_magnitude->size() == N);
+
+    constexpr auto is_float = std::is_same_v<T, float>;
+
+    // The components of samples whose power overflows are scaled by 2^-k_large
+    // (so that two squares of the largest value add up to a finite value), and
+    // those whose power is subnormal by 2^k_small (so that the squares of the
+    // smallest subnormal values are normal)
+    constexpr auto k_large   = is_float ? 66 : 514;
+    constexpr auto k_small   = is_float ? 90 : 600;
+    constexpr auto s_large   = static_cast<T>(is_float ? 0x1p-66 : 0x1p-514);
+    constexpr auto s_small   = static_cast<T>(is_float ? 0x1p90 : 0x1p600);
+    constexpr auto log_large = static_cast<T>(k_large * M_LN2);
+    constexpr auto log_small = static_cast<T>(k_small * M_LN2);
+
+    const auto epsilon = std::numeric_limits<T>::epsilon() * 100;
+    const auto scale   = static_cast<T>(10 / M_LN10);
+
+    const auto largest   = std::numeric_limits<T>::max();
+    const auto smallest  = std::numeric_limits<T>::min();
+    const auto log_floor = 2 * std::log(std::numeric_limits<T>::denorm_min());
+
+    const auto scaled = y.magnitude || y.decibels || y.log_magnitude;
+
+    impl::scratch_frame frame;
+    const auto* const   x = reinterpret_cast<const T*>(impl::contiguous(X, frame));
+
+    alignas(cache_line_size) T re[B];
+    alignas(cache_line_size) T im[B];
+    alignas(cache_line_size) T p[B];
+    alignas(cache_line_size) T p_scaled[B];
+    alignas(cache_line_size) T unscale[B];
+    alignas(cache_line_size) T log_unscale[B];
+    alignas(cache_line_size) T buffer[B];
+    for (size_t n_0 = 0; n_0 < N; n_0 += B)
+    {
+        const auto count = std::min(B, N - n_0);
+
+        for (size_t k = 0; k < count; ++k)
+        {
+            re[k] = x[2 * (n_0 + k)];
+            im[k] = x[2 * (n_0 + k) + 1];
+            p[k]  = re[k] * re[k] + im[k] * im[k];
+        }
+
+        // The power of every sample as p_scaled * unscale^2, with p_scaled
+        // normal unless the power is 0 or the components are infinite
+        for (size_t k = 0; scaled && k < count; ++k)
+        {
+            const auto large = p[k] > largest;
+            const auto small = p[k] < smallest;
+            const auto s     = large ? s_large : (small ? s_small : 1);
+
+            p_scaled[k]    = (re[k] * s) * (re[k] * s) + (im[k] * s) * (im[k] * s);
+            unscale[k]     = large ? 1 / s_large : (small ? 1 / s_small : 1);
+            log_unscale[k] = large ? log_large : (small ? -log_small : 0);
+        }
+
+        // Calculates the logarithm of the power of sample k
+        const auto log_power = [&](const size_t k) {
+            return std::max(math::log(p_scaled[k]) + 2 * log_unscale[k], log_floor);
+        };
+
+        // Writes f(k) for every sample of the block, straight into the output
+        // if it is contiguous
+        const auto write = [&](const std::optional<signal_view<T>>& output, const auto& f) {
+            if (!output)
+            {
+                return;
+            }
+
+            auto* const out = output->contiguous() ? output->data() + n_0 : buffer;
+            for (size_t k = 0; k < count; ++k)
+            {
+                out[k] = f(k);
+            }
+
+            if (out == buffer)
+            {
+                std::copy(buffer, buffer + count, output->subview(n_0, count).begin());
+            }
+        };
+
+        write(y.magnitude, [&](const size_t k) {
+            return math::sqrt(p_scaled[k]) * unscale[k];
+        });
+
+        write(y.phase, [&](const size_t k) {
+            const auto real      = std::abs(re[k]) < epsilon ? 0 : re[k];
+            const auto imaginary = std::abs(im[k]) < epsilon ? 0 : im[k];
+
+            return math::atan2(imaginary, real);
+        });
+
+        write(y.power, [&](const size_t k) {
+            return p[k];
+        });
+
+        write(y.decibels, [&](const size_t k) {
+            return scale * log_power(k);
+        });
+
+        write(y.log_magnitude, [&](const size_t k) {
+            return log_power(k) / 2;
+        });
+    }
+}
+
+/*!
+\brief Calculates the magnitude, phase, power and logarithms of a complex signal in one pass
+\param[in] X - Complex signal
+\param[out] y - Views of the outputs to calculate
+\param[in] policy - Precision (precision::exact or precision::fast)
+*/
+template <typename T,
+          typename Allocator,
+          typename Precision = precision::exact_t,
+          typename           = std::enable_if_t<impl::is_precision_v<Precision>>>
+void spectral_stats(const signal<std::complex<T>, Allocator>& X,
+                    const spectral_outputs<T>&                y,
+                    const Precision&                          policy = {})
+{
+    spectral_stats(X.view(), y, policy);
+}
+
+/*!
+\brief Calculates the magnitude, phase, power and logarithms of a view of mutable samples
+\param[in] X - View of the complex samples
+\param[out] y - Views of the outputs to calculate
+\param[in] policy - Precision (precision::exact or precision::fast)
+*/
+template <typename T,
+          typename Precision = precision::exact_t,
+          typename           = std::enable_if_t<!std::is_const_v<T> &&
+                                      impl::is_precision_v<Precision>>>
+void spectral_stats(const signal_view<T>&                         X,
+                    const spectral_outputs<impl::real_type_t<T>>& y,
+                    const Precision&                              policy = {})
+{
+    spectral_stats(signal_view<const T>(X), y, policy);
+}
+
+/*!
+\brief Calculates the magnitude and phase of a complex signal in one pass (see spectral_stats())
+\param[in] X - View of the complex samples
+\param[out] X_magnitude - View of the magnitudes to write
+\param[out] X_phase - View of the phase angles (in radians) to write
+\param[in] policy - Precision (precision::exact or precision::fast)
+*/
+template <typename T,
+          typename Precision = precision::exact_t,
+          typename           = std::enable_if_t<impl::is_precision_v<Precision>>>
+void to_polar(const signal_view<const std::complex<T>>& X,
+              const signal_view<T>&                     X_magnitude,
+              const signal_view<T>&                     X_phase,
+              const Precision&                          policy = {})
+{
+    spectral_outputs<T> y;
+    y.magnitude = X_magnitude;
+    y.phase     = X_phase;
+
+    spectral_stats(X, y, policy);
+}
+
+/*!
+\brief Calculates the magnitude and phase of a complex signal in one pass (see spectral_stats())
+\param[in] X - Complex signal
+\param[out] X_magnitude - View of the magnitudes to write
+\param[out] X_phase - View of the phase angles (in radians) to write
+\param[in] policy - Precision (precision::exact or precision::fast)
+*/
+template <typename T,
+          typename Allocator,
+          typename Precision = precision::exact_t,
+          typename           = std::enable_if_t<impl::is_precision_v<Precision>>>
+void to_polar(const signal<std::complex<T>, Allocator>& X,
+              const signal_view<T>&                     X_magnitude,
+              const signal_view<T>&                     X_phase,
+              const Precision&                          policy = {})
+{
+    to_polar(X.view(), X_magnitude, X_phase, policy);
+}
+
+/*!
+\brief Calculates the magnitude spectrum of a complex signal with the given precision
+
+Unlike magnitude(x), the magnitudes are calculated in vectorized loops (see spectral_stats() for
+the accuracy of each precision).
+
+\param[in] x - View of the complex samples
+\param[in] policy - Precision (precision::exact or precision::fast)
+\return Magnitude of the signal
+*/
+template <typename T,
+          typename Precision,
+          typename = std::enable_if_t<impl::is_precision_v<Precision>>>
+signal<T> magnitude(const signal_view<const std::complex<T>>& x, const Precision& policy)
+{
+    signal<T> x_magnitude(x.sample_rate(), x.size(), uninitialized);
+
+    spectral_outputs<T> y;
+    y.magnitude = x_magnitude.view();
+    spectral_stats(x, y, policy);
+
+    return x_magnitude;
+}
+
+/*!
+\brief Calculates the magnitude spectrum of a complex signal with the given precision
+\param[in] x - Complex signal
+\param[in] policy - Precision (precision::exact or precision::fast)
+\return Magnitude of the signal
+*/
+template <typename T,
+          typename Allocator,
+          typename Precision,
+          typename = std::enable_if_t<impl::is_precision_v<Precision>>>
+signal<T> magnitude(const signal<std::complex<T>, Allocator>& x, const Precision& policy)
+{
+    return magnitude(x.view(), policy);
+}
+
+/*!
+\brief Calculates the magnitude spectrum of a view of mutable samples with the given precision
+\param[in] x - View of the complex samples
+\param[in] policy - Precision (precision::exact or precision::fast)
+\return Magnitude of the signal
+*/
+template <typename T,
+          typename Precision,
+          typename = std::enable_if_t<!std::is_const_v<T> && impl::is_precision_v<Precision>>>
+auto magnitude(const signal_view<T>& x, const Precision& policy)
+{
+    return magnitude(signal_view<const T>(x), policy);
+}
+
+/*!
+\brief Calculates the phase spectrum (in radians) of a complex signal with the given precision
+
+Unlike phase(x), the phase angles are calculated in vectorized loops (see spectral_stats() for the
+accuracy of each precision).
+
+\param[in] x - View of the complex samples
+\param[in] policy - Precision (precision::exact or precision::fast)
+\return Phase spectrum (in radians) of the signal
+*/
+template <typename T,
+          typename Precision,
+          typename = std::enable_if_t<impl::is_precision_v<Precision>>>
+signal<T> phase(const signal_view<const std::complex<T>>& x, const Precision& policy)
+{
+    signal<T> x_phase(x.sample_rate(), x.size(), uninitialized);
+
+    spectral_outputs<T> y;
+    y.phase = x_phase.view();
+    spectral_stats(x, y, policy);
+
+    return x_phase;
+}
+
+/*!
+\brief Calculates the phase spectrum (in radians) of a complex signal with the given precision
+\param[in] x - Complex signal
+\param[in] policy - Precision (precision::exact or precision::fast)
+\return Phase spectrum (in radians) of the signal
+*/
+template <typename T,
+          typename Allocator,
+          typename Precision,
+          typename = std::enable_if_t<impl::is_precision_v<Precision>>>
+signal<T> phase(const signal<std::complex<T>, Allocator>& x, const Precision& policy)
+{
+    return phase(x.view(), policy);
+}
+
+/*!
+\brief Calculates the phase spectrum (in radians) of a view of mutable samples with the given
+precision
+\param[in] x - View of the complex samples
+\param[in] policy - Precision (precision::exact or precision::fast)
+\return Phase spectrum (in radians) of the signal
+*/
+template <typename T,
+          typename Precision,
+          typename = std::enable_if_t<!std::is_const_v<T> && impl::is_precision_v<Precision>>>
+auto phase(const signal_view<T>& x, const Precision& policy)
+{
+    return phase(signal_view<const T>(x), policy);
+}
+
+/*!
+\brief Calculates the natural logarithm of the magnitude spectrum of a complex signal
+
+Silent bins give a large negative value rather than -infinity. See spectral_stats() for the domain
+and accuracy of each precision.
+
+\param[in] x - View of the complex samples
+\param[in] policy - Precision (precision::exact or precision::fast)
+\return Log magnitude of the signal
+*/
+template <typename T,
+          typename Precision = precision::exact_t,
+          typename           = std::enable_if_t<impl::is_precision_v<Precision>>>
+signal<T> log_magnitude(const signal_view<const std::complex<T>>& x, const Precision& policy = {})
+{
+    signal<T> x_log_magnitude(x.sample_rate(), x.size(), uninitialized);
+
+    spectral_outputs<T> y;
+    y.log_magnitude = x_log_magnitude.view();
+    spectral_stats(x, y, policy);
+
+    return x_log_magnitude;
+}
+
+/*!
+\brief Calculates the natural logarithm of the magnitude spectrum of a complex signal
+\param[in] x - Complex signal
+\param[in] policy - Precision (precision::exact or precision::fast)
+\return Log magnitude of the signal
+*/
+template <typename T,
+          typename Allocator,
+          typename Precision = precision::exact_t,
+          typename           = std::enable_if_t<impl::is_precision_v<Precision>>>
+signal<T> log_magnitude(const signal<std::complex<T>, Allocator>& x, const Precision& policy = {})
+{
+    return log_magnitude(x.view(), policy);
+}
+
+/*!
+\brief Calculates the natural logarithm of the magnitude spectrum of a view of mutable samples
+\param[in] x - View of the complex samples
+\param[in] policy - Precision (precision::exact or precision::fast)
+\return Log magnitude of the signal
+*/
+template <typename T,
+          typename Precision = precision::exact_t,
+          typename = std::enable_if_t<!std::is_const_v<T> && impl::is_precision_v<Precision>>>
+auto log_magnitude(const signal_view<T>& x, const Precision& policy = {})
+{
+    return log_magnitude(signal_view<const T>(x), policy);
+}
+
+/*!
+\brief Converts a power spectrum to decibels (10 log10 of each power)
+
+Powers of 0 are treated as the smallest subnormal value, so silent bins give a large negative value
+rather than -infinity, and infinite powers give infinity. With precision::exact the results are
+within a few units in the last place (except close to 0 dB, see spectral_stats()), with
+precision::fast the absolute error is below 1e-4 dB.
+
+\param[in] x_power - View of the powers
+\param[in] policy - Precision (precision::exact or precision::fast)
+\return Power spectrum in decibels
+*/
+template <typename T,
+          typename Precision = precision::exact_t,
+          typename           = std::enable_if_t<!impl::is_complex_v<T> &&
+                                      impl::is_precision_v<Precision>>>
+signal<T> decibels(const signal_view<const T>&       x_power,
+                   [[maybe_unused]] const Precision& policy = {})
+{
+    using math = impl::math_policy<Precision>;
+
+    const auto floor = std::numeric_limits<T>::denorm_min();
+    const auto scale = static_cast<T>(10 / M_LN10);
+
+    impl::scratch_frame frame;
+    const auto* const   p = impl::contiguous(x_power, frame);
+
+    signal<T>   x_db(x_power.sample_rate(), x_power.size(), uninitialized);
+    auto* const y = x_db.data();
+    for (size_t n = 0; n < x_power.size(); ++n)
+    {
+        y[n] = scale * math::log(std::max(p[n], floor));
+    }
+
+    return x_db;
+}
+
+/*!
+\brief Converts a power spectrum to decibels (10 log10 of each power)
+\param[in] x_power - Powers
+\param[in] policy - Precision (precision::exact or precision::fast)
+\return Power spectrum in decibels
+*/
+template <typename T,
+          typename Allocator,
+          typename Precision = precision::exact_t,
+          typename           = std::enable_if_t<!impl::is_complex_v<T> &&
+                                      impl::is_precision_v<Precision>>>
+signal<T> decibels(const signal<T, Allocator>& x_power, const Precision& policy = {})
+{
+    return decibels(x_power.view(), policy);
+}
+
+/*!
+\brief Converts a view of mutable powers to decibels (10 log10 of each power)
+\param[in] x_power - View of the powers
+\param[in] policy - Precision (precision::exact or precision::fast)
+\return Power spectrum in decibels
+*/
+template <typename T,
+          typename Precision = precision::exact_t,
+          typename = std::enable_if_t<!std::is_const_v<T> && impl::is_precision_v<Precision>>>
+auto decibels(const signal_view<T>& x_power, const Precision& policy = {})
+{
+    return decibels(signal_view<const T>(x_power), policy);
 }
 
 }  // namespace tnt::dsp
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "multisignal.hpp"
+#include "signal.hpp"
+#include "signal_view.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace tnt::dsp
+{
+
+/*!
+\brief Calls a function on every channel of a multi-channel signal in parallel
+
+Each call gets a view of its own channel, so the channels can be modified in place without any
+locking. The calls may run in any order and at the same time.
+
+\param[in,out] x Multi-channel signal
+\param[in] f Function taking a view of a channel
+\param[in] pool Pool that runs the calls
+*/
+template <typename T, typename Allocator, typename Function>
+void for_each_channel(multisignal<T, Allocator>& x,
+                      const Function&            f,
+                      thread_pool&               pool = default_thread_pool())
+{
+    pool.parallel_for(x.channels(), [&](const size_t c) {
+        f(x.channel_view(c));
+    });
+}
+
+/*!
+\brief Calls a function on every channel of a multi-channel signal in parallel
+
+The calls may run in any order and at the same time.
+
+\param[in] x Multi-channel signal
+\param[in] f Function taking a view of a channel
+\param[in] pool Pool that runs the calls
+*/
+template <typename T, typename Allocator, typename Function>
+void for_each_channel(const multisignal<T, Allocator>& x,
+                      const Function&                  f,
+                      thread_pool&                     pool = default_thread_pool())
+{
+    pool.parallel_for(x.channels(), [&](const size_t c) {
+        f(x.channel_view(c));
+    });
+}
+
+/*!
+\brief Transforms every channel of a multi-channel signal in parallel
+
+The function maps a view of an input channel to an output signal (for example a spectrum or an
+envelope), and the outputs become the channels of the result. Every output must have the same
+sample rate and size. Plans and temporaries are kept per thread, so the transforms run without
+sharing anything, and each output channel is written by one thread only.
+
+\param[in] x Multi-channel signal
+\param[in] f Function taking a view of a channel and returning a signal
+\param[in] pool Pool that runs the calls
+\return Multi-channel signal containing the output of each channel
+*/
+template <typename T, typename Allocator, typename Function>
+auto transform_channels(const multisignal<T, Allocator>& x,
+                        const Function&                  f,
+                        thread_pool&                     pool = default_thread_pool())
+{
+    using result_type = std::invoke_result_t<const Function&, signal_view<const T>>;
+    using value_type  = typename result_type::value_type;
+
+    const auto channels = x.channels();
+    if (channels == 0)
+    {
+        return multisignal<value_type>(x.sample_rate());
+    }
+
+    std::vector<std::optional<result_type>> results(channels);
+    pool.parallel_for(channels, [&](const size_t c) {
+        results[c].emplace(f(x.channel_view(c)));
+    });
+
+    // The outputs are gathered into a single allocation, each one by the
+    // thread that copies it
+    const auto& first = *results.front();
+
+    multisignal<value_type> y(first.sample_rate(), first.size(), channels, uninitialized);
+    pool.parallel_for(channels, [&](const size_t c) {
+        assert(results[c]->sample_rate() == y.sample_rate());
+        assert(results[c]->size() == y.size());
+
+        std::copy(results[c]->begin(), results[c]->end(), y.channel_view(c).begin());
+    });
+
+    return y;
+}
+
+}  // namespace tnt::dsp
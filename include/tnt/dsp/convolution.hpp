@@ -1,124 +1,428 @@
 #pragma once
 
 #include "fourier_transform.hpp"
+#include "impl/direct_convolution.hpp"
+#include "signal.hpp"
+#include "signal_view.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <complex>
 #include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
 
 namespace tnt::dsp
 {
 
-/*!
- \brief Calculates the convolution of two real input signals
- \param[in] a - Real input signal
- \param[in] b - Real input signal
- \return Signal representing \a a * \a b
- */
+namespace impl
+{
+
+// Calculates the circular convolution of two real signals in the frequency domain
 template <typename T>
-signal<T> convolve(const signal<T>& a, const signal<T>& b)
+signal<T> fft_convolve(const signal_view<const T>& a, const signal_view<const T>& b)
 {
     assert(a.sample_rate() == b.sample_rate());
     assert(a.size() == b.size());
 
-    const auto f_s = a.sample_rate();
-    const auto N   = a.size();
+    const auto  f_s  = a.sample_rate();
+    const auto  N    = a.size();
+    const auto  plan = impl::get_fft_plan<T>(N);
+
+    // Pack both real signals into one complex sequence so that a single
+    // complex FFT transforms both of them: Z[n] = a[n] + jb[n]
+    scratch_frame frame;
+    auto* const   Z = frame.allocate<std::complex<T>>(N);
+    for (size_t n = 0; n < N; ++n)
+    {
+        Z[n] = {a[n], b[n]};
+    }
 
-    // TODO: Cache FFT twiddle factors so they aren't calculated twice
-    const auto A = fourier_transform(a);
-    const auto B = fourier_transform(b);
+    impl::fft(Z, Z, *plan);
 
     // The convolution theorem states that multiplication in the frequency
-    // domain is equivalent to convolution in the time domain
-    signal<std::complex<T>> C(f_s, N);
-    std::transform(A.begin(), A.end(), B.begin(), C.begin(), std::multiplies<std::complex<T>>());
+    // domain is equivalent to convolution in the time domain. With
+    // A[m] = (Z[m] + Z*[N-m]) / 2 and B[m] = (Z[m] - Z*[N-m]) / 2j the product
+    // is C[m] = (Z[m]^2 - Z*[N-m]^2) / 4j. Bins m and N-m depend on each
+    // other, so they are replaced in pairs.
+    const auto product = [](const auto& Z_m, const auto& Z_N_minus_m) {
+        const auto Z_conj_N_minus_m = std::conj(Z_N_minus_m);
+        return (Z_m * Z_m - Z_conj_N_minus_m * Z_conj_N_minus_m) * std::complex<T>(0, -0.25);
+    };
+
+    for (size_t m = 0; m < N && m <= N - m; ++m)
+    {
+        const auto N_minus_m = (N - m) % N;
+
+        const auto Z_m         = Z[m];
+        const auto Z_N_minus_m = Z[N_minus_m];
+
+        Z[m]         = product(Z_m, Z_N_minus_m);
+        Z[N_minus_m] = product(Z_N_minus_m, Z_m);
+    }
 
-    const auto c = inverse_fourier_transform(C);
+    impl::inverse_fft(Z, Z, *plan);
 
     // Strip off the complex portion of the result since we are dealing
     // with only real input signals
-    signal<T> x(f_s, N);
-    std::transform(c.begin(), c.end(), x.begin(), [](const auto& sample) {
+    signal<T> c(f_s, N, uninitialized);
+    std::transform(Z, Z + N, c.begin(), [](const auto& sample) {
         return sample.real();
     });
 
-    return x;
+    return c;
+}
+
+// Calculates the circular convolution of two signals in the frequency domain
+// where at least one of the signals is complex
+//
+// Real signals are transformed with a real FFT directly, so they never have
+// to be copied into a complex signal first.
+template <typename T, typename A, typename B>
+signal<std::complex<T>> fft_convolve_complex(const signal_view<const A>& a,
+                                             const signal_view<const B>& b)
+{
+    assert(a.sample_rate() == b.sample_rate());
+    assert(a.size() == b.size());
+
+    const auto  f_s  = a.sample_rate();
+    const auto  N    = a.size();
+    const auto  plan = impl::get_fft_plan<T>(N);
+
+    const auto transform = [&](const auto* x, std::complex<T>* X) {
+        if constexpr (impl::is_complex_v<std::remove_pointer_t<decltype(x)>>)
+        {
+            impl::fft(x, X, *plan);
+        }
+        else
+        {
+            impl::real_fft(x, X, *plan);
+        }
+    };
+
+    scratch_frame frame;
+
+    // Both transforms share the same plan, and the result is calculated in
+    // place in the output signal
+    signal<std::complex<T>> c(f_s, N, uninitialized);
+    auto* const             B_p = frame.allocate<std::complex<T>>(N);
+    transform(impl::contiguous(a, frame), c.data());
+    transform(impl::contiguous(b, frame), B_p);
+
+    // The convolution theorem states that multiplication in the frequency
+    // domain is equivalent to convolution in the time domain
+    std::transform(c.begin(), c.end(), B_p, c.begin(), std::multiplies<std::complex<T>>());
+
+    impl::inverse_fft(c.data(), c.data(), *plan);
+
+    return c;
 }
 
+// Marks a crossover that has not been measured yet
+constexpr size_t unmeasured_crossover = std::numeric_limits<size_t>::max();
+
+// Number of complex operands of a convolution of A and B. The direct
+// convolution costs about 2 and 4 times as much per tap with one and two
+// complex operands, so each number has its own crossover.
+template <typename A, typename B>
+constexpr int complex_operands = int{is_complex_v<A>} + int{is_complex_v<B>};
+
+// Measures the kernel length at which direct convolution becomes slower than
+// FFT convolution on the current machine, for convolutions of real signals
+// with the given number of complex operands
+template <typename T, int ComplexOperands>
+size_t measure_convolution_crossover()
+{
+    using clock = std::chrono::steady_clock;
+
+    using A = std::conditional_t<ComplexOperands == 2, std::complex<T>, T>;
+    using B = std::conditional_t<ComplexOperands >= 1, std::complex<T>, T>;
+    using R = std::conditional_t<ComplexOperands >= 1, std::complex<T>, T>;
+
+    // Representative signal size and kernel length to time
+    constexpr size_t N      = 1024;
+    constexpr size_t K      = 32;
+    constexpr size_t trials = 5;
+
+    signal<A> a(1, N);
+    signal<B> b(1, N);
+    for (size_t n = 0; n < N; ++n)
+    {
+        a[n] = static_cast<T>(1) / static_cast<T>(n + 1);
+    }
+    for (size_t k = 0; k < K; ++k)
+    {
+        b[k] = static_cast<T>(1) / static_cast<T>(k + 1);
+    }
+
+    const auto a_view = std::as_const(a).view();
+    const auto b_view = std::as_const(b).view();
+
+    const auto fft_convolve = [&] {
+        if constexpr (ComplexOperands == 0)
+        {
+            return impl::fft_convolve(a_view, b_view);
+        }
+        else
+        {
+            return impl::fft_convolve_complex<T>(a_view, b_view);
+        }
+    };
+
+    // Take the fastest of several trials to filter out scheduling noise
+    auto fft_time    = clock::duration::max();
+    auto direct_time = clock::duration::max();
+    auto checksum    = R{};
+    for (size_t trial = 0; trial < trials; ++trial)
+    {
+        const auto start = clock::now();
+        checksum += fft_convolve()[0];
+        const auto middle = clock::now();
+        checksum += impl::direct_convolve<R>(a_view, N, b_view, K)[0];
+        const auto stop = clock::now();
+
+        fft_time    = std::min(fft_time, middle - start);
+        direct_time = std::min(direct_time, stop - middle);
+    }
+
+    // Keep the work from being optimized away
+    volatile auto sink = std::real(checksum);
+    static_cast<void>(sink);
+
+    if (direct_time.count() <= 0)
+    {
+        return N;
+    }
+
+    // Direct convolution scales linearly with the kernel length
+    const auto taps = K * static_cast<double>(fft_time.count()) / direct_time.count();
+
+    return std::clamp(static_cast<size_t>(taps), size_t{1}, N);
+}
+
+template <typename T, int ComplexOperands>
+std::atomic<size_t>& convolution_crossover()
+{
+    static std::atomic<size_t> crossover(unmeasured_crossover);
+    return crossover;
+}
+
+}  // namespace impl
+
 /*!
- \brief Calculates the convolution of a real, and a complex input signal
- \param[in] a - Real input signal
- \param[in] b - Complex input signal
+\brief Gets the kernel length at or below which convolution is done directly in the time domain
+
+Each combination of real and complex operands has its own crossover, since the direct convolution
+costs about 2 and 4 times as much per tap with one and two complex operands as it does with real
+ones. The template arguments are the sample types of the operands, in either order.
+
+The crossover is measured on the current machine the first time it is needed, unless it has already
+been set with set_convolution_crossover(). Measuring times five FFT convolutions and five direct
+convolutions of 1024 samples, once per process for each combination of sample types, so the first
+convolve() call takes that much longer. Applications that cannot afford that on their first call
+should call convolution_crossover() during initialization, or set the crossover.
+
+\return Crossover kernel length (in samples)
+*/
+template <typename A, typename B = A>
+size_t convolution_crossover()
+{
+    using T = impl::real_type_t<A>;
+
+    static_assert(std::is_same_v<T, impl::real_type_t<B>>);
+
+    constexpr auto complex_operands = impl::complex_operands<A, B>;
+
+    auto& crossover = impl::convolution_crossover<T, complex_operands>();
+
+    auto taps = crossover.load(std::memory_order_relaxed);
+    if (taps == impl::unmeasured_crossover)
+    {
+        // If another thread finishes measuring first its result is kept
+        const auto measured = impl::measure_convolution_crossover<T, complex_operands>();
+        crossover.compare_exchange_strong(taps, measured, std::memory_order_relaxed);
+        taps = crossover.load(std::memory_order_relaxed);
+    }
+
+    return taps;
+}
+
+/*!
+\brief Overrides the kernel length at or below which convolution is done directly in the time domain
+
+Setting a crossover of 0 always uses the FFT, and setting a crossover equal to the signal size
+always convolves directly. Only the crossover of the given combination of sample types is set.
+
+\param[in] taps Crossover kernel length (in samples)
+*/
+template <typename A, typename B = A>
+void set_convolution_crossover(const size_t taps)
+{
+    using T = impl::real_type_t<A>;
+
+    static_assert(std::is_same_v<T, impl::real_type_t<B>>);
+
+    auto& crossover = impl::convolution_crossover<T, impl::complex_operands<A, B>>();
+    crossover.store(taps, std::memory_order_relaxed);
+}
+
+/*!
+ \brief Calculates the convolution of two real input signals
+
+ If either signal has fewer non-zero samples than convolution_crossover() the convolution is done
+ directly in the time domain, otherwise it is done in the frequency domain. The first call measures
+ the crossover unless it has been set (see convolution_crossover()).
+
+ \param[in] a - View of the real input samples
+ \param[in] b - View of the real input samples
  \return Signal representing \a a * \a b
  */
 template <typename T>
-signal<std::complex<T>> convolve(const signal<T>& a, const signal<std::complex<T>>& b)
+signal<T> convolve(const signal_view<const T>& a, const signal_view<const T>& b)
 {
     assert(a.sample_rate() == b.sample_rate());
     assert(a.size() == b.size());
 
-    const auto f_s = a.sample_rate();
-    const auto N   = a.size();
-
-    // Convert "a" into a complex signal
-    signal<std::complex<T>> a_p(f_s, N);
-    std::transform(a.begin(), a.end(), a_p.begin(), [](const auto& sample) {
-        return std::complex<T>(sample);
-    });
+    const auto K_a = impl::support(a);
+    const auto K_b = impl::support(b);
+    if (std::min(K_a, K_b) <= convolution_crossover<T>())
+    {
+        return impl::direct_convolve<T>(a, K_a, b, K_b);
+    }
 
-    return convolve(a_p, b);
+    return impl::fft_convolve(a, b);
 }
 
 /*!
- \brief Calculates the convolution of a complex, and a real input signal
- \param[in] a - Complex input signal
- \param[in] b - Real input signal
+ \brief Calculates the convolution of a real, and a complex input signal
+ \param[in] a - View of the real input samples
+ \param[in] b - View of the complex input samples
  \return Signal representing \a a * \a b
  */
 template <typename T>
-signal<std::complex<T>> convolve(const signal<std::complex<T>>& a, const signal<T>& b)
+signal<std::complex<T>> convolve(const signal_view<const T>&               a,
+                                 const signal_view<const std::complex<T>>& b)
 {
     assert(a.sample_rate() == b.sample_rate());
     assert(a.size() == b.size());
 
-    const auto f_s = a.sample_rate();
-    const auto N   = a.size();
+    const auto K_a = impl::support(a);
+    const auto K_b = impl::support(b);
+    if (std::min(K_a, K_b) <= convolution_crossover<T, std::complex<T>>())
+    {
+        return impl::direct_convolve<std::complex<T>>(a, K_a, b, K_b);
+    }
 
-    // Convert "b" into a complex signal
-    signal<std::complex<T>> b_p(f_s, N);
-    std::transform(b.begin(), b.end(), b_p.begin(), [](const auto& sample) {
-        return std::complex<T>(sample);
-    });
+    return impl::fft_convolve_complex<T>(a, b);
+}
 
-    return convolve(a, b_p);
+/*!
+ \brief Calculates the convolution of a complex, and a real input signal
+ \param[in] a - View of the complex input samples
+ \param[in] b - View of the real input samples
+ \return Signal representing \a a * \a b
+ */
+template <typename T>
+signal<std::complex<T>> convolve(const signal_view<const std::complex<T>>& a,
+                                 const signal_view<const T>&               b)
+{
+    return convolve(b, a);
 }
 
 /**
  \brief Calculates the convolution of two complex input signals
- \param[in] a - Complex input signal
- \param[in] b - Complex input signal
+ \param[in] a - View of the complex input samples
+ \param[in] b - View of the complex input samples
  \return Signal representing \a a * \a b
  */
 template <typename T>
-signal<std::complex<T>> convolve(const signal<std::complex<T>>& a, const signal<std::complex<T>>& b)
+signal<std::complex<T>> convolve(const signal_view<const std::complex<T>>& a,
+                                 const signal_view<const std::complex<T>>& b)
 {
     assert(a.sample_rate() == b.sample_rate());
     assert(a.size() == b.size());
 
-    const auto f_s = a.sample_rate();
-    const auto N   = a.size();
+    const auto K_a = impl::support(a);
+    const auto K_b = impl::support(b);
+    if (std::min(K_a, K_b) <= convolution_crossover<std::complex<T>>())
+    {
+        return impl::direct_convolve<std::complex<T>>(a, K_a, b, K_b);
+    }
 
-    // TODO: Cache FFT twiddle factors so they aren't calculated twice
-    const auto A = fourier_transform(a);
-    const auto B = fourier_transform(b);
+    return impl::fft_convolve_complex<T>(a, b);
+}
 
-    // The convolution theorem states that multiplication in the frequency
-    // domain is equivalent to convolution in the time domain
-    signal<std::complex<T>> C(f_s, N);
-    std::transform(A.begin(), A.end(), B.begin(), C.begin(), std::multiplies<std::complex<T>>());
+/*!
+ \brief Calculates the convolution of two real input signals
+ \param[in] a - Real input signal
+ \param[in] b - Real input signal
+ \return Signal representing \a a * \a b
+ */
+template <typename T, typename A, typename B>
+signal<T> convolve(const signal<T, A>& a, const signal<T, B>& b)
+{
+    return convolve(a.view(), b.view());
+}
 
-    return inverse_fourier_transform(C);
+/*!
+ \brief Calculates the convolution of a real, and a complex input signal
+ \param[in] a - Real input signal
+ \param[in] b - Complex input signal
+ \return Signal representing \a a * \a b
+ */
+template <typename T, typename A, typename B>
+signal<std::complex<T>> convolve(const signal<T, A>& a, const signal<std::complex<T>, B>& b)
+{
+    return convolve(a.view(), b.view());
+}
+
+/*!
+ \brief Calculates the convolution of a complex, and a real input signal
+ \param[in] a - Complex input signal
+ \param[in] b - Real input signal
+ \return Signal representing \a a * \a b
+ */
+template <typename T, typename A, typename B>
+signal<std::complex<T>> convolve(const signal<std::complex<T>, A>& a, const signal<T, B>& b)
+{
+    return convolve(a.view(), b.view());
+}
+
+/**
+ \brief Calculates the convolution of two complex input signals
+ \param[in] a - Complex input signal
+ \param[in] b - Complex input signal
+ \return Signal representing \a a * \a b
+ */
+template <typename T, typename A, typename B>
+signal<std::complex<T>> convolve(const signal<std::complex<T>, A>& a,
+                                 const signal<std::complex<T>, B>& b)
+{
+    return convolve(a.view(), b.view());
+}
+
+/*!
+ \brief Calculates the convolution of two signals where at least one is an expression
+
+ Expressions are evaluated into temporaries drawn from the workspace rather than into signals, so
+ e.g. a lazily generated carrier can be convolved without allocating it.
+
+ \param[in] a - Signal, view or expression
+ \param[in] b - Signal, view or expression
+ \return Signal representing \a a * \a b
+ */
+template <typename A,
+          typename B,
+          typename = std::enable_if_t<impl::is_signal_like_v<A> && impl::is_signal_like_v<B> &&
+                                      (impl::is_signal_expression<A>::value ||
+                                       impl::is_signal_expression<B>::value)>>
+auto convolve(const A& a, const B& b)
+{
+    impl::scratch_frame frame;
+    return convolve(impl::const_view(a, frame), impl::const_view(b, frame));
 }
 
 }  // namespace tnt::dsp
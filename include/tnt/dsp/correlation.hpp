@@ -0,0 +1,382 @@
+#pragma once
+
+#include "fourier_transform.hpp"
+#include "impl/type_traits.hpp"
+#include "impl/vector_operations.hpp"
+#include "signal.hpp"
+#include "signal_view.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+
+namespace tnt::dsp
+{
+
+namespace impl
+{
+
+// Whether a range of lags of a correlation of size N is cheaper to calculate
+// directly, at N vectorized multiply-adds per lag, than from the full
+// correlation, at three FFTs and the allocations they need. Measured, the
+// direct calculation is faster up to 30 log2(N) lags or more, so this leaves
+// a margin.
+inline bool prefer_direct_lags(const size_t N, const size_t lags)
+{
+    return lags <= N && lags <= 16 * static_cast<size_t>(std::log2(static_cast<double>(N)));
+}
+
+// Calculates a (circular) range of at most N lags of the correlation of a and
+// b directly. Each sample of b scales the lags it contributes to, which are a
+// contiguous run of a (split in two where it wraps around), so the inner
+// loops are the same vectorized loops as direct convolution.
+template <typename T>
+signal<T> direct_lag_range(const signal_view<const T>& a,
+                           const signal_view<const T>& b,
+                           const size_t                first_lag,
+                           const size_t                lags)
+{
+    const auto N = a.size();
+
+    assert(lags <= N);
+
+    scratch_frame     frame;
+    const auto* const a_p = impl::contiguous(a, frame);
+    const auto* const b_p = impl::contiguous(b, frame);
+
+    signal<T>   r(a.sample_rate(), lags);
+    auto* const r_p = r.data();
+
+    // r[l] += a[n + first_lag + l] * conj(b[n]) for 0 <= l < lags
+    auto i = first_lag % N;
+    for (size_t n = 0; n < N; ++n)
+    {
+        T b_n = b_p[n];
+        if constexpr (is_complex_v<T>)
+        {
+            b_n = std::conj(b_n);
+        }
+
+        const auto count = std::min(lags, N - i);
+
+        multiply_accumulate(r_p, a_p + i, b_n, count);
+        multiply_accumulate(r_p + count, a_p, b_n, lags - count);
+
+        i = i + 1 < N ? i + 1 : 0;
+    }
+
+    return r;
+}
+
+// Copies a (circular) range of lags out of a full correlation
+template <typename T>
+signal<T> lag_range(const signal<T>& r, const size_t first_lag, const size_t lags)
+{
+    const auto N = r.size();
+
+    assert(N > 0 || lags == 0);
+
+    signal<T> r_p(r.sample_rate(), lags, uninitialized);
+    for (size_t l = 0; l < lags; ++l)
+    {
+        r_p[l] = r[(first_lag + l) % N];
+    }
+
+    return r_p;
+}
+
+// Calculates the real sequence whose spectrum is the real, even sequence P
+// using a forward real FFT in place of an inverse complex FFT. Because P is
+// real and even its transform is real, so only the real part is kept.
+template <typename T>
+signal<T> inverse_even_fourier_transform(const signal<T>& P)
+{
+    const auto N = P.size();
+
+    const auto r_p = fourier_transform(P);
+
+    signal<T> r(P.sample_rate(), N, uninitialized);
+    std::transform(r_p.begin(), r_p.end(), r.begin(), [=](const auto& sample) {
+        return sample.real() / static_cast<T>(N);
+    });
+
+    return r;
+}
+
+}  // namespace impl
+
+/*!
+\brief Calculates the circular cross-correlation of two real signals
+
+The cross-correlation is defined as r[l] = sum(a[n + l] * b[n]) so a peak at lag l means that \a a
+lags \a b by l samples. Negative lags wrap around to the end of the result.
+
+\param[in] a - View of the real input samples
+\param[in] b - View of the real input samples
+\return Signal containing the cross-correlation at each lag
+*/
+template <typename T>
+signal<T> cross_correlate(const signal_view<const T>& a, const signal_view<const T>& b)
+{
+    assert(a.sample_rate() == b.sample_rate());
+    assert(a.size() == b.size());
+
+    const auto f_s = a.sample_rate();
+    const auto N   = a.size();
+
+    // Both real signals are transformed with a single complex FFT
+    const auto [A, B] = fourier_transform(a, b);
+
+    // Correlation is convolution with a time-reversed signal, which is
+    // multiplication by the complex conjugate in the frequency domain
+    signal<std::complex<T>> R(f_s, N, uninitialized);
+    std::transform(A.begin(), A.end(), B.begin(), R.begin(), [](const auto& A_m, const auto& B_m) {
+        return A_m * std::conj(B_m);
+    });
+
+    const auto r_c = inverse_fourier_transform(std::move(R));
+
+    // Strip off the complex portion of the result since we are dealing
+    // with only real input signals
+    signal<T> r(f_s, N, uninitialized);
+    std::transform(r_c.begin(), r_c.end(), r.begin(), [](const auto& sample) {
+        return sample.real();
+    });
+
+    return r;
+}
+
+/*!
+\brief Calculates the circular cross-correlation of two complex signals
+
+The cross-correlation is defined as r[l] = sum(a[n + l] * conj(b[n])) so a peak at lag l means that
+\a a lags \a b by l samples. Negative lags wrap around to the end of the result.
+
+\param[in] a - View of the complex input samples
+\param[in] b - View of the complex input samples
+\return Signal containing the cross-correlation at each lag
+*/
+template <typename T>
+signal<std::complex<T>> cross_correlate(const signal_view<const std::complex<T>>& a,
+                                        const signal_view<const std::complex<T>>& b)
+{
+    assert(a.sample_rate() == b.sample_rate());
+    assert(a.size() == b.size());
+
+    const auto f_s = a.sample_rate();
+    const auto N   = a.size();
+
+    const auto A = fourier_transform(a);
+    const auto B = fourier_transform(b);
+
+    // Correlation is convolution with a time-reversed, conjugated signal,
+    // which is multiplication by the complex conjugate in the frequency domain
+    signal<std::complex<T>> R(f_s, N, uninitialized);
+    std::transform(A.begin(), A.end(), B.begin(), R.begin(), [](const auto& A_m, const auto& B_m) {
+        return A_m * std::conj(B_m);
+    });
+
+    return inverse_fourier_transform(std::move(R));
+}
+
+/*!
+\brief Calculates the circular cross-correlation of two real signals
+\param[in] a - Real input signal
+\param[in] b - Real input signal
+\return Signal containing the cross-correlation at each lag
+*/
+template <typename T, typename A, typename B>
+signal<T> cross_correlate(const signal<T, A>& a, const signal<T, B>& b)
+{
+    return cross_correlate(a.view(), b.view());
+}
+
+/*!
+\brief Calculates the circular cross-correlation of two complex signals
+\param[in] a - Complex input signal
+\param[in] b - Complex input signal
+\return Signal containing the cross-correlation at each lag
+*/
+template <typename T, typename A, typename B>
+signal<std::complex<T>> cross_correlate(const signal<std::complex<T>, A>& a,
+                                        const signal<std::complex<T>, B>& b)
+{
+    return cross_correlate(a.view(), b.view());
+}
+
+/*!
+\brief Calculates a range of lags of the circular cross-correlation of two signals
+
+Lags are taken modulo the signal size, so a range starting at N - L covers the lags -L to -1. Short
+ranges (up to about 16 log2(N) lags) are calculated directly rather than from the full correlation.
+
+\param[in] a - View of the input samples
+\param[in] b - View of the input samples
+\param[in] first_lag First lag to return
+\param[in] lags Number of lags to return
+\return Signal containing the cross-correlation at lags \a first_lag to \a first_lag + \a lags - 1
+*/
+template <typename T>
+signal<T> cross_correlate(const signal_view<const T>& a,
+                          const signal_view<const T>& b,
+                          const size_t                first_lag,
+                          const size_t                lags)
+{
+    assert(a.sample_rate() == b.sample_rate());
+    assert(a.size() == b.size());
+
+    if (lags == 0)
+    {
+        return signal<T>(a.sample_rate());
+    }
+
+    assert(a.size() > 0);
+
+    if (impl::prefer_direct_lags(a.size(), lags))
+    {
+        return impl::direct_lag_range(a, b, first_lag, lags);
+    }
+
+    return impl::lag_range(cross_correlate(a, b), first_lag, lags);
+}
+
+/*!
+\brief Calculates a range of lags of the circular cross-correlation of two signals
+\param[in] a - Input signal
+\param[in] b - Input signal
+\param[in] first_lag First lag to return
+\param[in] lags Number of lags to return
+\return Signal containing the cross-correlation at lags \a first_lag to \a first_lag + \a lags - 1
+*/
+template <typename T, typename A, typename B>
+signal<T> cross_correlate(const signal<T, A>& a,
+                          const signal<T, B>& b,
+                          const size_t        first_lag,
+                          const size_t        lags)
+{
+    return cross_correlate(a.view(), b.view(), first_lag, lags);
+}
+
+/*!
+\brief Calculates the circular autocorrelation of a real signal
+
+The autocorrelation is the inverse transform of the power spectrum. Since the power spectrum of a
+real signal is real and even, both transforms are done with real FFTs.
+
+\param[in] x - View of the real input samples
+\return Signal containing the autocorrelation at each lag
+*/
+template <typename T>
+signal<T> autocorrelate(const signal_view<const T>& x)
+{
+    const auto X = fourier_transform(x);
+
+    // Multiplying a spectrum by its own conjugate gives the power spectrum
+    signal<T> P(x.sample_rate(), x.size(), uninitialized);
+    std::transform(X.begin(), X.end(), P.begin(), [](const auto& sample) {
+        return std::norm(sample);
+    });
+
+    return impl::inverse_even_fourier_transform(P);
+}
+
+/*!
+\brief Calculates the circular autocorrelation of a complex signal
+
+The autocorrelation is the inverse transform of the power spectrum. Since the power spectrum is
+real, the inverse transform is done with a real FFT.
+
+\param[in] x - View of the complex input samples
+\return Signal containing the autocorrelation at each lag
+*/
+template <typename T>
+signal<std::complex<T>> autocorrelate(const signal_view<const std::complex<T>>& x)
+{
+    const auto f_s = x.sample_rate();
+    const auto N   = x.size();
+
+    const auto X = fourier_transform(x);
+
+    // Multiplying a spectrum by its own conjugate gives the power spectrum
+    signal<T> P(f_s, N, uninitialized);
+    std::transform(X.begin(), X.end(), P.begin(), [](const auto& sample) {
+        return std::norm(sample);
+    });
+
+    // For a real spectrum the inverse FFT is the conjugate of the forward FFT
+    const auto r_p = fourier_transform(P);
+
+    signal<std::complex<T>> r(f_s, N, uninitialized);
+    std::transform(r_p.begin(), r_p.end(), r.begin(), [=](const auto& sample) {
+        return std::conj(sample) / static_cast<T>(N);
+    });
+
+    return r;
+}
+
+/*!
+\brief Calculates the circular autocorrelation of a real signal
+\param[in] x - Real input signal
+\return Signal containing the autocorrelation at each lag
+*/
+template <typename T, typename Allocator>
+signal<T> autocorrelate(const signal<T, Allocator>& x)
+{
+    return autocorrelate(x.view());
+}
+
+/*!
+\brief Calculates the circular autocorrelation of a complex signal
+\param[in] x - Complex input signal
+\return Signal containing the autocorrelation at each lag
+*/
+template <typename T, typename Allocator>
+signal<std::complex<T>> autocorrelate(const signal<std::complex<T>, Allocator>& x)
+{
+    return autocorrelate(x.view());
+}
+
+/*!
+\brief Calculates a range of lags of the circular autocorrelation of a signal
+
+Lags are taken modulo the signal size, so a range starting at N - L covers the lags -L to -1. Short
+ranges (up to about 16 log2(N) lags) are calculated directly rather than from the full correlation.
+
+\param[in] x - View of the input samples
+\param[in] first_lag First lag to return
+\param[in] lags Number of lags to return
+\return Signal containing the autocorrelation at lags \a first_lag to \a first_lag + \a lags - 1
+*/
+template <typename T>
+signal<T> autocorrelate(const signal_view<const T>& x, const size_t first_lag, const size_t lags)
+{
+    if (lags == 0)
+    {
+        return signal<T>(x.sample_rate());
+    }
+
+    assert(x.size() > 0);
+
+    if (impl::prefer_direct_lags(x.size(), lags))
+    {
+        return impl::direct_lag_range(x, x, first_lag, lags);
+    }
+
+    return impl::lag_range(autocorrelate(x), first_lag, lags);
+}
+
+/*!
+\brief Calculates a range of lags of the circular autocorrelation of a signal
+\param[in] x - Input signal
+\param[in] first_lag First lag to return
+\param[in] lags Number of lags to return
+\return Signal containing the autocorrelation at lags \a first_lag to \a first_lag + \a lags - 1
+*/
+template <typename T, typename Allocator>
+signal<T> autocorrelate(const signal<T, Allocator>& x, const size_t first_lag, const size_t lags)
+{
+    return autocorrelate(x.view(), first_lag, lags);
+}
+
+}  // namespace tnt::dsp
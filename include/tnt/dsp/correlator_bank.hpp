@@ -0,0 +1,272 @@
+#pragma once
+
+#include "aligned_allocator.hpp"
+#include "fourier_transform.hpp"
+#include "multisignal.hpp"
+#include "signal.hpp"
+#include "signal_view.hpp"
+#include "workspace.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace tnt::dsp
+{
+
+/*!
+\brief Location and value of the largest correlation against a template
+*/
+template <typename T>
+struct correlation_peak
+{
+    /*!
+    \brief Lag at which the peak occurs
+    */
+    size_t lag;
+
+    /*!
+    \brief Correlation at the peak
+    */
+    T value;
+};
+
+/*!
+\brief Correlates blocks of a real signal against a bank of real templates
+
+The template spectra are calculated once on construction. Each input block is then transformed once
+regardless of the number of templates. The spectra of two templates are packed into the real and
+imaginary parts of one complex spectrum, so every inverse FFT produces two correlations.
+
+The packed spectra are inverse transformed in batches of pairs with one pass over the plan: each
+stage of the FFT is applied to every pair of the batch before the next stage, so the twiddle factors
+are loaded once per batch and the butterflies run over the pairs in vectorized loops. Batches are
+sized to stay in the cache, and peaks() searches every correlation of a batch in one pass over it
+instead of storing the correlations.
+
+Correlations are circular and defined the same way as cross_correlate().
+*/
+template <typename T>
+class correlator_bank final
+{
+public:
+    /*!
+    \brief Size type
+    */
+    using size_type = size_t;
+
+    /*!
+    \brief Constructor
+
+    Templates shorter than the block size are padded with zeros.
+
+    \param[in] templates Templates to correlate against
+    \param[in] block_size Size of the input blocks (at least 1)
+    */
+    correlator_bank(const std::vector<signal<T>>& templates, const size_type& block_size)
+        : m_sample_rate(templates.empty() ? 0 : templates.front().sample_rate())
+        , m_block_size(block_size)
+        , m_templates(templates.size())
+        , m_pairs((templates.size() + 1) / 2)
+        , m_spectra(m_pairs * block_size)
+    {
+        // Every correlation needs at least one lag to have a peak
+        assert(block_size > 0);
+
+        const auto N = m_block_size;
+
+        for (size_type k = 0; k < m_templates; ++k)
+        {
+            const auto& t = templates[k];
+
+            assert(t.sample_rate() == m_sample_rate);
+            assert(t.size() <= N);
+
+            signal<T> t_p(m_sample_rate, N);
+            std::copy(t.begin(), t.end(), t_p.begin());
+
+            const auto T_k = fourier_transform(t_p);
+
+            // Even templates go in the real part and odd templates go in the
+            // imaginary part of the packed spectrum. Since the correlations
+            // are real, X*conj(T_1) + jX*conj(T_2) separates after the inverse
+            // FFT into the real and imaginary parts. The spectra of the pairs
+            // are interleaved (bin m of pair p is at m * m_pairs + p) so that
+            // a batch of pairs is read contiguously.
+            const auto scale = k % 2 ? std::complex<T>(0, 1) : std::complex<T>(1);
+            for (size_type m = 0; m < N; ++m)
+            {
+                m_spectra[m * m_pairs + k / 2] += scale * std::conj(T_k[m]);
+            }
+        }
+    }
+
+    /*!
+    \brief Gets the sample rate
+    \return Sample rate
+    */
+    size_t sample_rate() const
+    {
+        return m_sample_rate;
+    }
+
+    /*!
+    \brief Gets the size of the input blocks
+    \return Block size
+    */
+    size_type block_size() const
+    {
+        return m_block_size;
+    }
+
+    /*!
+    \brief Gets the number of templates
+    \return Number of templates
+    */
+    size_type templates() const
+    {
+        return m_templates;
+    }
+
+    /*!
+    \brief Correlates a block against every template
+    \param[in] x View of the samples of the input block
+    \return Multi-channel signal with one channel holding the correlation against each template
+    */
+    multisignal<T> correlate(const signal_view<const T>& x) const
+    {
+        multisignal<T> r(m_sample_rate, m_block_size, m_templates, uninitialized);
+
+        this->for_each_batch(x, [&](const size_type k, const size_type B, const T* r_b) {
+            for (size_type j = k; j < std::min(k + 2 * B, m_templates); ++j)
+            {
+                const auto r_j = r.channel_view(j);
+                for (size_type n = 0; n < m_block_size; ++n)
+                {
+                    r_j[n] = r_b[2 * B * n + (j - k)];
+                }
+            }
+        });
+
+        return r;
+    }
+
+    /*!
+    \brief Correlates a block against every template
+    \param[in] x Input block
+    \return Multi-channel signal with one channel holding the correlation against each template
+    */
+    template <typename Allocator>
+    multisignal<T> correlate(const signal<T, Allocator>& x) const
+    {
+        return this->correlate(x.view());
+    }
+
+    /*!
+    \brief Finds the peak correlation against every template without storing the correlations
+
+    The peak is the lag with the largest absolute correlation.
+
+    \param[in] x View of the samples of the input block
+    \return Peak of the correlation against each template
+    */
+    std::vector<correlation_peak<T>> peaks(const signal_view<const T>& x) const
+    {
+        // Both templates of the last pair are searched even when the second
+        // one does not exist, since that costs nothing
+        std::vector<correlation_peak<T>> peaks(2 * m_pairs);
+
+        this->for_each_batch(x, [&](const size_type k, const size_type B, const T* r_b) {
+            // Every template of the batch is searched in the same pass
+            auto* const peaks_b = peaks.data() + k;
+            for (size_type j = 0; j < 2 * B; ++j)
+            {
+                peaks_b[j] = {0, r_b[j]};
+            }
+
+            for (size_type n = 1; n < m_block_size; ++n)
+            {
+                const auto* const r_n = r_b + 2 * B * n;
+                for (size_type j = 0; j < 2 * B; ++j)
+                {
+                    if (std::abs(r_n[j]) > std::abs(peaks_b[j].value))
+                    {
+                        peaks_b[j] = {n, r_n[j]};
+                    }
+                }
+            }
+        });
+
+        peaks.resize(m_templates);
+
+        return peaks;
+    }
+
+    /*!
+    \brief Finds the peak correlation against every template without storing the correlations
+    \param[in] x Input block
+    \return Peak of the correlation against each template
+    */
+    template <typename Allocator>
+    std::vector<correlation_peak<T>> peaks(const signal<T, Allocator>& x) const
+    {
+        return this->peaks(x.view());
+    }
+
+private:
+    // Calls f(k, B, r_b) with the correlations against the 2B templates from k
+    // on, where r_b[2 * B * n + j] is the correlation against template k + j at
+    // lag n. The correlations of every batch are written to the same scratch
+    // buffer.
+    template <typename F>
+    void for_each_batch(const signal_view<const T>& x, F f) const
+    {
+        assert(x.sample_rate() == m_sample_rate);
+        assert(x.size() == m_block_size);
+
+        const auto N    = m_block_size;
+        const auto plan = impl::get_fft_plan<T>(N);
+
+        // Batches of 16 pairs vectorize well, but fewer pairs of long blocks
+        // keep the batch in the cache. Only blocks whose size is a power of 2
+        // gain anything from being transformed in batches.
+        const auto pairs = N * sizeof(std::complex<T>) <= 32 * 1024 ? 16 : 8;
+        const auto batch = impl::is_power_of_2(N) ? std::min<size_type>(m_pairs, pairs) : 1;
+
+        impl::scratch_frame frame;
+        auto* const         X = frame.allocate<std::complex<T>>(N);
+        auto* const         R = frame.allocate<std::complex<T>>(N * batch);
+
+        // The input is only transformed once
+        impl::real_fft(impl::contiguous(x, frame), X, *plan);
+
+        for (size_type p = 0; p < m_pairs; p += batch)
+        {
+            const auto B = std::min(batch, m_pairs - p);
+
+            for (size_type m = 0; m < N; ++m)
+            {
+                const auto* const S_m = m_spectra.data() + m * m_pairs + p;
+                auto* const       R_m = R + m * B;
+                for (size_type i = 0; i < B; ++i)
+                {
+                    R_m[i] = X[m] * S_m[i];
+                }
+            }
+
+            impl::batched_inverse_fft(R, R, B, *plan);
+
+            f(2 * p, B, reinterpret_cast<const T*>(R));
+        }
+    }
+
+    size_t                                m_sample_rate;
+    size_type                             m_block_size;
+    size_type                             m_templates;
+    size_type                             m_pairs;
+    impl::aligned_vector<std::complex<T>> m_spectra;
+};
+
+}  // namespace tnt::dsp
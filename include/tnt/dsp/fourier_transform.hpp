@@ -1,12 +1,12 @@
 #pragma once
 
 #include "impl/fourier_transform.hpp"
-#include "impl/math_helpers.hpp"
 #include "signal.hpp"
+#include "signal_view.hpp"
 
-#include <algorithm>
-#include <cmath>
+#include <cassert>
 #include <complex>
+#include <type_traits>
 #include <utility>
 
 namespace tnt::dsp
@@ -14,90 +14,214 @@ namespace tnt::dsp
 
 /*!
 \brief Calculates the fast Fourier transform of a real signal
-\param[in] x - Real input signal
+
+The data precalculated for each transform size (twiddle factors, and the chirp spectra of sizes that
+are not powers of 2) is cached per thread and sample type. Each thread keeps the most recently used
+sizes up to 32 MiB, plus the last size used however large it is, so long-lived threads such as those
+of the thread pool do not accumulate the plans of every size they have transformed.
+
+\param[in] x - View of the real input samples
 \return Signal representing the FFT of the input data
 */
 template <typename T>
-signal<std::complex<T>> fourier_transform(const signal<T>& x)
+signal<std::complex<T>> fourier_transform(const signal_view<const T>& x)
 {
-    const auto f_s = x.sample_rate();
-    const auto N   = x.size();
+    impl::scratch_frame frame;
 
-    // TODO: See if further optimization can be done for odd values of N
-    // If N is odd, just perform the complex FFT
-    if (!impl::is_even(N))
-    {
-        signal<std::complex<T>> x_p(f_s, N);
-        std::transform(x.begin(), x.end(), x_p.begin(), [](const auto& sample) {
-            return std::complex<T>(sample);
-        });
+    signal<std::complex<T>> X(x.sample_rate(), x.size(), uninitialized);
+    impl::real_fft(impl::contiguous(x, frame), X.data(), *impl::get_fft_plan<T>(x.size()));
 
-        return fourier_transform(x_p);
-    }
+    return X;
+}
 
-    const auto N_over_2 = N / 2;
+/*!
+\brief Calculates the fast Fourier transform of a complex signal
 
-    // Taking advantage of symmetry the FFT of a real signal can be computed
-    // using a single N/2-point complex FFT. Split the input signal into its
-    // even and odd components and load the data into a single complex vector.
-    signal<std::complex<T>> x_p(f_s, N_over_2);
-    for (size_t n = 0; n < N_over_2; ++n)
-    {
-        const auto n_times_2 = n * 2;
+The data precalculated for each transform size is cached per thread (see the real overload).
 
-        // x_p[n] = x[2n] + jx[2n + 1]
-        x_p[n] = {x[n_times_2], x[n_times_2 + 1]};
-    }
+\param[in] x - View of the complex input samples
+\return Signal representing the FFT of the input data
+*/
+template <typename T>
+signal<std::complex<T>> fourier_transform(const signal_view<const std::complex<T>>& x)
+{
+    impl::scratch_frame frame;
+
+    signal<std::complex<T>> X(x.sample_rate(), x.size(), uninitialized);
+    impl::fft(impl::contiguous(x, frame), X.data(), *impl::get_fft_plan<T>(x.size()));
+
+    return X;
+}
+
+/*!
+\brief Calculates the fast Fourier transform of a real signal
+\param[in] x - Real input signal
+\return Signal representing the FFT of the input data
+*/
+template <typename T, typename Allocator>
+signal<std::complex<T>> fourier_transform(const signal<T, Allocator>& x)
+{
+    return fourier_transform(x.view());
+}
+
+/*!
+\brief Calculates the fast Fourier transform of a complex signal
+\param[in] x - Complex input signal
+\return Signal representing the FFT of the input data
+*/
+template <typename T, typename Allocator>
+signal<std::complex<T>> fourier_transform(const signal<std::complex<T>, Allocator>& x)
+{
+    return fourier_transform(x.view());
+}
+
+/*!
+\brief Calculates the fast Fourier transform of a view of mutable samples
+\param[in] x - View of the input samples
+\return Signal representing the FFT of the input data
+*/
+template <typename T, typename = std::enable_if_t<!std::is_const_v<T>>>
+auto fourier_transform(const signal_view<T>& x)
+{
+    return fourier_transform(signal_view<const T>(x));
+}
+
+/*!
+\brief Calculates the fast Fourier transform of a complex signal in place
+
+The transform is calculated in the storage of \a x, which is then returned, so no samples are
+copied and nothing is allocated for the result.
+
+\param[in] x - Complex input signal (moved from)
+\return Signal representing the FFT of the input data
+*/
+template <typename T, typename Allocator>
+signal<std::complex<T>, Allocator> fourier_transform(signal<std::complex<T>, Allocator>&& x)
+{
+    auto* const X = x.data();
+    impl::fft(X, X, *impl::get_fft_plan<T>(x.size()));
+
+    return std::move(x);
+}
+
+/*!
+\brief Calculates the fast Fourier transform of an expression
 
-    // Perform the complex FFT
-    auto X_p = impl::is_power_of_2(N) ? impl::stockham_fft(x_p) : impl::bluestein_fft(x_p);
+Complex expressions are evaluated straight into the storage of the result and transformed in place.
+Real expressions are evaluated into a temporary drawn from the workspace. Either way no signal is
+allocated for the input, so e.g. a windowed or modulated signal can be transformed directly.
 
-    // The FFT is periodic so it is valid append X_p[0] to the end. This is
-    // required to avoid a buffer overflow in the next section.
-    X_p.push_back(X_p[0]);
+\param[in] e - Expression
+\return Signal representing the FFT of the evaluated expression
+*/
+template <typename Op, typename... Operands>
+auto fourier_transform(const signal_expression<Op, Operands...>& e)
+{
+    using value_type = typename signal_expression<Op, Operands...>::value_type;
 
-    // Extract the real FFT from the output of the complex FFT
-    signal<std::complex<T>> X(f_s, N);
-    for (size_t m = 0; m < N_over_2; ++m)
+    if constexpr (impl::is_complex_v<value_type>)
+    {
+        return fourier_transform(signal<value_type>(e));
+    }
+    else
     {
-        const auto N_over_2_minus_m = N_over_2 - m;
+        impl::scratch_frame frame;
+        return fourier_transform(impl::const_view(e, frame));
+    }
+}
 
-        const auto X_r = std::make_pair((X_p[m].real() + X_p[N_over_2_minus_m].real()) / 2,
-                                        (X_p[m].real() - X_p[N_over_2_minus_m].real()) / 2);
+/*!
+\brief Calculates the fast Fourier transforms of two real signals at once
 
-        const auto X_i = std::make_pair((X_p[m].imag() + X_p[N_over_2_minus_m].imag()) / 2,
-                                        (X_p[m].imag() - X_p[N_over_2_minus_m].imag()) / 2);
+Both signals are loaded into a single complex signal (\a x1 as the real part and \a x2 as the
+imaginary part) so that both transforms are calculated with one complex FFT. This is well suited to
+stereo and I/Q pairs.
 
-        const auto a = std::cos(static_cast<T>(M_PI) * m / N_over_2);
-        const auto b = std::sin(static_cast<T>(M_PI) * m / N_over_2);
+\param[in] x1 - View of the real input samples
+\param[in] x2 - View of the real input samples
+\return Pair of signals representing the FFTs of \a x1 and \a x2
+*/
+template <typename T>
+std::pair<signal<std::complex<T>>, signal<std::complex<T>>> fourier_transform(
+    const signal_view<const T>& x1,
+    const signal_view<const T>& x2)
+{
+    assert(x1.sample_rate() == x2.sample_rate());
+    assert(x1.size() == x2.size());
 
-        X[m] = {X_r.first + a * X_i.first - b * X_r.second,
-                X_i.second - b * X_i.first - a * X_r.second};
+    const auto f_s = x1.sample_rate();
+    const auto N   = x1.size();
+
+    // Z[n] = x1[n] + jx2[n] (transformed in place)
+    impl::scratch_frame frame;
+    auto* const         Z = frame.allocate<std::complex<T>>(N);
+    for (size_t n = 0; n < N; ++n)
+    {
+        Z[n] = {x1[n], x2[n]};
     }
 
-    // X[m] = X*[N-m] where 1 <= m <= N/2 - 1
-    for (size_t m = 1; m < N_over_2; ++m)
+    impl::fft(Z, Z, *impl::get_fft_plan<T>(N));
+
+    // The FFT of a real signal is conjugate symmetric, so the two transforms
+    // are the conjugate symmetric and conjugate antisymmetric parts of Z:
+    // X1[m] = (Z[m] + Z*[N-m]) / 2
+    // X2[m] = (Z[m] - Z*[N-m]) / 2j
+    signal<std::complex<T>> X1(f_s, N, uninitialized);
+    signal<std::complex<T>> X2(f_s, N, uninitialized);
+    for (size_t m = 0; m < N; ++m)
     {
-        X[N - m] = std::conj(X[m]);  // (>*.*)> symmetry! <(*.*<)
+        const auto Z_m              = Z[m];
+        const auto Z_conj_N_minus_m = std::conj(Z[(N - m) % N]);
+
+        X1[m] = (Z_m + Z_conj_N_minus_m) / static_cast<T>(2);
+        X2[m] = (Z_m - Z_conj_N_minus_m) * std::complex<T>(0, -0.5);
     }
 
-    // X[N_over_2] is a special case
-    X[N_over_2] = X_p[0].real() - X_p[0].imag();
+    return {std::move(X1), std::move(X2)};
+}
 
-    return X;
+/*!
+\brief Calculates the fast Fourier transforms of two real signals at once
+\param[in] x1 - Real input signal
+\param[in] x2 - Real input signal
+\return Pair of signals representing the FFTs of \a x1 and \a x2
+*/
+template <typename T, typename Allocator>
+std::pair<signal<std::complex<T>>, signal<std::complex<T>>> fourier_transform(
+    const signal<T, Allocator>& x1,
+    const signal<T, Allocator>& x2)
+{
+    return fourier_transform(x1.view(), x2.view());
 }
 
 /*!
-\brief Calculates the fast Fourier transform of a complex signal
-\param[in] x - Complex input signal
-\return Signal representing the FFT of the input data
+\brief Calculates the fast Fourier transforms of two views of mutable real samples at once
+\param[in] x1 - View of the real input samples
+\param[in] x2 - View of the real input samples
+\return Pair of signals representing the FFTs of \a x1 and \a x2
+*/
+template <typename T, typename = std::enable_if_t<!std::is_const_v<T>>>
+std::pair<signal<std::complex<T>>, signal<std::complex<T>>> fourier_transform(
+    const signal_view<T>& x1,
+    const signal_view<T>& x2)
+{
+    return fourier_transform(signal_view<const T>(x1), signal_view<const T>(x2));
+}
+
+/*!
+\brief Calculates the inverse fast Fourier transform of a complex signal
+\param[in] X - View of the complex input samples
+\return Signal representing the IFFT of the input data
 */
 template <typename T>
-signal<std::complex<T>> fourier_transform(const signal<std::complex<T>>& x)
+signal<std::complex<T>> inverse_fourier_transform(const signal_view<const std::complex<T>>& X)
 {
-    const auto N = x.size();
+    impl::scratch_frame frame;
+
+    signal<std::complex<T>> x(X.sample_rate(), X.size(), uninitialized);
+    impl::inverse_fft(impl::contiguous(X, frame), x.data(), *impl::get_fft_plan<T>(X.size()));
 
-    return impl::is_power_of_2(N) ? impl::stockham_fft(x) : impl::bluestein_fft(x);
+    return x;
 }
 
 /*!
@@ -105,25 +229,55 @@ signal<std::complex<T>> fourier_transform(const signal<std::complex<T>>& x)
 \param[in] X - Complex input signal
 \return Signal representing the IFFT of the input data
 */
-template <typename T>
-signal<std::complex<T>> inverse_fourier_transform(const signal<std::complex<T>>& X)
+template <typename T, typename Allocator>
+signal<std::complex<T>> inverse_fourier_transform(const signal<std::complex<T>, Allocator>& X)
+{
+    return inverse_fourier_transform(X.view());
+}
+
+/*!
+\brief Calculates the inverse fast Fourier transform of a view of mutable samples
+\param[in] X - View of the input samples
+\return Signal representing the IFFT of the input data
+*/
+template <typename T, typename = std::enable_if_t<!std::is_const_v<T>>>
+auto inverse_fourier_transform(const signal_view<T>& X)
+{
+    return inverse_fourier_transform(signal_view<const T>(X));
+}
+
+/*!
+\brief Calculates the inverse fast Fourier transform of a complex expression
+
+The expression is evaluated straight into the storage of the result and transformed in place.
+
+\param[in] e - Complex expression
+\return Signal representing the IFFT of the evaluated expression
+*/
+template <typename Op, typename... Operands>
+auto inverse_fourier_transform(const signal_expression<Op, Operands...>& e)
 {
-    const auto f_s = X.sample_rate();
-    const auto N   = X.size();
+    using value_type = typename signal_expression<Op, Operands...>::value_type;
 
-    signal<std::complex<T>> X_p(f_s, N);
-    std::transform(X.begin(), X.end(), X_p.begin(), [](const auto& sample) {
-        return std::conj(sample);
-    });
+    return inverse_fourier_transform(signal<value_type>(e));
+}
 
-    const auto x_p = fourier_transform(X_p);
+/*!
+\brief Calculates the inverse fast Fourier transform of a complex signal in place
 
-    signal<std::complex<T>> x(f_s, N);
-    std::transform(x_p.begin(), x_p.end(), x.begin(), [=](const auto& sample) {
-        return std::conj(sample) / static_cast<T>(N);
-    });
+The inverse transform is calculated in the storage of \a X, which is then returned, so no samples
+are copied and nothing is allocated for the result.
 
-    return x;
+\param[in] X - Complex input signal (moved from)
+\return Signal representing the IFFT of the input data
+*/
+template <typename T, typename Allocator>
+signal<std::complex<T>, Allocator> inverse_fourier_transform(signal<std::complex<T>, Allocator>&& X)
+{
+    auto* const x = X.data();
+    impl::inverse_fft(x, x, *impl::get_fft_plan<T>(X.size()));
+
+    return std::move(X);
 }
 
 }  // namespace tnt::dsp
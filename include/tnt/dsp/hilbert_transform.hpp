@@ -1,42 +1,65 @@
 #pragma once
 
 #include "fourier_transform.hpp"
+#include "signal.hpp"
+#include "signal_view.hpp"
 
+#include <algorithm>
 #include <complex>
+#include <type_traits>
 
 namespace tnt::dsp
 {
 
 /*!
 \brief Calculates the analytical signal of a real input signal
-\param[in] x - Real input signal
+\param[in] x - View of the real input samples
 \return Analytical signal representing the Hilbert transform of the input signal
 */
 template <typename T>
-signal<std::complex<T>> hilbert_transform(const signal<T>& x)
+signal<std::complex<T>> hilbert_transform(const signal_view<const T>& x)
 {
-    const auto sampleRate = x.sample_rate();
-    const auto N          = x.size();
-
-    // Take the Fourier transform
-    const auto X = fourier_transform(x);
-
-    signal<std::complex<T>> X_c(sampleRate, N);
+    const auto N = x.size();
 
-    // The DC component does not get doubled
-    X_c[0] = X[0];
+    // Take the Fourier transform. The analytical signal is calculated in place
+    // so that no other signal has to be allocated.
+    auto X = fourier_transform(x);
 
-    // Set all real to 2x the Fourier transform
-    // Zero out imaginary components (past N/2)
+    // Double the positive frequencies (the DC component does not get doubled)
     for (size_t n = 1; n <= N / 2; ++n)
     {
-        X_c[n] = static_cast<T>(2) * X[n];
+        X[n] *= static_cast<T>(2);
     }
 
+    // Zero out imaginary components (past N/2)
+    std::fill(X.begin() + std::min(N, N / 2 + 1), X.end(), std::complex<T>());
+
     // Take the inverse Fourier transform
-    const auto x_c = inverse_fourier_transform(X_c);
+    impl::inverse_fft(X.data(), X.data(), *impl::get_fft_plan<T>(N));
+
+    return X;
+}
+
+/*!
+\brief Calculates the analytical signal of a real input signal
+\param[in] x - Real input signal
+\return Analytical signal representing the Hilbert transform of the input signal
+*/
+template <typename T, typename Allocator>
+signal<std::complex<T>> hilbert_transform(const signal<T, Allocator>& x)
+{
+    return hilbert_transform(x.view());
+}
 
-    return x_c;
+/*!
+\brief Calculates the analytical signal of a view of mutable real samples
+\param[in] x - View of the input samples
+\return Analytical signal representing the Hilbert transform of the input signal
+*/
+template <typename T, typename = std::enable_if_t<!std::is_const_v<T>>>
+auto hilbert_transform(const signal_view<T>& x)
+{
+    return hilbert_transform(signal_view<const T>(x));
 }
 
 }  // namespace tnt::dsp
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "../signal.hpp"
+#include "../signal_view.hpp"
+#include "vector_operations.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <complex>
+#include <type_traits>
+
+namespace tnt::dsp::impl
+{
+
+// Gets the number of samples up to and including the last non-zero sample
+template <typename T>
+size_t support(const signal_view<T>& x)
+{
+    auto K = x.size();
+    while (K > 0 && x[K - 1] == std::remove_cv_t<T>{})
+    {
+        --K;
+    }
+
+    return K;
+}
+
+// Calculates the circular convolution of x with the first K samples of h
+// directly in the time domain. The cost is proportional to N*K, so this is
+// only worthwhile when h is short.
+template <typename R, typename A, typename B>
+void direct_convolve(const A* x, const B* h, const size_t N, const size_t K, R* c)
+{
+    assert(K <= N);
+
+    std::fill(c, c + N, R{});
+
+    // Each tap scales a shifted copy of x into the output. Splitting each
+    // shift into its non-wrapping and wrapping parts keeps both inner loops
+    // contiguous.
+    for (size_t k = 0; k < K; ++k)
+    {
+        // c[n] += h[k] * x[n - k] where k <= n < N
+        multiply_accumulate(c + k, x, h[k], N - k);
+
+        // c[n] += h[k] * x[N + n - k] where 0 <= n < k
+        multiply_accumulate(c, x + N - k, h[k], k);
+    }
+}
+
+// Calculates the circular convolution of a and b directly in the time domain
+// using whichever of the two signals has the shorter support as the kernel
+template <typename R, typename A, typename B>
+signal<R> direct_convolve(const signal_view<const A>& a,
+                          const size_t                K_a,
+                          const signal_view<const B>& b,
+                          const size_t                K_b)
+{
+    assert(a.sample_rate() == b.sample_rate());
+    assert(a.size() == b.size());
+
+    scratch_frame     frame;
+    const auto* const a_p = impl::contiguous(a, frame);
+    const auto* const b_p = impl::contiguous(b, frame);
+
+    signal<R> c(a.sample_rate(), a.size(), uninitialized);
+
+    if (K_b <= K_a)
+    {
+        impl::direct_convolve(a_p, b_p, a.size(), K_b, c.data());
+    }
+    else
+    {
+        impl::direct_convolve(b_p, a_p, b.size(), K_a, c.data());
+    }
+
+    return c;
+}
+
+}  // namespace tnt::dsp::impl
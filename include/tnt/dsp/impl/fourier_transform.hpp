@@ -1,169 +1,667 @@
 #pragma once
 
-#include "impl/math_helpers.hpp"
-#include "signal.hpp"
+#include "../aligned_allocator.hpp"
+#include "../workspace.hpp"
+#include "math_helpers.hpp"
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <complex>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace tnt::dsp::impl
 {
 
-// C++ implementation of the Bluestein FFT algorithm
+// Calculates the twiddle factors W[n] = e^(-j*2*pi*n/N) for 0 <= n < count
 template <typename T>
-signal<std::complex<T>> bluestein_fft(const signal<std::complex<T>>& x)
+aligned_vector<std::complex<T>> twiddle_factors(const size_t N, const size_t count)
 {
-    const auto f_s = x.sample_rate();
-    const auto N   = x.size();
+    aligned_vector<std::complex<T>> W(count);
+    for (size_t n = 0; n < count; ++n)
+    {
+        // Calculated in double precision to keep float twiddles accurate
+        W[n] = std::complex<T>(std::polar(1.0, -2 * M_PI * n / N));
+    }
 
-    // To avoid issues with convolution periodicity, the convolution size must
-    // be at least 2*N - 1
-    const auto M = impl::next_power_of_2(2 * N - 1);
+    return W;
+}
 
-    // Calculate the "phase factors"
-    signal<std::complex<T>> P(f_s, N);
-    for (size_t n = 0; n < N; ++n)
+// Performs a single radix-2 stage of the Stockham FFT from a into b
+template <typename T>
+void stockham_stage(const std::complex<T>* a,
+                    std::complex<T>*       b,
+                    const std::complex<T>* W,
+                    const size_t           N,
+                    const size_t           stride,
+                    const size_t           W_stride)
+{
+    const auto N_over_2 = N / 2;
+
+    // Loop through the individual FFTs of the stage
+    for (size_t m = 0; m < N_over_2; m += stride)
+    {
+        const auto m_times_2 = m * 2;
+
+        // Perform each individual FFT
+        for (size_t n = 0; n < stride; ++n)
+        {
+            // Calculate the input indexes
+            const auto a_index_1 = n + m;
+            const auto a_index_2 = a_index_1 + N_over_2;
+
+            // Calculate the output indexes
+            const auto b_index_1 = n + m_times_2;
+            const auto b_index_2 = b_index_1 + stride;
+
+            // Perform the FFT
+            const auto tmp1 = a[a_index_1];
+            const auto tmp2 = W[n * W_stride] * a[a_index_2];
+
+            // Sum the results
+            b[b_index_1] = tmp1 + tmp2;
+            b[b_index_2] = tmp1 - tmp2;  // (>*.*)> symmetry! <(*.*<)
+        }
+    }
+}
+
+// C++ implementation of the Stockam FFT algorithm
+//
+// Calculates the FFT of x into X using work as a temporary workspace. Both X
+// and work must hold N samples. The work buffer may be the same as x if the
+// input does not need to be preserved, and x may be the same as X.
+template <typename T>
+void stockham_fft(const std::complex<T>* x,
+                  std::complex<T>*       X,
+                  std::complex<T>*       work,
+                  const std::complex<T>* W,
+                  const size_t           N)
+{
+    assert(impl::is_power_of_2(N));
+
+    if (N == 1)
     {
-        // %(2*N) is done to improve accuracy of floating point trigonometry
-        P[n] = std::polar(static_cast<T>(1), -static_cast<T>(M_PI) * ((n * n) % (2 * N)) / N);
+        X[0] = x[0];
+        return;
     }
 
-    // Construct the two sequences to perform convolution
-    signal<std::complex<T>> a(f_s, M);
-    signal<std::complex<T>> b(f_s, M);
-    a[0] = x[0] * P[0];
-    b[0] = P[0];
-    for (size_t n = 1; n < N; ++n)
+    size_t stages = 0;
+    for (size_t stride = 1; stride < N; stride *= 2)
     {
-        a[n] = x[n] * P[n];
-        b[n] = b[M - n] = std::conj(P[n]);  // (>*.*)> symmetry! <(*.*<)
+        ++stages;
     }
 
-    const auto c = impl::convolve(a, b);
+    // The output of each stage is the input of the next, so the stages
+    // alternate between X and the work buffer. Pick the first output so that
+    // the last stage writes into X, unless that would overwrite the input
+    // during the first stage.
+    auto* b = stages % 2 == 1 ? X : work;
+    if (b == x)
+    {
+        b = b == X ? work : X;
+    }
+    auto* a = b == X ? work : X;
 
-    // Mutiply by the "phase factors" to obtain the correct results
-    signal<std::complex<T>> X(f_s, N);
-    for (size_t m = 0; m < N; ++m)
+    // Set the spacing between twiddle factors used at the first stage
+    auto W_stride = N / 2;
+
+    // Loop through each stage of the FFT
+    const auto* input = x;
+    for (size_t stride = 1; stride < N; stride *= 2)
     {
-        X[m] = c[m] * P[m];
+        impl::stockham_stage(input, b, W, N, stride, W_stride);
+
+        // Spacing between twiddle factors is half for the next stage
+        W_stride /= 2;
+
+        // Swap the data (output of this stage is input of the next)
+        input = b;
+        std::swap(a, b);
     }
 
-    return X;
+    if (input != X)
+    {
+        std::copy(input, input + N, X);
+    }
 }
 
-// Note that this is specialized for performing the Bluestein FFT efficiently.
-// This is not a general purpose convolution algorithm.
+// Performs a single radix-2 stage of the Stockham FFT on B interleaved
+// sequences from a into b, where sample n of sequence i is at index n * B + i
+//
+// The twiddle factor of a butterfly is the same for every sequence, so the
+// innermost loop runs over the sequences. It is then long and contiguous even
+// in the first stages, where a single sequence only has one or two butterflies
+// per twiddle factor. Complex data is processed as interleaved real/imaginary
+// pairs so that the loop vectorizes (see multiply_accumulate).
 template <typename T>
-signal<std::complex<T>> convolve(const signal<std::complex<T>>& a, const signal<std::complex<T>>& b)
+void batched_stockham_stage(const std::complex<T>* a,
+                            std::complex<T>*       b,
+                            const std::complex<T>* W,
+                            const size_t           N,
+                            const size_t           stride,
+                            const size_t           W_stride,
+                            const size_t           B)
 {
-    assert(a.sample_rate() == b.sample_rate());
-    assert(a.size() == b.size());
-    assert(is_power_of_2(a.size()));
-
-    const auto f_s      = a.sample_rate();
-    const auto N        = a.size();
     const auto N_over_2 = N / 2;
-    const auto omega    = 2 * static_cast<T>(M_PI) / N;
 
-    // Pre-calculate the twiddle factors
-    signal<std::complex<T>> W(f_s, N_over_2);
+    for (size_t m = 0; m < N_over_2; m += stride)
+    {
+        for (size_t n = 0; n < stride; ++n)
+        {
+            const auto W_r = W[n * W_stride].real();
+            const auto W_i = W[n * W_stride].imag();
 
-    for (size_t n = 0; n < N_over_2; ++n)
+            const auto* const a_1 = reinterpret_cast<const T*>(a + (n + m) * B);
+            const auto* const a_2 = reinterpret_cast<const T*>(a + (n + m + N_over_2) * B);
+
+            auto* const b_1 = reinterpret_cast<T*>(b + (n + m * 2) * B);
+            auto* const b_2 = reinterpret_cast<T*>(b + (n + m * 2 + stride) * B);
+
+            for (size_t i = 0; i < 2 * B; i += 2)
+            {
+                const auto tmp_r = W_r * a_2[i] - W_i * a_2[i + 1];
+                const auto tmp_i = W_r * a_2[i + 1] + W_i * a_2[i];
+
+                b_1[i]     = a_1[i] + tmp_r;
+                b_1[i + 1] = a_1[i + 1] + tmp_i;
+                b_2[i]     = a_1[i] - tmp_r;
+                b_2[i + 1] = a_1[i + 1] - tmp_i;
+            }
+        }
+    }
+}
+
+// Calculates the FFTs of B interleaved sequences of N samples (see
+// batched_stockham_stage) into X
+//
+// The buffers are used the same way as by stockham_fft, but each holds N * B
+// samples.
+template <typename T>
+void batched_stockham_fft(const std::complex<T>* x,
+                          std::complex<T>*       X,
+                          std::complex<T>*       work,
+                          const std::complex<T>* W,
+                          const size_t           N,
+                          const size_t           B)
+{
+    assert(impl::is_power_of_2(N));
+
+    size_t stages = 0;
+    for (size_t stride = 1; stride < N; stride *= 2)
+    {
+        ++stages;
+    }
+
+    auto* b = stages % 2 == 1 ? X : work;
+    if (b == x)
+    {
+        b = b == X ? work : X;
+    }
+    auto* a = b == X ? work : X;
+
+    auto W_stride = N / 2;
+
+    const auto* input = x;
+    for (size_t stride = 1; stride < N; stride *= 2)
+    {
+        impl::batched_stockham_stage(input, b, W, N, stride, W_stride, B);
+
+        W_stride /= 2;
+
+        input = b;
+        std::swap(a, b);
+    }
+
+    if (input != X)
+    {
+        std::copy(input, input + N * B, X);
+    }
+}
+
+// Forward declarations
+template <typename T>
+class fft_plan;
+
+template <typename T>
+std::shared_ptr<const fft_plan<T>> get_fft_plan(const size_t N);
+
+// Precalculated data for transforms of a single size
+//
+// A plan holds on to the plans of the other sizes it uses, so that it stays
+// usable after they have been evicted from the cache.
+template <typename T>
+class fft_plan final
+{
+public:
+    explicit fft_plan(const size_t N)
+        : m_size(N)
+        , m_convolution_size()
+    {
+        if (N == 0)
+        {
+            return;
+        }
+
+        if (impl::is_power_of_2(N))
+        {
+            m_twiddle_factors = impl::twiddle_factors<T>(N, N / 2);
+        }
+        else
+        {
+            // To avoid issues with convolution periodicity, the convolution
+            // size must be at least 2*N - 1
+            const auto M = impl::next_power_of_2(2 * N - 1);
+
+            m_convolution_size = M;
+            m_convolution_plan = impl::get_fft_plan<T>(M);
+
+            // Calculate the "phase factors"
+            m_chirp.resize(N);
+            for (size_t n = 0; n < N; ++n)
+            {
+                // %(2*N) is done to improve accuracy of floating point trigonometry
+                const auto phase = -M_PI * ((n * n) % (2 * N)) / N;
+
+                m_chirp[n] = std::complex<T>(std::polar(1.0, phase));
+            }
+
+            // The second convolution sequence only depends on N, so its
+            // transform is calculated once. It is prescaled by 1/M to fold in
+            // the normalization of the inverse FFT.
+            aligned_vector<std::complex<T>> b(M);
+            b[0] = m_chirp[0];
+            for (size_t n = 1; n < N; ++n)
+            {
+                b[n] = b[M - n] = std::conj(m_chirp[n]);  // (>*.*)> symmetry! <(*.*<)
+            }
+
+            m_chirp_spectrum.resize(M);
+            impl::stockham_fft(b.data(),
+                               m_chirp_spectrum.data(),
+                               b.data(),
+                               m_convolution_plan->twiddle_factors(),
+                               M);
+
+            for (auto& B_m : m_chirp_spectrum)
+            {
+                B_m /= static_cast<T>(M);
+            }
+        }
+
+        if (impl::is_even(N))
+        {
+            // Twiddle factors to extract a real FFT from an N/2-point complex FFT
+            const auto N_over_2 = N / 2;
+
+            m_real_twiddle_factors.resize(N_over_2);
+            for (size_t m = 0; m < N_over_2; ++m)
+            {
+                const auto a = std::cos(M_PI * m / N_over_2);
+                const auto b = std::sin(M_PI * m / N_over_2);
+
+                m_real_twiddle_factors[m] = {static_cast<T>(a), static_cast<T>(b)};
+            }
+        }
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    // Size of the power of 2 convolution used by the Bluestein algorithm
+    size_t convolution_size() const
+    {
+        return m_convolution_size;
+    }
+
+    // Plan of the Bluestein convolution (other sizes only)
+    const fft_plan& convolution_plan() const
+    {
+        return *m_convolution_plan;
+    }
+
+    // Plan of the N/2-point complex FFT used for real FFTs (even sizes only),
+    // created the first time it is needed since most sizes are only ever
+    // used for one kind of transform
+    const fft_plan& half_plan() const
+    {
+        if (!m_half_plan)
+        {
+            m_half_plan = impl::get_fft_plan<T>(m_size / 2);
+        }
+
+        return *m_half_plan;
+    }
+
+    // Memory held by the plan itself (not the plans it uses)
+    size_t bytes() const
+    {
+        const auto elements = m_twiddle_factors.size() + m_chirp.size() + m_chirp_spectrum.size() +
+                              m_real_twiddle_factors.size();
+
+        return sizeof(*this) + elements * sizeof(std::complex<T>);
+    }
+
+    // Stockham twiddle factors (power of 2 sizes only)
+    const std::complex<T>* twiddle_factors() const
+    {
+        return m_twiddle_factors.data();
+    }
+
+    // Bluestein "phase factors" (other sizes only)
+    const std::complex<T>* chirp() const
+    {
+        return m_chirp.data();
+    }
+
+    // Scaled FFT of the Bluestein convolution sequence (other sizes only)
+    const std::complex<T>* chirp_spectrum() const
+    {
+        return m_chirp_spectrum.data();
+    }
+
+    // Twiddle factors for real FFTs (even sizes only)
+    const std::complex<T>* real_twiddle_factors() const
     {
-        W[n] = std::complex<T>(std::cos(-omega * n), std::sin(-omega * n));
+        return m_real_twiddle_factors.data();
+    }
+
+private:
+    size_t                          m_size;
+    size_t                          m_convolution_size;
+    aligned_vector<std::complex<T>> m_twiddle_factors;
+    aligned_vector<std::complex<T>> m_chirp;
+    aligned_vector<std::complex<T>> m_chirp_spectrum;
+    aligned_vector<std::complex<T>> m_real_twiddle_factors;
+
+    std::shared_ptr<const fft_plan> m_convolution_plan;
+
+    // Plans are only used by the thread that created them (see get_fft_plan())
+    mutable std::shared_ptr<const fft_plan> m_half_plan;
+};
+
+// Total size of the plans that each thread keeps cached for each sample type
+inline constexpr size_t fft_plan_cache_bytes = 32 * 1024 * 1024;
+
+// Cache of the plans used by one thread, which keeps the most recently used
+// plans up to fft_plan_cache_bytes (and always the last one used, however
+// large it is)
+template <typename T>
+class fft_plan_cache final
+{
+public:
+    std::shared_ptr<const fft_plan<T>> get(const size_t N)
+    {
+        if (const auto it = m_index.find(N); it != m_index.end())
+        {
+            m_plans.splice(m_plans.begin(), m_plans, it->second);
+            return it->second->second;
+        }
+
+        // Creating a plan may create other plans, so create it before inserting it
+        auto plan = std::make_shared<const fft_plan<T>>(N);
+
+        m_plans.emplace_front(N, plan);
+        m_index[N] = m_plans.begin();
+        m_bytes += plan->bytes();
+
+        while (m_bytes > fft_plan_cache_bytes && m_plans.size() > 1)
+        {
+            const auto& [N_lru, plan_lru] = m_plans.back();
+
+            m_bytes -= plan_lru->bytes();
+            m_index.erase(N_lru);
+            m_plans.pop_back();
+        }
+
+        return plan;
     }
 
-    // Because we know N is a power of 2 we can explicitly use the Stockham FFT algorithm
-    const auto A = impl::stockham_fft(a, W);
-    const auto B = impl::stockham_fft(b, W);
+private:
+    using entry = std::pair<size_t, std::shared_ptr<const fft_plan<T>>>;
+
+    std::list<entry>                                                m_plans;
+    std::unordered_map<size_t, typename std::list<entry>::iterator> m_index;
+    size_t                                                          m_bytes = 0;
+};
+
+// Gets the plan for transforms of size N, creating it on first use
+//
+// Plans are cached per thread so that they can be used without any
+// synchronization. The cache is bounded (see fft_plan_cache), so plans are
+// shared with the callers, and a plan that is evicted while it is still in use
+// lives until its last user lets go of it.
+template <typename T>
+std::shared_ptr<const fft_plan<T>> get_fft_plan(const size_t N)
+{
+    thread_local fft_plan_cache<T> plans;
+
+    return plans.get(N);
+}
+
+// C++ implementation of the Bluestein FFT algorithm
+//
+// The input may be real or complex and may be the same as the output.
+template <typename T, typename U>
+void bluestein_fft(const U* x, std::complex<T>* X, const fft_plan<T>& plan)
+{
+    const auto  N      = plan.size();
+    const auto  M      = plan.convolution_size();
+    const auto* P      = plan.chirp();
+    const auto* B      = plan.chirp_spectrum();
+    const auto& plan_M = plan.convolution_plan();
+
+    scratch_frame frame;
+    auto* const   a = frame.allocate<std::complex<T>>(2 * M);
+    auto* const   A = a + M;
+
+    // Construct the first sequence to perform convolution
+    for (size_t n = 0; n < N; ++n)
+    {
+        a[n] = x[n] * P[n];
+    }
+    std::fill(a + N, a + M, std::complex<T>());
 
     // The convolution theorem states that multiplication in the frequency
-    // domain is equivalent to convolution in the time domain
-    signal<std::complex<T>> C(f_s, N);
-    std::transform(A.begin(), A.end(), B.begin(), C.begin(), std::multiplies<std::complex<T>>());
+    // domain is equivalent to convolution in the time domain. The inverse FFT
+    // is calculated as the conjugate of the FFT of the conjugate.
+    impl::stockham_fft(a, A, a, plan_M.twiddle_factors(), M);
+    for (size_t m = 0; m < M; ++m)
+    {
+        a[m] = std::conj(A[m] * B[m]);
+    }
+    impl::stockham_fft(a, A, a, plan_M.twiddle_factors(), M);
 
-    return inverse_fourier_transform(C);
+    // Mutiply by the "phase factors" to obtain the correct results
+    for (size_t m = 0; m < N; ++m)
+    {
+        X[m] = std::conj(A[m]) * P[m];
+    }
 }
 
-// C++ implementation of the Stockam FFT algorithm
+// Calculates the FFT of a complex sequence of N samples into X
+//
+// The input may be the same as the output.
 template <typename T>
-signal<std::complex<T>> stockham_fft(const signal<std::complex<T>>& x)
+void fft(const std::complex<T>* x, std::complex<T>* X, const fft_plan<T>& plan)
 {
-    assert(impl::is_power_of_2(x.size()));
+    const auto N = plan.size();
 
-    const auto f_s      = x.sample_rate();
-    const auto N        = x.size();
-    const auto N_over_2 = N / 2;
-    const auto omega    = 2 * static_cast<T>(M_PI) / N;
+    if (N == 0)
+    {
+        return;
+    }
+
+    if (impl::is_power_of_2(N))
+    {
+        scratch_frame frame;
+        impl::stockham_fft(x, X, frame.allocate<std::complex<T>>(N), plan.twiddle_factors(), N);
+    }
+    else
+    {
+        impl::bluestein_fft(x, X, plan);
+    }
+}
+
+// Calculates the FFT of a real sequence of N samples into X
+template <typename T>
+void real_fft(const T* x, std::complex<T>* X, const fft_plan<T>& plan)
+{
+    const auto N = plan.size();
+
+    if (N == 0)
+    {
+        return;
+    }
 
-    // Pre-calculate the twiddle factors
-    signal<std::complex<T>> W(f_s, N_over_2);
+    if (N == 1)
+    {
+        X[0] = x[0];
+        return;
+    }
+
+    // TODO: See if further optimization can be done for odd values of N
+    // If N is odd, just perform the complex FFT (the Bluestein algorithm
+    // accepts real input directly)
+    if (!impl::is_even(N))
+    {
+        impl::bluestein_fft(x, X, plan);
+        return;
+    }
+
+    const auto  N_over_2 = N / 2;
+    const auto& plan_p   = plan.half_plan();
 
+    scratch_frame frame;
+    auto* const   x_p = frame.allocate<std::complex<T>>(2 * N_over_2 + 1);
+    auto* const   X_p = x_p + N_over_2;
+
+    // Taking advantage of symmetry the FFT of a real signal can be computed
+    // using a single N/2-point complex FFT. Split the input signal into its
+    // even and odd components and load the data into a single complex vector.
     for (size_t n = 0; n < N_over_2; ++n)
     {
-        W[n] = std::complex<T>(std::cos(-omega * n), std::sin(-omega * n));
+        const auto n_times_2 = n * 2;
+
+        // x_p[n] = x[2n] + jx[2n + 1]
+        x_p[n] = {x[n_times_2], x[n_times_2 + 1]};
+    }
+
+    // Perform the complex FFT
+    impl::fft(x_p, X_p, plan_p);
+
+    // The FFT is periodic so it is valid append X_p[0] to the end. This is
+    // required to avoid a buffer overflow in the next section.
+    X_p[N_over_2] = X_p[0];
+
+    // Extract the real FFT from the output of the complex FFT
+    const auto* R = plan.real_twiddle_factors();
+    for (size_t m = 0; m < N_over_2; ++m)
+    {
+        const auto N_over_2_minus_m = N_over_2 - m;
+
+        const auto X_r = std::make_pair((X_p[m].real() + X_p[N_over_2_minus_m].real()) / 2,
+                                        (X_p[m].real() - X_p[N_over_2_minus_m].real()) / 2);
+
+        const auto X_i = std::make_pair((X_p[m].imag() + X_p[N_over_2_minus_m].imag()) / 2,
+                                        (X_p[m].imag() - X_p[N_over_2_minus_m].imag()) / 2);
+
+        const auto a = R[m].real();
+        const auto b = R[m].imag();
+
+        X[m] = {X_r.first + a * X_i.first - b * X_r.second,
+                X_i.second - b * X_i.first - a * X_r.second};
+    }
+
+    // X[m] = X*[N-m] where 1 <= m <= N/2 - 1
+    for (size_t m = 1; m < N_over_2; ++m)
+    {
+        X[N - m] = std::conj(X[m]);  // (>*.*)> symmetry! <(*.*<)
     }
 
-    return impl::stockham_fft(x, W);
+    // X[N_over_2] is a special case
+    X[N_over_2] = X_p[0].real() - X_p[0].imag();
 }
 
-// C++ implementation of the Stockam FFT algorithm
+// Calculates the inverse FFT of a complex sequence of N samples into x
+//
+// The input may be the same as the output.
 template <typename T>
-signal<std::complex<T>> stockham_fft(const signal<std::complex<T>>& x,
-                                     const signal<std::complex<T>>& W)
+void inverse_fft(const std::complex<T>* X, std::complex<T>* x, const fft_plan<T>& plan)
 {
-    assert(impl::is_power_of_2(x.size()));
+    const auto N = plan.size();
 
-    const auto f_s      = x.sample_rate();
-    const auto N        = x.size();
-    const auto N_over_2 = N / 2;
+    // The inverse FFT is the conjugate of the FFT of the conjugate
+    std::transform(X, X + N, x, [](const auto& sample) {
+        return std::conj(sample);
+    });
 
-    // The Stockham algorithm requires one vector for input/output data and
-    // another as a temporary workspace
-    signal<std::complex<T>> a(x);
-    signal<std::complex<T>> b(f_s, N);
+    impl::fft(x, x, plan);
 
-    // Set the spacing between twiddle factors used at the first stage
-    auto W_stride = N / 2;
+    std::transform(x, x + N, x, [=](const auto& sample) {
+        return std::conj(sample) / static_cast<T>(N);
+    });
+}
 
-    // Loop through each stage of the FFT
-    for (size_t stride = 1; stride < N; stride *= 2)
+// Calculates the inverse FFTs of B interleaved sequences of N samples, where
+// sample n of sequence i is at X[n * B + i], into x with the same layout
+//
+// The input may be the same as the output. Sequences whose size is not a power
+// of 2 are transformed one at a time, which gains nothing over transforming
+// them separately.
+template <typename T>
+void batched_inverse_fft(const std::complex<T>* X,
+                         std::complex<T>*       x,
+                         const size_t           B,
+                         const fft_plan<T>&     plan)
+{
+    const auto N = plan.size();
+
+    // A single sequence is transformed faster by the loops over its samples
+    if (B == 1)
     {
-        // Loop through the individual FFTs of each stage
-        for (size_t m = 0; m < N_over_2; m += stride)
-        {
-            const auto m_times_2 = m * 2;
+        impl::inverse_fft(X, x, plan);
+        return;
+    }
 
-            // Perform each individual FFT
-            for (size_t n = 0; n < stride; ++n)
-            {
-                // Calculate the input indexes
-                const auto a_index_1 = n + m;
-                const auto a_index_2 = a_index_1 + N_over_2;
+    // The inverse FFT is the conjugate of the FFT of the conjugate
+    std::transform(X, X + N * B, x, [](const auto& sample) {
+        return std::conj(sample);
+    });
 
-                // Calculate the output indexes
-                const auto b_index_1 = n + m_times_2;
-                const auto b_index_2 = b_index_1 + stride;
+    scratch_frame frame;
+    if (impl::is_power_of_2(N))
+    {
+        auto* const work = frame.allocate<std::complex<T>>(N * B);
+        impl::batched_stockham_fft(x, x, work, plan.twiddle_factors(), N, B);
+    }
+    else
+    {
+        auto* const x_i = frame.allocate<std::complex<T>>(N);
+        for (size_t i = 0; i < B; ++i)
+        {
+            for (size_t n = 0; n < N; ++n)
+            {
+                x_i[n] = x[n * B + i];
+            }
 
-                // Perform the FFT
-                const auto tmp1 = a[a_index_1];
-                const auto tmp2 = W[n * W_stride] * a[a_index_2];
+            impl::fft(x_i, x_i, plan);
 
-                // Sum the results
-                b[b_index_1] = tmp1 + tmp2;
-                b[b_index_2] = tmp1 - tmp2;  // (>*.*)> symmetry! <(*.*<)
+            for (size_t n = 0; n < N; ++n)
+            {
+                x[n * B + i] = x_i[n];
             }
         }
-
-        // Spacing between twiddle factors is half for the next stage
-        W_stride /= 2;
-
-        // Swap the data (output of this stage is input of the next)
-        swap(a, b);
     }
 
-    return a;
+    std::transform(x, x + N * B, x, [=](const auto& sample) {
+        return std::conj(sample) / static_cast<T>(N);
+    });
 }
 
 }  // namespace tnt::dsp::impl
@@ -0,0 +1,229 @@
+#pragma once
+
+#include "../aligned_allocator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+namespace tnt::dsp::impl
+{
+
+// Number of phasors that are rotated side by side (one cache line of each of
+// the real and imaginary parts). Each phasor produces every L-th sample, so
+// all of them are advanced by the same rotation in one vectorizable loop.
+template <typename T>
+inline constexpr size_t oscillator_lanes = cache_line_size / sizeof(T);
+
+// Number of rotations between reseeds of the phasors. Every rotation adds a
+// little rounding error to both the magnitude and the phase, so the phasors are
+// periodically reset to the exact values, which bounds the drift. Double
+// precision drifts slowly enough that the (costly) reseeds can be rarer.
+template <typename T>
+inline constexpr size_t oscillator_reseed_interval = std::is_same_v<T, float> ? 64 : 1024;
+
+// Bank of phasors that produces cos(phase + n * omega) and sin(phase + n * omega)
+//
+// Rather than calling std::cos and std::sin for every sample, the samples are
+// generated by rotating phasors (a complex multiplication per sample). The
+// rotation and the seeds are calculated in double precision. Samples can be
+// generated in several calls, and the bank carries on from where the previous
+// call left off as long as that call ended on a whole number of lanes.
+template <typename T>
+class phasor_bank final
+{
+public:
+    static constexpr size_t lanes = oscillator_lanes<T>;
+
+    phasor_bank(const double phase, const double omega)
+        : m_phase(phase)
+        , m_omega(omega)
+        , m_c(static_cast<T>(std::cos(omega * lanes)))
+        , m_s(static_cast<T>(std::sin(omega * lanes)))
+    {
+        this->seed(0);
+    }
+
+    double phase() const
+    {
+        return m_phase;
+    }
+
+    double omega() const
+    {
+        return m_omega;
+    }
+
+    // Calls store(n, cos, sin) for each first <= n < first + count
+    template <typename Store>
+    void generate(const size_t first, const size_t count, const Store& store)
+    {
+        constexpr auto L = lanes;
+
+        if (first != m_next)
+        {
+            this->seed(first);
+        }
+
+        // The phasors are copied into local arrays so that the stores cannot
+        // alias them, which keeps both loops vectorizable
+        alignas(cache_line_size) T re[L];
+        alignas(cache_line_size) T im[L];
+        std::copy(m_re, m_re + L, re);
+        std::copy(m_im, m_im + L, im);
+
+        const auto end = first + count;
+
+        auto n = first;
+        for (; n + L <= end; n += L)
+        {
+            if (m_rotations == oscillator_reseed_interval<T>)
+            {
+                this->seed(n);
+                std::copy(m_re, m_re + L, re);
+                std::copy(m_im, m_im + L, im);
+            }
+
+            for (size_t k = 0; k < L; ++k)
+            {
+                store(n + k, re[k], im[k]);
+            }
+
+            for (size_t k = 0; k < L; ++k)
+            {
+                const auto re_k = re[k] * m_c - im[k] * m_s;
+                const auto im_k = re[k] * m_s + im[k] * m_c;
+
+                re[k] = re_k;
+                im[k] = im_k;
+            }
+
+            ++m_rotations;
+        }
+
+        if (n < end && m_rotations == oscillator_reseed_interval<T>)
+        {
+            this->seed(n);
+            std::copy(m_re, m_re + L, re);
+            std::copy(m_im, m_im + L, im);
+        }
+
+        // A partial block of lanes is not rotated, so the next call has to
+        // reseed unless it repeats these samples
+        for (size_t k = 0; n + k < end; ++k)
+        {
+            store(n + k, re[k], im[k]);
+        }
+
+        std::copy(re, re + L, m_re);
+        std::copy(im, im + L, m_im);
+        m_next = n;
+    }
+
+private:
+    // Sets the phasors to the exact values of samples n to n + L - 1
+    void seed(const size_t n)
+    {
+        for (size_t k = 0; k < lanes; ++k)
+        {
+            const auto theta = m_phase + m_omega * static_cast<double>(n + k);
+
+            m_re[k] = static_cast<T>(std::cos(theta));
+            m_im[k] = static_cast<T>(std::sin(theta));
+        }
+
+        m_next      = n;
+        m_rotations = 0;
+    }
+
+    double m_phase;
+    double m_omega;
+    T      m_c;
+    T      m_s;
+    size_t m_next;
+    size_t m_rotations;
+
+    alignas(cache_line_size) T m_re[lanes];
+    alignas(cache_line_size) T m_im[lanes];
+};
+
+// Calls store(n, cos(phase + n * omega), sin(phase + n * omega)) for each
+// 0 <= n < count
+template <typename T, typename Store>
+void oscillate(const double phase, const double omega, const size_t count, const Store& store)
+{
+    phasor_bank<T>(phase, omega).generate(0, count, store);
+}
+
+// Calls store(n, cos(theta(n)), sin(theta(n))) for each 0 <= n < count, where
+// theta(n) = phase + omega * n + delta * n^2 / 2 (a linear sweep of the phase
+// advance, starting at omega + delta / 2)
+//
+// Works the same way as oscillate(), except that the rotation of each phasor
+// changes by the same amount every step, so it is rotated as well.
+template <typename T, typename Store>
+void sweep(const double phase,
+           const double omega,
+           const double delta,
+           const size_t count,
+           const Store& store)
+{
+    constexpr auto L = oscillator_lanes<T>;
+    constexpr auto R = oscillator_reseed_interval<T> * L;
+
+    alignas(cache_line_size) T re[L];
+    alignas(cache_line_size) T im[L];
+    alignas(cache_line_size) T w_re[L];
+    alignas(cache_line_size) T w_im[L];
+
+    // Change in the rotation of every phasor from one step to the next
+    const auto d_re = static_cast<T>(std::cos(delta * L * L));
+    const auto d_im = static_cast<T>(std::sin(delta * L * L));
+
+    for (size_t n_0 = 0; n_0 < count; n_0 += R)
+    {
+        for (size_t k = 0; k < L; ++k)
+        {
+            const auto n     = static_cast<double>(n_0 + k);
+            const auto theta = phase + omega * n + delta * n * n / 2;
+            const auto step  = omega * L + delta * L * (2 * n + L) / 2;
+
+            re[k]   = static_cast<T>(std::cos(theta));
+            im[k]   = static_cast<T>(std::sin(theta));
+            w_re[k] = static_cast<T>(std::cos(step));
+            w_im[k] = static_cast<T>(std::sin(step));
+        }
+
+        const auto end = std::min(count, n_0 + R);
+
+        auto n = n_0;
+        for (; n + L <= end; n += L)
+        {
+            for (size_t k = 0; k < L; ++k)
+            {
+                store(n + k, re[k], im[k]);
+            }
+
+            for (size_t k = 0; k < L; ++k)
+            {
+                const auto re_k   = re[k] * w_re[k] - im[k] * w_im[k];
+                const auto im_k   = re[k] * w_im[k] + im[k] * w_re[k];
+                const auto w_re_k = w_re[k] * d_re - w_im[k] * d_im;
+                const auto w_im_k = w_re[k] * d_im + w_im[k] * d_re;
+
+                re[k]   = re_k;
+                im[k]   = im_k;
+                w_re[k] = w_re_k;
+                w_im[k] = w_im_k;
+            }
+        }
+
+        for (size_t k = 0; n + k < end; ++k)
+        {
+            store(n + k, re[k], im[k]);
+        }
+    }
+}
+
+}  // namespace tnt::dsp::impl
@@ -0,0 +1,278 @@
+#pragma once
+
+#include "../aligned_allocator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace tnt::dsp::impl
+{
+
+// Expands a seed into a sequence of well mixed 64-bit values (used to fill
+// the xoshiro state, which must not be all zeros)
+inline uint64_t splitmix64(uint64_t& x)
+{
+    auto z = (x += 0x9e3779b97f4a7c15);
+    z      = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z      = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+
+    return z ^ (z >> 31);
+}
+
+constexpr uint64_t rotl(const uint64_t x, const int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+// xoshiro256++ (Blackman and Vigna), a small and fast generator with a period
+// of 2^256 - 1 that can jump ahead to split its sequence into streams
+class xoshiro256 final
+{
+public:
+    explicit xoshiro256(uint64_t seed)
+    {
+        for (auto& s : m_s)
+        {
+            s = splitmix64(seed);
+        }
+    }
+
+    uint64_t operator()()
+    {
+        const auto result = rotl(m_s[0] + m_s[3], 23) + m_s[0];
+        const auto t      = m_s[1] << 17;
+
+        m_s[2] ^= m_s[0];
+        m_s[3] ^= m_s[1];
+        m_s[1] ^= m_s[2];
+        m_s[0] ^= m_s[3];
+        m_s[2] ^= t;
+        m_s[3]  = rotl(m_s[3], 45);
+
+        return result;
+    }
+
+    // Advances the state by 2^128 values
+    void jump()
+    {
+        constexpr uint64_t polynomial[] = {
+            0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c};
+
+        this->advance(polynomial);
+    }
+
+    // Advances the state by 2^192 values
+    void long_jump()
+    {
+        constexpr uint64_t polynomial[] = {
+            0x76e15d3efefdcbbf, 0xc5004e441c522fb3, 0x77710069854ee241, 0x39109bb02acbe635};
+
+        this->advance(polynomial);
+    }
+
+    uint64_t state(const size_t i) const
+    {
+        return m_s[i];
+    }
+
+private:
+    void advance(const uint64_t (&polynomial)[4])
+    {
+        uint64_t s[4] = {};
+        for (const auto& word : polynomial)
+        {
+            for (int b = 0; b < 64; ++b)
+            {
+                if (word & (uint64_t(1) << b))
+                {
+                    for (size_t i = 0; i < 4; ++i)
+                    {
+                        s[i] ^= m_s[i];
+                    }
+                }
+
+                (*this)();
+            }
+        }
+
+        for (size_t i = 0; i < 4; ++i)
+        {
+            m_s[i] = s[i];
+        }
+    }
+
+    uint64_t m_s[4];
+};
+
+// Number of generators that are advanced side by side (two cache lines of
+// state words, which is also enough work per call that compilers vectorize the
+// loop instead of unrolling it)
+inline constexpr size_t random_lanes = 2 * cache_line_size / sizeof(uint64_t);
+
+// A set of xoshiro256++ generators stored lane by lane so that advancing all
+// of them is one vectorizable loop. The generators are 2^128 values apart in
+// the same sequence, and each stream starts 2^192 values after the previous
+// one, so no two lanes or streams ever overlap.
+class random_lanes_generator final
+{
+public:
+    random_lanes_generator(const uint64_t seed, const uint64_t stream)
+    {
+        xoshiro256 g(seed);
+        for (uint64_t s = 0; s < stream; ++s)
+        {
+            g.long_jump();
+        }
+
+        for (size_t k = 0; k < random_lanes; ++k)
+        {
+            m_s0[k] = g.state(0);
+            m_s1[k] = g.state(1);
+            m_s2[k] = g.state(2);
+            m_s3[k] = g.state(3);
+
+            g.jump();
+        }
+    }
+
+    // Advances every lane and returns their next values. The values are kept
+    // in the generator since writing them through an outside pointer (which
+    // might alias the state) could keep the loop from vectorizing.
+    const uint64_t* operator()()
+    {
+        for (size_t k = 0; k < random_lanes; ++k)
+        {
+            m_x[k] = rotl(m_s0[k] + m_s3[k], 23) + m_s0[k];
+
+            const auto t = m_s1[k] << 17;
+
+            m_s2[k] ^= m_s0[k];
+            m_s3[k] ^= m_s1[k];
+            m_s1[k] ^= m_s2[k];
+            m_s0[k] ^= m_s3[k];
+            m_s2[k] ^= t;
+            m_s3[k]  = rotl(m_s3[k], 45);
+        }
+
+        return m_x;
+    }
+
+private:
+    alignas(cache_line_size) uint64_t m_s0[random_lanes];
+    alignas(cache_line_size) uint64_t m_s1[random_lanes];
+    alignas(cache_line_size) uint64_t m_s2[random_lanes];
+    alignas(cache_line_size) uint64_t m_s3[random_lanes];
+    alignas(cache_line_size) uint64_t m_x[random_lanes];
+};
+
+// Maps random bits to a uniform value in [0, 1)
+//
+// The high bits are placed in the mantissa of a number in [1, 2), which is
+// then shifted down. Unlike an integer to floating point conversion this only
+// needs integer operations, so it vectorizes on every instruction set.
+template <typename T>
+T to_unit_interval(const uint64_t x)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        const auto bits = static_cast<uint32_t>(x >> 41) | 0x3f800000;
+
+        float u;
+        std::memcpy(&u, &bits, sizeof(u));
+
+        return u - 1;
+    }
+    else
+    {
+        const auto bits = (x >> 12) | 0x3ff0000000000000;
+
+        double u;
+        std::memcpy(&u, &bits, sizeof(u));
+
+        return static_cast<T>(u - 1);
+    }
+}
+
+// Calls store(n, u) with uniform values u in [0, 1) for each 0 <= n < count
+template <typename T, typename Store>
+void uniform_noise(const uint64_t seed,
+                   const uint64_t stream,
+                   const size_t   count,
+                   const Store&   store)
+{
+    constexpr auto L = random_lanes;
+
+    random_lanes_generator g(seed, stream);
+
+    size_t n = 0;
+    for (; n + L <= count; n += L)
+    {
+        const auto* const x = g();
+
+        for (size_t k = 0; k < L; ++k)
+        {
+            store(n + k, to_unit_interval<T>(x[k]));
+        }
+    }
+
+    if (n < count)
+    {
+        const auto* const x = g();
+
+        for (size_t k = 0; n + k < count; ++k)
+        {
+            store(n + k, to_unit_interval<T>(x[k]));
+        }
+    }
+}
+
+// Calls store(n, z) with standard normal values z for each 0 <= n < count
+//
+// Uses the Box-Muller transform on whole lanes at a time: every pair of
+// uniform draws gives two normal values, one for each half of a block of 2L
+// samples.
+template <typename T, typename Store>
+void gaussian_noise(const uint64_t seed,
+                    const uint64_t stream,
+                    const size_t   count,
+                    const Store&   store)
+{
+    constexpr auto L = random_lanes;
+
+    random_lanes_generator g(seed, stream);
+
+    alignas(cache_line_size) T u_1[L];
+    alignas(cache_line_size) T re[L];
+    alignas(cache_line_size) T im[L];
+    for (size_t n = 0; n < count; n += 2 * L)
+    {
+        const auto* const x_1 = g();
+        for (size_t k = 0; k < L; ++k)
+        {
+            u_1[k] = to_unit_interval<T>(x_1[k]);
+        }
+
+        const auto* const x_2 = g();
+        for (size_t k = 0; k < L; ++k)
+        {
+            // 1 - u is in (0, 1], so the logarithm is finite
+            const auto r     = std::sqrt(-2 * std::log(1 - u_1[k]));
+            const auto theta = 2 * static_cast<T>(M_PI) * to_unit_interval<T>(x_2[k]);
+
+            re[k] = r * std::cos(theta);
+            im[k] = r * std::sin(theta);
+        }
+
+        const auto lanes = std::min(2 * L, count - n);
+        for (size_t k = 0; k < lanes; ++k)
+        {
+            store(n + k, k < L ? re[k] : im[k - L]);
+        }
+    }
+}
+
+}  // namespace tnt::dsp::impl
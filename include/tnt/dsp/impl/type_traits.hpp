@@ -0,0 +1,36 @@
+#pragma once
+
+#include <complex>
+#include <type_traits>
+
+namespace tnt::dsp::impl
+{
+
+template <typename T>
+struct is_complex : std::false_type
+{};
+
+template <typename T>
+struct is_complex<std::complex<T>> : std::true_type
+{};
+
+template <typename T>
+constexpr bool is_complex_v = is_complex<std::remove_cv_t<T>>::value;
+
+// Underlying real type of a (possibly complex) sample type
+template <typename T>
+struct real_type
+{
+    using type = T;
+};
+
+template <typename T>
+struct real_type<std::complex<T>>
+{
+    using type = T;
+};
+
+template <typename T>
+using real_type_t = typename real_type<std::remove_cv_t<T>>::type;
+
+}  // namespace tnt::dsp::impl
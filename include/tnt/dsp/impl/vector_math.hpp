@@ -0,0 +1,311 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace tnt::dsp::impl
+{
+
+// Branch-free versions of library functions for use inside loops over
+// samples. The library versions are calls that compilers cannot vectorize,
+// whereas these are plain arithmetic, comparisons and bit manipulation (with
+// comparisons only ever selecting between values), so loops that use them
+// vectorize like any other arithmetic.
+//
+// The vector_ functions use the approximations of the Cephes library, which
+// are within a few units in the last place over the ranges they are reduced
+// to, and handle the whole domain of the library functions: 0, subnormal
+// values and infinity give the same results as the library, and NaN is passed
+// through. The fast_ functions use shorter approximations with the error
+// bounds stated for each, over the same domain. All of them are declared
+// inline so that compilers inline them into the loops even though they are
+// fairly long.
+
+// Splits a positive, finite x into x = m * 2^e with m in [sqrt(1/2), sqrt(2))
+// and returns m, with e written as a floating point value
+template <typename T>
+inline T split_exponent(T x, T& e)
+{
+    // The exponent bits of subnormal values do not hold their exponent, so they
+    // are scaled by 2^k into the normal range first
+    constexpr int k = std::is_same_v<T, float> ? 64 : 128;
+
+    const auto subnormal = x < std::numeric_limits<T>::min();
+    const auto k_x       = subnormal ? k : 0;
+
+    x = subnormal ? x * static_cast<T>(k == 64 ? 0x1p64 : 0x1p128) : x;
+
+    if constexpr (std::is_same_v<T, float>)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+
+        // The biased exponent is placed in the mantissa of 2^23 so that it
+        // is converted to floating point with integer operations only
+        const uint32_t e_bits = 0x4b000000 | (bits >> 23);
+        const uint32_t m_bits = (bits & 0x007fffff) | 0x3f000000;
+
+        T e_biased;
+        T m;
+        std::memcpy(&e_biased, &e_bits, sizeof(e_biased));
+        std::memcpy(&m, &m_bits, sizeof(m));
+
+        // m is in [1/2, 1) at this point
+        const auto low = m < static_cast<T>(M_SQRT1_2);
+
+        e = e_biased - (8388608 + 126) - (low ? 1 : 0) - k_x;
+        return low ? m + m : m;
+    }
+    else
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+
+        const uint64_t e_bits = 0x4330000000000000 | (bits >> 52);
+        const uint64_t m_bits = (bits & 0x000fffffffffffff) | 0x3fe0000000000000;
+
+        T e_biased;
+        T m;
+        std::memcpy(&e_biased, &e_bits, sizeof(e_biased));
+        std::memcpy(&m, &m_bits, sizeof(m));
+
+        const auto low = m < M_SQRT1_2;
+
+        e = e_biased - (4503599627370496.0 + 1022) - (low ? 1 : 0) - k_x;
+        return low ? m + m : m;
+    }
+}
+
+// Calculates the square root of a non-negative x with the given number of
+// refinement steps
+//
+// std::sqrt only vectorizes when errno is not set, which is up to the compiler
+// flags. Instead the reciprocal square root is estimated from the bits of x
+// (halving the exponent) and refined with Newton's method, which needs
+// multiplications only and doubles the number of correct bits every step. The
+// estimate is within 4%, so the relative error is below 2e-3 after one step,
+// 5e-6 after two, 3e-11 after three and rounding error after four.
+//
+// The estimate needs the exponent bits of a normal value, so subnormal x are
+// scaled by an even power of 2 first, which the square root halves. 0 needs
+// no special case (the estimate stays finite and x * r is 0), but the steps
+// give NaN for infinity, so infinity and NaN are returned as they are.
+template <int Steps, typename T>
+inline T newton_sqrt(const T x)
+{
+    constexpr auto is_float = std::is_same_v<T, float>;
+
+    const auto subnormal = x < std::numeric_limits<T>::min();
+    const auto x_s       = subnormal ? x * static_cast<T>(is_float ? 0x1p64 : 0x1p128) : x;
+
+    T r;
+    if constexpr (is_float)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &x_s, sizeof(bits));
+        bits = 0x5f3759df - (bits >> 1);
+        std::memcpy(&r, &bits, sizeof(r));
+    }
+    else
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &x_s, sizeof(bits));
+        bits = 0x5fe6eb50c7b537a9 - (bits >> 1);
+        std::memcpy(&r, &bits, sizeof(r));
+    }
+
+    for (int i = 0; i < Steps; ++i)
+    {
+        r = r * (static_cast<T>(1.5) - static_cast<T>(0.5) * x_s * r * r);
+    }
+
+    const auto root = x_s * r * (subnormal ? static_cast<T>(is_float ? 0x1p-32 : 0x1p-64) : 1);
+
+    return x <= std::numeric_limits<T>::max() ? root : x;
+}
+
+// Calculates the square root of a non-negative x
+template <typename T>
+inline T vector_sqrt(const T x)
+{
+    return newton_sqrt<std::is_same_v<T, float> ? 3 : 4>(x);
+}
+
+// Calculates the square root of a non-negative x with a relative error below
+// 5e-6
+template <typename T>
+inline T fast_sqrt(const T x)
+{
+    return newton_sqrt<2>(x);
+}
+
+// Returns y, the logarithm of a positive, finite x, or the logarithm of x if
+// it is 0, infinity or NaN, which the approximations do not cover
+template <typename T>
+inline T log_special_cases(const T x, const T y)
+{
+    const auto special = x == 0 ? -std::numeric_limits<T>::infinity() : x;
+
+    return x > 0 && x <= std::numeric_limits<T>::max() ? y : special;
+}
+
+// Calculates the natural logarithm of a non-negative x
+template <typename T>
+inline T vector_log(const T x)
+{
+    T    e;
+    auto m = split_exponent(x, e) - 1;
+
+    const auto z = m * m;
+
+    T y;
+    if constexpr (std::is_same_v<T, float>)
+    {
+        y = static_cast<T>(7.0376836292e-2);
+        y = y * m - static_cast<T>(1.1514610310e-1);
+        y = y * m + static_cast<T>(1.1676998740e-1);
+        y = y * m - static_cast<T>(1.2420140846e-1);
+        y = y * m + static_cast<T>(1.4249322787e-1);
+        y = y * m - static_cast<T>(1.6668057665e-1);
+        y = y * m + static_cast<T>(2.0000714765e-1);
+        y = y * m - static_cast<T>(2.4999993993e-1);
+        y = y * m + static_cast<T>(3.3333331174e-1);
+        y = y * m * z;
+    }
+    else
+    {
+        auto p = 1.01875663804580931796e-4;
+        p      = p * m + 4.97494994976747001425e-1;
+        p      = p * m + 4.70579119878881725854e0;
+        p      = p * m + 1.44989225341610930846e1;
+        p      = p * m + 1.79368678507819816313e1;
+        p      = p * m + 7.70838733755885391666e0;
+
+        auto q = m + 1.12873587189167450590e1;
+        q      = q * m + 4.52279145837532221105e1;
+        q      = q * m + 8.29875266912776603211e1;
+        q      = q * m + 7.11544750618563894466e1;
+        q      = q * m + 2.31251620126765340583e1;
+
+        y = m * (z * p / q);
+    }
+
+    // ln(2) is split in two so that e * ln(2) is added without rounding error
+    y -= e * static_cast<T>(2.121944400546905827679e-4);
+    y -= z / 2;
+
+    return log_special_cases(x, m + y + e * static_cast<T>(0.693359375));
+}
+
+// Maps r = atan(lo / hi), where lo and hi are the smaller and larger of |x| and
+// |y|, to atan2(y, x)
+template <typename T>
+inline T unfold_angle(T r, const T y, const T x)
+{
+    constexpr auto pi = static_cast<T>(M_PI);
+
+    r = std::abs(y) > std::abs(x) ? pi / 2 - r : r;
+    r = x < 0 ? pi - r : r;
+
+    return y < 0 ? -r : r;
+}
+
+// Calculates atan2(y, x), treating zeros of either sign as positive
+template <typename T>
+inline T vector_atan2(const T y, const T x)
+{
+    const auto a_x = std::abs(x);
+    const auto a_y = std::abs(y);
+    const auto lo  = std::min(a_x, a_y);
+    const auto hi  = std::max(a_x, a_y);
+
+    // atan(lo / hi) is in [0, pi/4]. Larger ratios are reduced with
+    // atan(r) = pi/4 + atan((r - 1) / (r + 1)) to keep the polynomial short.
+    const auto threshold = static_cast<T>(std::is_same_v<T, float> ? 0.4142135623730950 : 0.66);
+    const auto reduce    = lo > threshold * hi;
+
+    // lo + hi overflows when both are close to the largest value, in which
+    // case the numerator and denominator are both halved (which is exact)
+    const auto h = static_cast<T>(hi > std::numeric_limits<T>::max() / 4 ? 0.5 : 1);
+    const auto t = (reduce ? (lo - hi) * h : lo) / (reduce ? lo * h + hi * h : (hi > 0 ? hi : 1));
+    const auto z = t * t;
+
+    T r;
+    if constexpr (std::is_same_v<T, float>)
+    {
+        r = static_cast<T>(8.05374449538e-2);
+        r = r * z - static_cast<T>(1.38776856032e-1);
+        r = r * z + static_cast<T>(1.99777106478e-1);
+        r = r * z - static_cast<T>(3.33329491539e-1);
+        r = r * z * t + t;
+    }
+    else
+    {
+        auto p = -8.750608600031904122785e-1;
+        p      = p * z - 1.615753718733365076637e1;
+        p      = p * z - 7.500855792314704667340e1;
+        p      = p * z - 1.228866684490136173410e2;
+        p      = p * z - 6.485021904942025371773e1;
+
+        auto q = z + 2.485846490142306297962e1;
+        q      = q * z + 1.650270098316988542046e2;
+        q      = q * z + 4.328810604912902668951e2;
+        q      = q * z + 4.853903996359136964868e2;
+        q      = q * z + 1.945506571482613964425e2;
+
+        r = t + t * (z * p / q);
+    }
+
+    return unfold_angle((reduce ? static_cast<T>(M_PI / 4) : 0) + r, y, x);
+}
+
+// Calculates the natural logarithm of a non-negative x with an absolute error
+// below 2e-5
+//
+// Uses a polynomial fitted to ln(1 + f) over the same range of f as
+// vector_log(), short enough that it is cheaper than a division.
+template <typename T>
+inline T fast_log(const T x)
+{
+    T          e;
+    const auto f = split_exponent(x, e) - 1;
+
+    auto p = static_cast<T>(0.1680138222783873);
+    p      = p * f - static_cast<T>(0.2720358907187557);
+    p      = p * f + static_cast<T>(0.3384127495049752);
+    p      = p * f - static_cast<T>(0.4993439143281653);
+    p      = p * f + static_cast<T>(0.9998797755592773);
+
+    return log_special_cases(x, p * f + e * static_cast<T>(M_LN2));
+}
+
+// Calculates atan2(y, x) with an absolute error below 1.2e-5, treating zeros
+// of either sign as positive
+//
+// Uses the polynomial of Abramowitz and Stegun (4.4.47) for atan(t) with t in
+// [0, 1], which needs no further range reduction.
+template <typename T>
+inline T fast_atan2(const T y, const T x)
+{
+    const auto a_x = std::abs(x);
+    const auto a_y = std::abs(y);
+    const auto lo  = std::min(a_x, a_y);
+    const auto hi  = std::max(a_x, a_y);
+
+    const auto t = lo / (hi > 0 ? hi : 1);
+    const auto z = t * t;
+
+    auto r = static_cast<T>(0.0208351);
+    r      = r * z - static_cast<T>(0.0851330);
+    r      = r * z + static_cast<T>(0.1801410);
+    r      = r * z - static_cast<T>(0.3302995);
+    r      = r * z + static_cast<T>(0.9998660);
+
+    return unfold_angle(r * t, y, x);
+}
+
+}  // namespace tnt::dsp::impl
@@ -0,0 +1,237 @@
+#pragma once
+
+#include "../aligned_allocator.hpp"
+#include "type_traits.hpp"
+
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+
+namespace tnt::dsp::impl
+{
+
+// Calls f with the given pointers, marked as cache line aligned if they all
+// are so that the vectorized loops in f can skip their unaligned prologue.
+// Signals are cache line aligned by default, so whole-signal operations
+// usually take the aligned path.
+template <typename F, typename... P>
+void with_alignment(const F& f, P*... p)
+{
+    if ((is_aligned(p) && ...))
+    {
+        f(assume_aligned(p)...);
+    }
+    else
+    {
+        f(p...);
+    }
+}
+
+// Calculates y[n] += s * x[n] for 0 <= n < N
+//
+// Complex data is processed as interleaved real/imaginary pairs so that the
+// compiler is free to vectorize the loops (std::complex multiplication is not
+// vectorized due to its NaN/infinity handling).
+template <typename R, typename A, typename S>
+void multiply_accumulate(R* y, const A* x, const S& s, const size_t N)
+{
+    with_alignment(
+        [&](R* y, const A* x) {
+            if constexpr (!is_complex_v<R>)
+            {
+                for (size_t n = 0; n < N; ++n)
+                {
+                    y[n] += s * x[n];
+                }
+            }
+            else
+            {
+                using T = real_type_t<R>;
+
+                auto* y_p = reinterpret_cast<T*>(y);
+
+                if constexpr (!is_complex_v<A>)
+                {
+                    // Real data scaled by a complex coefficient
+                    const T s_r = std::real(s);
+                    const T s_i = std::imag(s);
+                    for (size_t n = 0; n < N; ++n)
+                    {
+                        y_p[2 * n] += s_r * x[n];
+                        y_p[2 * n + 1] += s_i * x[n];
+                    }
+                }
+                else if constexpr (!is_complex_v<S>)
+                {
+                    // Complex data scaled by a real coefficient
+                    const auto* x_p = reinterpret_cast<const T*>(x);
+                    for (size_t n = 0; n < 2 * N; ++n)
+                    {
+                        y_p[n] += s * x_p[n];
+                    }
+                }
+                else
+                {
+                    const auto* x_p = reinterpret_cast<const T*>(x);
+                    const T     s_r = s.real();
+                    const T     s_i = s.imag();
+                    for (size_t n = 0; n < N; ++n)
+                    {
+                        const auto x_r = x_p[2 * n];
+                        const auto x_i = x_p[2 * n + 1];
+
+                        y_p[2 * n] += s_r * x_r - s_i * x_i;
+                        y_p[2 * n + 1] += s_r * x_i + s_i * x_r;
+                    }
+                }
+            }
+        },
+        y,
+        x);
+}
+
+// Calculates y[n] += a[n] * b[n] for 0 <= n < N
+//
+// Complex data is processed as interleaved real/imaginary pairs for the same
+// reason as multiply_accumulate.
+template <typename T>
+void product_accumulate(std::complex<T>*       y,
+                        const std::complex<T>* a,
+                        const std::complex<T>* b,
+                        const size_t           N)
+{
+    with_alignment(
+        [N](T* y_p, const T* a_p, const T* b_p) {
+            for (size_t n = 0; n < N; ++n)
+            {
+                const auto a_r = a_p[2 * n];
+                const auto a_i = a_p[2 * n + 1];
+                const auto b_r = b_p[2 * n];
+                const auto b_i = b_p[2 * n + 1];
+
+                y_p[2 * n] += a_r * b_r - a_i * b_i;
+                y_p[2 * n + 1] += a_r * b_i + a_i * b_r;
+            }
+        },
+        reinterpret_cast<T*>(y),
+        reinterpret_cast<const T*>(a),
+        reinterpret_cast<const T*>(b));
+}
+
+// Transposes the rows x columns matrix a into b, so that
+// b[c * b_stride + r] = a[r * a_stride + c]. The matrix is processed in
+// square blocks so that the reads and the writes of each block stay within a
+// few cache lines.
+template <typename T>
+void transpose(const T*     a,
+               const size_t a_stride,
+               T*           b,
+               const size_t b_stride,
+               const size_t rows,
+               const size_t columns)
+{
+    constexpr size_t block = std::max<size_t>(4, cache_line_size / sizeof(T));
+
+    for (size_t r_0 = 0; r_0 < rows; r_0 += block)
+    {
+        const auto r_1 = std::min(rows, r_0 + block);
+        for (size_t c_0 = 0; c_0 < columns; c_0 += block)
+        {
+            const auto c_1 = std::min(columns, c_0 + block);
+            for (size_t c = c_0; c < c_1; ++c)
+            {
+                for (size_t r = r_0; r < r_1; ++r)
+                {
+                    b[c * b_stride + r] = a[r * a_stride + c];
+                }
+            }
+        }
+    }
+}
+
+// Deinterleaves a fixed number of channels. With the channel count known at
+// compile time the compiler turns the loop into vector loads and shuffles.
+template <size_t Channels, typename T>
+void deinterleave(const T* x, const size_t frames, T* y, const size_t y_stride)
+{
+    for (size_t n = 0; n < frames; ++n)
+    {
+        for (size_t c = 0; c < Channels; ++c)
+        {
+            y[c * y_stride + n] = x[n * Channels + c];
+        }
+    }
+}
+
+// Splits interleaved frames x into planar channels y, where channel c starts
+// at y + c * y_stride
+template <typename T>
+void deinterleave(const T*     x,
+                  const size_t channels,
+                  const size_t frames,
+                  T*           y,
+                  const size_t y_stride)
+{
+    switch (channels)
+    {
+        case 1:
+            std::copy(x, x + frames, y);
+            break;
+        case 2:
+            impl::deinterleave<2>(x, frames, y, y_stride);
+            break;
+        case 4:
+            impl::deinterleave<4>(x, frames, y, y_stride);
+            break;
+        case 8:
+            impl::deinterleave<8>(x, frames, y, y_stride);
+            break;
+        default:
+            impl::transpose(x, channels, y, y_stride, frames, channels);
+            break;
+    }
+}
+
+// Interleaves a fixed number of channels (see deinterleave)
+template <size_t Channels, typename T>
+void interleave(const T* x, const size_t x_stride, const size_t frames, T* y)
+{
+    for (size_t n = 0; n < frames; ++n)
+    {
+        for (size_t c = 0; c < Channels; ++c)
+        {
+            y[n * Channels + c] = x[c * x_stride + n];
+        }
+    }
+}
+
+// Merges planar channels x, where channel c starts at x + c * x_stride, into
+// interleaved frames y
+template <typename T>
+void interleave(const T*     x,
+                const size_t x_stride,
+                const size_t channels,
+                const size_t frames,
+                T*           y)
+{
+    switch (channels)
+    {
+        case 1:
+            std::copy(x, x + frames, y);
+            break;
+        case 2:
+            impl::interleave<2>(x, x_stride, frames, y);
+            break;
+        case 4:
+            impl::interleave<4>(x, x_stride, frames, y);
+            break;
+        case 8:
+            impl::interleave<8>(x, x_stride, frames, y);
+            break;
+        default:
+            impl::transpose(x, x_stride, y, channels, channels, frames);
+            break;
+    }
+}
+
+}  // namespace tnt::dsp::impl
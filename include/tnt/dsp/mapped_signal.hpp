@@ -0,0 +1,511 @@
+#pragma once
+
+#include "signal_view.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#if defined(_WIN32)
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <windows.h>
+#else
+#    include <cerrno>
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <unistd.h>
+#endif
+
+namespace tnt::dsp
+{
+
+/*!
+\brief Specifies how the samples of a mapped signal may be accessed
+*/
+enum class map_mode
+{
+    read_only,     //!< Samples can only be read
+    copy_on_write  //!< Samples can be modified without modifying the file
+};
+
+/*!
+\brief Describes how a range of samples is about to be accessed
+*/
+enum class access_hint
+{
+    normal,      //!< No particular access pattern
+    sequential,  //!< Samples will be read in order, so read ahead aggressively
+    random,      //!< Samples will be read in no particular order, so do not read ahead
+    will_need,   //!< Samples will be needed soon, so start reading them now
+    dont_need    //!< Samples will not be needed soon, so their pages can be reclaimed
+};
+
+namespace impl
+{
+
+// Maps a byte range of a file into memory
+class file_mapping final
+{
+public:
+    // Maps the entire remainder of the file when size is npos
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    file_mapping(const std::filesystem::path& path,
+                 const size_t                 offset,
+                 const size_t                 size,
+                 const map_mode               mode)
+    {
+        const auto file_size = std::filesystem::file_size(path);
+        if (offset > file_size || (size != npos && size > file_size - offset))
+        {
+            throw std::out_of_range("mapped range extends past the end of the file");
+        }
+
+        m_size = size == npos ? static_cast<size_t>(file_size - offset) : size;
+        if (m_size == 0)
+        {
+            return;
+        }
+
+        // Mappings have to start on a page (or allocation granularity)
+        // boundary, so map from the boundary below the offset
+#if defined(_WIN32)
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        const size_t granularity = info.dwAllocationGranularity;
+#else
+        const size_t granularity = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+        const auto map_offset = offset / granularity * granularity;
+        m_offset              = offset - map_offset;
+        m_length              = m_size + m_offset;
+
+#if defined(_WIN32)
+        const auto file = CreateFileW(path.c_str(),
+                                      GENERIC_READ,
+                                      FILE_SHARE_READ,
+                                      nullptr,
+                                      OPEN_EXISTING,
+                                      FILE_ATTRIBUTE_NORMAL,
+                                      nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw std::system_error(GetLastError(), std::system_category(), "CreateFileW");
+        }
+
+        const auto protection = mode == map_mode::read_only ? PAGE_READONLY : PAGE_WRITECOPY;
+        const auto mapping    = CreateFileMappingW(file, nullptr, protection, 0, 0, nullptr);
+        const auto error      = GetLastError();
+        CloseHandle(file);
+        if (mapping == nullptr)
+        {
+            throw std::system_error(error, std::system_category(), "CreateFileMappingW");
+        }
+
+        const auto access      = mode == map_mode::read_only ? FILE_MAP_READ : FILE_MAP_COPY;
+        const auto offset_high = static_cast<DWORD>(static_cast<uint64_t>(map_offset) >> 32);
+        const auto offset_low  = static_cast<DWORD>(map_offset & 0xFFFFFFFF);
+
+        m_base                = MapViewOfFile(mapping, access, offset_high, offset_low, m_length);
+        const auto view_error = GetLastError();
+        CloseHandle(mapping);
+        if (m_base == nullptr)
+        {
+            throw std::system_error(view_error, std::system_category(), "MapViewOfFile");
+        }
+#else
+        const auto file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "open");
+        }
+
+        // Private mappings never write back to the file, even when modified
+        const auto protection = mode == map_mode::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+        m_base           = ::mmap(nullptr, m_length, protection, MAP_PRIVATE, file, map_offset);
+        const auto error = errno;
+        ::close(file);
+        if (m_base == MAP_FAILED)
+        {
+            m_base = nullptr;
+            throw std::system_error(error, std::generic_category(), "mmap");
+        }
+#endif
+    }
+
+    file_mapping(const file_mapping&) = delete;
+
+    file_mapping(file_mapping&& other) noexcept
+        : m_base(std::exchange(other.m_base, nullptr))
+        , m_length(std::exchange(other.m_length, 0))
+        , m_offset(std::exchange(other.m_offset, 0))
+        , m_size(std::exchange(other.m_size, 0))
+    {}
+
+    file_mapping& operator=(const file_mapping&) = delete;
+
+    file_mapping& operator=(file_mapping&& other) noexcept
+    {
+        if (this != &other)
+        {
+            this->unmap();
+            m_base   = std::exchange(other.m_base, nullptr);
+            m_length = std::exchange(other.m_length, 0);
+            m_offset = std::exchange(other.m_offset, 0);
+            m_size   = std::exchange(other.m_size, 0);
+        }
+
+        return *this;
+    }
+
+    ~file_mapping()
+    {
+        this->unmap();
+    }
+
+    std::byte* data() const
+    {
+        return m_base == nullptr ? nullptr : static_cast<std::byte*>(m_base) + m_offset;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    // Passes an access hint for bytes [first, first + count) to the kernel.
+    // Hints are advisory, so failures are ignored. Windows has no equivalent
+    // of madvise for mapped files, so hints are ignored there.
+    void advise(const access_hint hint, const size_t first, const size_t count) const
+    {
+        assert(first + count <= m_size);
+
+        if (m_base == nullptr || count == 0)
+        {
+            return;
+        }
+
+#if defined(_WIN32)
+        static_cast<void>(hint);
+#else
+        // Advice has to start on a page boundary
+        const size_t page  = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const auto   begin = (m_offset + first) / page * page;
+        const auto   end   = m_offset + first + count;
+
+        int advice = POSIX_MADV_NORMAL;
+        switch (hint)
+        {
+            case access_hint::normal:
+                advice = POSIX_MADV_NORMAL;
+                break;
+            case access_hint::sequential:
+                advice = POSIX_MADV_SEQUENTIAL;
+                break;
+            case access_hint::random:
+                advice = POSIX_MADV_RANDOM;
+                break;
+            case access_hint::will_need:
+                advice = POSIX_MADV_WILLNEED;
+                break;
+            case access_hint::dont_need:
+                advice = POSIX_MADV_DONTNEED;
+                break;
+        }
+
+        ::posix_madvise(static_cast<std::byte*>(m_base) + begin, end - begin, advice);
+#endif
+    }
+
+private:
+    void unmap()
+    {
+        if (m_base != nullptr)
+        {
+#if defined(_WIN32)
+            UnmapViewOfFile(m_base);
+#else
+            ::munmap(m_base, m_length);
+#endif
+            m_base = nullptr;
+        }
+    }
+
+    void*  m_base   = nullptr;
+    size_t m_length = 0;
+    size_t m_offset = 0;
+    size_t m_size   = 0;
+};
+
+}  // namespace impl
+
+/*!
+\brief Signal whose samples are memory mapped from a file of raw samples
+
+Only the pages that are accessed are read from the file, so captures larger than physical memory
+can be processed without loading them. The samples are never written back to the file: in
+copy-on-write mode modified pages are copied into private memory instead.
+
+Mapped signals have the same sample access and iterator interface as signal. They are passed to the
+transform and analysis functions through view(). The access mode is part of the type, so that
+read-only mappings (whose pages cannot be written) only give constant access to their samples.
+*/
+template <typename T, map_mode Mode = map_mode::read_only>
+class mapped_signal final
+{
+    // Enables the members that give mutable access to the samples
+    template <map_mode M>
+    using if_writable = std::enable_if_t<M == map_mode::copy_on_write, int>;
+
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "Mapped samples must be trivially copyable");
+
+    /*!
+    \brief Constant iterator
+    */
+    using const_iterator = const T*;
+
+    /*!
+    \brief Iterator (constant in read-only mode)
+    */
+    using iterator = std::conditional_t<Mode == map_mode::copy_on_write, T*, const T*>;
+
+    /*!
+    \brief Size type
+    */
+    using size_type = size_t;
+
+    /*!
+    \brief Value type
+    */
+    using value_type = T;
+
+    /*!
+    \brief Constructor
+    \param[in] path Path to a file of raw samples in native byte order
+    \param[in] sample_rate Sample rate
+    \param[in] offset Offset (in bytes) of the first sample in the file
+    \param[in] size Number of samples to map (by default all samples up to the end of the file)
+    */
+    mapped_signal(const std::filesystem::path& path,
+                  const size_t                 sample_rate,
+                  const size_t                 offset = 0,
+                  const size_type&             size   = npos)
+        : m_sample_rate(sample_rate)
+        , m_mapping(path,
+                    offset,
+                    size == npos ? impl::file_mapping::npos : size * sizeof(T),
+                    Mode)
+    {
+        assert(offset % alignof(T) == 0);
+    }
+
+    /*!
+    \brief Move constructor
+    \param[in] signal Mapped signal
+    */
+    mapped_signal(mapped_signal&& signal) = default;
+
+    /*!
+    \brief Move assignment operator
+    \param[in] signal Mapped signal to assign from
+    \return Mapped signal equal to the input
+    */
+    mapped_signal& operator=(mapped_signal&& signal) = default;
+
+    /*!
+    \brief Destructor (unmaps the file)
+    */
+    ~mapped_signal() = default;
+
+    /*!
+    \brief Gets the duration of the signal in seconds
+    \return Duration
+    */
+    double duration() const
+    {
+        return this->size() / static_cast<double>(this->sample_rate());
+    }
+
+    /*!
+    \brief Gets the sample rate
+    \return Sample rate
+    */
+    size_t sample_rate() const
+    {
+        return m_sample_rate;
+    }
+
+    /*!
+    \brief Gets the access mode
+    \return Access mode
+    */
+    static constexpr map_mode mode()
+    {
+        return Mode;
+    }
+
+    /*!
+    \brief Accesses the sample at the specified index
+    \return Constant reference to the requested sample
+    */
+    const value_type& operator[](const size_type& index) const
+    {
+        assert(index < this->size());
+        return this->data()[index];
+    }
+
+    /*!
+    \brief Accesses the sample at the specified index (copy-on-write mode only)
+    \return Reference to the requested sample
+    */
+    template <map_mode M = Mode, if_writable<M> = 0>
+    value_type& operator[](const size_type& index)
+    {
+        assert(index < this->size());
+        return this->data()[index];
+    }
+
+    /*!
+    \brief Gets a pointer to the mapped samples
+    \return Constant pointer to the first sample
+    */
+    const value_type* data() const
+    {
+        return reinterpret_cast<const T*>(m_mapping.data());
+    }
+
+    /*!
+    \brief Gets a pointer to the mapped samples (copy-on-write mode only)
+    \return Pointer to the first sample
+    */
+    template <map_mode M = Mode, if_writable<M> = 0>
+    value_type* data()
+    {
+        return reinterpret_cast<T*>(m_mapping.data());
+    }
+
+    /*!
+    \brief Gets a view of the samples
+    \return View of constant samples
+    */
+    signal_view<const T> view() const
+    {
+        return signal_view<const T>(m_sample_rate, this->data(), this->size());
+    }
+
+    /*!
+    \brief Gets a view of the samples (copy-on-write mode only)
+    \return View of mutable samples
+    */
+    template <map_mode M = Mode, if_writable<M> = 0>
+    signal_view<T> view()
+    {
+        return signal_view<T>(m_sample_rate, this->data(), this->size());
+    }
+
+    /*!
+    \brief Gets an iterator to the beginning of the signal (copy-on-write mode only)
+    \return Iterator to the first sample
+    */
+    template <map_mode M = Mode, if_writable<M> = 0>
+    iterator begin()
+    {
+        return this->data();
+    }
+
+    /*!
+    \brief Gets a constant iterator to the beginning of the signal
+    \return Constant iterator to the first sample
+    */
+    const_iterator begin() const
+    {
+        return this->data();
+    }
+
+    /*!
+    \brief Gets a constant iterator to the beginning of the signal
+    \return Constant iterator to the first sample
+    */
+    const_iterator cbegin() const
+    {
+        return this->data();
+    }
+
+    /*!
+    \brief Gets an iterator to the end of the signal (copy-on-write mode only)
+    \return Iterator to the sample *following* the last sample
+    */
+    template <map_mode M = Mode, if_writable<M> = 0>
+    iterator end()
+    {
+        return this->data() + this->size();
+    }
+
+    /*!
+    \brief Gets a constant iterator to the end of the signal
+    \return Constant iterator to the sample *following* the last sample
+    */
+    const_iterator end() const
+    {
+        return this->data() + this->size();
+    }
+
+    /*!
+    \brief Gets a constant iterator to the end of the signal
+    \return Constant iterator to the sample *following* the last sample
+    */
+    const_iterator cend() const
+    {
+        return this->data() + this->size();
+    }
+
+    /*!
+    \brief Gets the size
+    \return Number of mapped samples
+    */
+    size_type size() const
+    {
+        return m_mapping.size() / sizeof(T);
+    }
+
+    /*!
+    \brief Tells the operating system how the samples are about to be accessed
+    \param[in] hint Expected access pattern
+    */
+    void advise(const access_hint hint) const
+    {
+        m_mapping.advise(hint, 0, m_mapping.size());
+    }
+
+    /*!
+    \brief Tells the operating system how a range of samples is about to be accessed
+    \param[in] hint Expected access pattern
+    \param[in] first Index of the first sample in the range
+    \param[in] count Number of samples in the range
+    */
+    void advise(const access_hint hint, const size_type& first, const size_type& count) const
+    {
+        assert(first + count <= this->size());
+        m_mapping.advise(hint, first * sizeof(T), count * sizeof(T));
+    }
+
+    /*!
+    \brief Maps all samples up to the end of the file
+    */
+    static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+private:
+    size_t             m_sample_rate;
+    impl::file_mapping m_mapping;
+};
+
+}  // namespace tnt::dsp
@@ -0,0 +1,294 @@
+#pragma once
+
+#include "aligned_allocator.hpp"
+#include "fourier_transform.hpp"
+#include "impl/vector_operations.hpp"
+#include "multisignal.hpp"
+#include "signal.hpp"
+#include "thread_pool.hpp"
+#include "workspace.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <complex>
+#include <vector>
+
+namespace tnt::dsp
+{
+
+/*!
+\brief Convolves multi-channel signals with a matrix of filters
+
+Each output channel is the sum of every input channel convolved with the filter connecting that
+input to that output. Convolutions are circular and defined the same way as convolve().
+
+The filter spectra are calculated once on construction and stored contiguously, output by output,
+so that the frequency domain multiply-accumulate streams through memory. Each spectrum starts on a
+cache line so the multiply-accumulate can use aligned loads. Since all signals are real only the
+non-negative frequencies are stored and accumulated. Each input channel is transformed once and
+each output channel is inverse transformed once, two channels per FFT.
+*/
+template <typename T>
+class mimo_convolver final
+{
+public:
+    /*!
+    \brief Size type
+    */
+    using size_type = size_t;
+
+    /*!
+    \brief Constructor
+
+    Filters shorter than the block size are padded with zeros.
+
+    \param[in] filters Filter matrix indexed by [output][input]
+    \param[in] block_size Size of the input blocks (at least 1)
+    */
+    mimo_convolver(const std::vector<std::vector<signal<T>>>& filters, const size_type& block_size)
+        : m_sample_rate(filters.empty() || filters.front().empty()
+                            ? 0
+                            : filters.front().front().sample_rate())
+        , m_block_size(block_size)
+        , m_bins(block_size / 2 + 1)
+        , m_stride(aligned_stride(m_bins))
+        , m_outputs(filters.size())
+        , m_inputs(filters.empty() ? 0 : filters.front().size())
+        , m_spectra(m_outputs * m_inputs * m_stride)
+    {
+        // A block size of 0 would still have one frequency bin
+        assert(block_size > 0);
+
+        for (size_type o = 0; o < m_outputs; ++o)
+        {
+            assert(filters[o].size() == m_inputs);
+
+            for (size_type i = 0; i < m_inputs; ++i)
+            {
+                const auto& h = filters[o][i];
+
+                assert(h.sample_rate() == m_sample_rate);
+                assert(h.size() <= m_block_size);
+
+                signal<T> h_p(m_sample_rate, m_block_size);
+                std::copy(h.begin(), h.end(), h_p.begin());
+
+                const auto H = fourier_transform(h_p);
+                std::copy(H.begin(), H.begin() + m_bins, this->spectrum(o, i));
+            }
+        }
+    }
+
+    /*!
+    \brief Gets the sample rate
+    \return Sample rate
+    */
+    size_t sample_rate() const
+    {
+        return m_sample_rate;
+    }
+
+    /*!
+    \brief Gets the size of the input blocks
+    \return Block size
+    */
+    size_type block_size() const
+    {
+        return m_block_size;
+    }
+
+    /*!
+    \brief Gets the number of input channels
+    \return Number of input channels
+    */
+    size_type inputs() const
+    {
+        return m_inputs;
+    }
+
+    /*!
+    \brief Gets the number of output channels
+    \return Number of output channels
+    */
+    size_type outputs() const
+    {
+        return m_outputs;
+    }
+
+    /*!
+    \brief Convolves a block of input channels with the filter matrix
+    \param[in] x Multi-channel input block
+    \param[in] threads Maximum number of threads (from default_thread_pool()) to split the output
+    channels across
+    \return Multi-channel output block
+    */
+    multisignal<T> process(const multisignal<T>& x, const size_type& threads = 1) const
+    {
+        assert(x.sample_rate() == m_sample_rate);
+        assert(x.size() == m_block_size);
+        assert(x.channels() == m_inputs);
+
+        const auto N    = m_block_size;
+        const auto plan = impl::get_fft_plan<T>(N);
+
+        // Transform each input channel once (two channels per FFT), straight
+        // into the scratch spectra
+        impl::scratch_frame frame;
+        auto* const         X = frame.allocate<std::complex<T>>(m_inputs * m_stride);
+        auto* const         Z = frame.allocate<std::complex<T>>(N);
+        for (size_type i = 0; i < m_inputs; i += 2)
+        {
+            const auto* const x_1 = x.channel_view(i).data();
+            auto* const       X_1 = X + i * m_stride;
+
+            if (i + 1 < m_inputs)
+            {
+                const auto* const x_2 = x.channel_view(i + 1).data();
+                this->transform_pair(x_1, x_2, *plan, Z, X_1, X_1 + m_stride);
+            }
+            else
+            {
+                impl::real_fft(x_1, Z, *plan);
+                std::copy(Z, Z + m_bins, X_1);
+            }
+        }
+
+        multisignal<T> y(m_sample_rate, m_block_size, m_outputs, uninitialized);
+
+        // Each worker handles its own output channels, so no locking is needed.
+        // Workers draw their temporaries from their own thread's workspace.
+        const auto pairs   = (m_outputs + 1) / 2;
+        const auto workers = std::max<size_type>(1, std::min(threads, pairs));
+        const auto work    = [&](const size_type worker) {
+            for (auto pair = worker; pair < pairs; pair += workers)
+            {
+                this->process_outputs(X, pair * 2, y);
+            }
+        };
+
+        default_thread_pool().parallel_for(workers, work);
+
+        return y;
+    }
+
+private:
+    // Rounds the number of bins up to a whole number of cache lines
+    static size_type aligned_stride(const size_type& bins)
+    {
+        constexpr auto line = std::max<size_type>(1, cache_line_size / sizeof(std::complex<T>));
+        return (bins + line - 1) / line * line;
+    }
+
+    std::complex<T>* spectrum(const size_type& output, const size_type& input)
+    {
+        return m_spectra.data() + (output * m_inputs + input) * m_stride;
+    }
+
+    const std::complex<T>* spectrum(const size_type& output, const size_type& input) const
+    {
+        return m_spectra.data() + (output * m_inputs + input) * m_stride;
+    }
+
+    // Transforms the real input channels x_1 and x_2 with one complex FFT
+    // through Z, and writes their bins to X_1 and X_2
+    void transform_pair(const T*                 x_1,
+                        const T*                 x_2,
+                        const impl::fft_plan<T>& plan,
+                        std::complex<T>* const   Z,
+                        std::complex<T>* const   X_1,
+                        std::complex<T>* const   X_2) const
+    {
+        const auto N = m_block_size;
+
+        // Z[n] = x_1[n] + jx_2[n] (transformed in place)
+        for (size_type n = 0; n < N; ++n)
+        {
+            Z[n] = {x_1[n], x_2[n]};
+        }
+
+        impl::fft(Z, Z, plan);
+
+        // The FFT of a real channel is conjugate symmetric, so the two
+        // transforms are the conjugate symmetric and conjugate antisymmetric
+        // parts of Z:
+        // X_1[m] = (Z[m] + Z*[N-m]) / 2
+        // X_2[m] = (Z[m] - Z*[N-m]) / 2j
+        for (size_type m = 0; m < m_bins; ++m)
+        {
+            const auto Z_m              = Z[m];
+            const auto Z_conj_N_minus_m = std::conj(Z[m == 0 ? 0 : N - m]);
+
+            const auto sum        = Z_m + Z_conj_N_minus_m;
+            const auto difference = Z_m - Z_conj_N_minus_m;
+
+            X_1[m] = {sum.real() / 2, sum.imag() / 2};
+            X_2[m] = {difference.imag() / 2, -difference.real() / 2};
+        }
+    }
+
+    // Calculates output channels o and o + 1 from the input spectra
+    void process_outputs(const std::complex<T>* X, const size_type& o, multisignal<T>& y) const
+    {
+        const auto N = m_block_size;
+
+        // Multiply-accumulate in the frequency domain
+        impl::scratch_frame frame;
+        auto* const         Y = frame.allocate<std::complex<T>>(2 * m_stride);
+
+        // The products are accumulated, so both outputs start from zero (which
+        // also covers the second output when o is the last one)
+        std::fill(Y, Y + 2 * m_stride, std::complex<T>());
+
+        for (size_type k = o; k < std::min(o + 2, m_outputs); ++k)
+        {
+            auto* const Y_k = Y + (k - o) * m_stride;
+            for (size_type i = 0; i < m_inputs; ++i)
+            {
+                const auto* const X_i = X + i * m_stride;
+                impl::product_accumulate(Y_k, this->spectrum(k, i), X_i, m_bins);
+            }
+        }
+
+        // Both outputs are real, so they can share one inverse FFT as the real
+        // and imaginary parts of Z. The negative frequencies of each output
+        // are the conjugates of the positive frequencies.
+        const auto* const Y_1 = Y;
+        const auto* const Y_2 = Y + m_stride;
+
+        auto* const Z = frame.allocate<std::complex<T>>(N);
+        for (size_type m = 0; m < N; ++m)
+        {
+            const auto Y_1_m = m < m_bins ? Y_1[m] : std::conj(Y_1[N - m]);
+            const auto Y_2_m = m < m_bins ? Y_2[m] : std::conj(Y_2[N - m]);
+
+            Z[m] = Y_1_m + std::complex<T>(0, 1) * Y_2_m;
+        }
+
+        impl::inverse_fft(Z, Z, *impl::get_fft_plan<T>(N));
+
+        const auto y_1 = y.channel_view(o);
+        for (size_type n = 0; n < N; ++n)
+        {
+            y_1[n] = Z[n].real();
+        }
+
+        if (o + 1 < m_outputs)
+        {
+            const auto y_2 = y.channel_view(o + 1);
+            for (size_type n = 0; n < N; ++n)
+            {
+                y_2[n] = Z[n].imag();
+            }
+        }
+    }
+
+    size_t                                m_sample_rate;
+    size_type                             m_block_size;
+    size_type                             m_bins;
+    size_type                             m_stride;
+    size_type                             m_outputs;
+    size_type                             m_inputs;
+    impl::aligned_vector<std::complex<T>> m_spectra;
+};
+
+}  // namespace tnt::dsp
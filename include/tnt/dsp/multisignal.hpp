@@ -1,53 +1,168 @@
 #pragma once
 
+#include "impl/vector_operations.hpp"
 #include "signal.hpp"
+#include "signal_view.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <functional>
 #include <initializer_list>
+#include <iterator>
 #include <vector>
 
 namespace tnt::dsp
 {
 
+namespace impl
+{
+
+// Iterates over the frames of planar multi-channel storage. Dereferencing
+// gives a view of the samples of every channel at the current frame. The view
+// is stored in the iterator, so references to it are only valid until the
+// iterator is advanced.
+template <typename T>
+class frame_iterator final
+{
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type        = signal_view<T>;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = const signal_view<T>*;
+    using reference         = const signal_view<T>&;
+
+    explicit frame_iterator(const signal_view<T>& frame)
+        : m_frame(frame)
+    {}
+
+    reference operator*() const
+    {
+        return m_frame;
+    }
+
+    pointer operator->() const
+    {
+        return &m_frame;
+    }
+
+    frame_iterator& operator++()
+    {
+        m_frame = signal_view<T>(
+            m_frame.sample_rate(), m_frame.data() + 1, m_frame.size(), m_frame.stride());
+        return *this;
+    }
+
+    frame_iterator operator++(int)
+    {
+        auto it = *this;
+        ++*this;
+        return it;
+    }
+
+    friend bool operator==(const frame_iterator& it1, const frame_iterator& it2)
+    {
+        return it1.m_frame.data() == it2.m_frame.data();
+    }
+
+    friend bool operator!=(const frame_iterator& it1, const frame_iterator& it2)
+    {
+        return !(it1 == it2);
+    }
+
+private:
+    signal_view<T> m_frame;
+};
+
+}  // namespace impl
+
 /*!
 \brief Represents a multi-channel DSP signal to store and process sampled data
+
+The samples are stored planar (channel-major) in a single buffer, so the samples of each channel
+are contiguous and per-channel processing streams through memory. Each channel starts on a cache
+line. By default the buffer is cache line aligned, the same as signal.
+
+Indexing a multi-channel signal gives a frame: a view of the samples of every channel at one index.
 */
-template <typename T>
+template <typename T, typename Allocator = aligned_allocator<T>>
 class multisignal final
 {
 public:
     /*!
-    \brief Constant iterator
+    \brief Allocator type
     */
-    using const_iterator = typename std::vector<std::vector<T>>::const_iterator;
+    using allocator_type = Allocator;
 
     /*!
-    \brief Iterator
+    \brief Constant iterator over the frames
     */
-    using iterator = typename std::vector<std::vector<T>>::iterator;
+    using const_iterator = impl::frame_iterator<const T>;
+
+    /*!
+    \brief Iterator over the frames
+    */
+    using iterator = impl::frame_iterator<T>;
 
     /*!
     \brief Size type
     */
-    using size_type = typename std::vector<std::vector<T>>::size_type;
+    using size_type = typename impl::default_init_vector<T, Allocator>::size_type;
 
     /*!
     \brief Value type
     */
-    using value_type = typename std::vector<std::vector<T>>::value_type;
+    using value_type = typename impl::default_init_vector<T, Allocator>::value_type;
 
     /*!
     \brief Constructor
     \param[in] signals One or more single channel signals
     */
-    multisignal(const std::initializer_list<signal<T>> signals)
-        : m_sample_rate()
-        , m_data()
+    multisignal(const std::initializer_list<signal<T, Allocator>> signals)
+        : multisignal(signals.begin(), signals.end(), channels_tag())
+    {}
+
+    /*!
+    \brief Constructor
+
+    All channels are copied into the storage with a single allocation.
+
+    \param[in] signals Single channel signals, one per channel
+    */
+    explicit multisignal(const std::vector<signal<T, Allocator>>& signals)
+        : multisignal(signals.begin(), signals.end(), channels_tag())
+    {}
+
+    /*!
+    \brief Constructor
+
+    All channels are copied into the storage with a single allocation.
+
+    \param[in] signals Views of the samples of each channel
+    */
+    explicit multisignal(const std::vector<signal_view<const T>>& signals)
+        : multisignal(signals.begin(), signals.end(), channels_tag())
+    {}
+
+    /*!
+    \brief Creates a multi-channel signal from interleaved samples
+
+    This is the layout of most multi-channel audio and ADC data: the samples of every channel at
+    index 0, then at index 1, and so on.
+
+    \param[in] sample_rate Sample rate
+    \param[in] data Interleaved samples (size * channels of them)
+    \param[in] size Number of samples per channel
+    \param[in] channels Number of channels
+    */
+    multisignal(const size_t     sample_rate,
+                const T* const   data,
+                const size_type& size,
+                const size_type& channels)
+        : multisignal(sample_rate, size, channels, uninitialized)
     {
-        for (const auto& signal : signals)
-        {
-            this->add_channel(signal);
-        }
+        impl::deinterleave(data, channels, size, m_data.data(), m_stride);
+        this->clear_padding();
     }
 
     /*
@@ -56,6 +171,9 @@ public:
     */
     explicit multisignal(const size_t sample_rate)
         : m_sample_rate(sample_rate)
+        , m_size()
+        , m_stride(aligned_stride(0))
+        , m_channels()
         , m_data()
     {}
 
@@ -66,20 +184,49 @@ public:
     */
     explicit multisignal(const size_t sample_rate, const size_type& size)
         : m_sample_rate(sample_rate)
-        , m_data(size)
+        , m_size(size)
+        , m_stride(aligned_stride(size))
+        , m_channels()
+        , m_data()
+    {}
+
+    /*!
+    \brief Constructor
+
+    The samples are initialized to zero.
+
+    \param[in] sample_rate Sample rate
+    \param[in] size Size
+    \param[in] channels Number of channels
+    */
+    explicit multisignal(const size_t     sample_rate,
+                         const size_type& size,
+                         const size_type& channels)
+        : m_sample_rate(sample_rate)
+        , m_size(size)
+        , m_stride(aligned_stride(size))
+        , m_channels(channels)
+        , m_data(channels * m_stride, T())
     {}
 
     /*!
     \brief Constructor
+
+    The samples are left uninitialized, so every sample must be written before it is read.
+
     \param[in] sample_rate Sample rate
     \param[in] size Size
     \param[in] channels Number of channels
     */
-    explicit multisignal(const size_t                              sample_rate,
-                         const size_type&                          size,
-                         const typename std::vector<T>::size_type& channels)
+    multisignal(const size_t     sample_rate,
+                const size_type& size,
+                const size_type& channels,
+                uninitialized_t)
         : m_sample_rate(sample_rate)
-        , m_data(size, std::vector<T>(channels))
+        , m_size(size)
+        , m_stride(aligned_stride(size))
+        , m_channels(channels)
+        , m_data(channels * m_stride)
     {}
 
     /*!
@@ -92,21 +239,21 @@ public:
     \brief Move constructor
     \param[in] signal Multi-channel signal
     */
-    multisignal(multisignal<T>&& signal) = default;
+    multisignal(multisignal&& signal) = default;
 
     /*!
     \brief Copy assignment operator
     \param[in] signal Multi-channel signal to assign from
     \return Multi-channel signal equal to the input
     */
-    multisignal<T>& operator=(const multisignal<T>& signal) = default;
+    multisignal& operator=(const multisignal& signal) = default;
 
     /*!
     \brief Move assignment operator
     \param[in] signal Multi-channel signal to assign from
     \return Multi-channel signal equal to the input
     */
-    multisignal<T>& operator=(multisignal<T>&& signal) = default;
+    multisignal& operator=(multisignal&& signal) = default;
 
     /*!
     \brief Destructor
@@ -118,19 +265,60 @@ public:
     \param[in] channel Desired channel
     \return Signal contained in the specified channel
     */
-    signal<T> channel(const typename std::vector<T>::size_type& channel) const
+    signal<T, Allocator> channel(const size_type& channel) const
     {
         assert(channel < this->channels());
 
-        signal<T> signal(this->sample_rate(), this->size());
-        for (size_type n = 0; n < this->size(); ++n)
-        {
-            signal[n] = m_data[n][channel];
-        }
+        const auto* const data = this->channel_data(channel);
+
+        signal<T, Allocator> signal(this->sample_rate(), this->size(), uninitialized);
+        std::copy(data, data + this->size(), signal.begin());
 
         return signal;
     }
 
+    /*!
+    \brief Gets a view of the specified channel without copying it
+    \param[in] channel Desired channel
+    \return View of the contiguous constant samples of the channel
+    */
+    signal_view<const T> channel_view(const size_type& channel) const
+    {
+        assert(channel < this->channels());
+        return signal_view<const T>(m_sample_rate, this->channel_data(channel), m_size);
+    }
+
+    /*!
+    \brief Gets a view of the specified channel without copying it
+    \param[in] channel Desired channel
+    \return View of the contiguous samples of the channel
+    */
+    signal_view<T> channel_view(const size_type& channel)
+    {
+        assert(channel < this->channels());
+        return signal_view<T>(m_sample_rate, this->channel_data(channel), m_size);
+    }
+
+    /*!
+    \brief Gets a view of the samples of every channel at the specified index
+    \param[in] index Desired frame
+    \return View of the constant samples of the frame (strided across the channels)
+    */
+    signal_view<const T> frame_view(const size_type& index) const
+    {
+        return (*this)[index];
+    }
+
+    /*!
+    \brief Gets a view of the samples of every channel at the specified index
+    \param[in] index Desired frame
+    \return View of the samples of the frame (strided across the channels)
+    */
+    signal_view<T> frame_view(const size_type& index)
+    {
+        return (*this)[index];
+    }
+
     /*!
     \brief Gets the duration of the signal in seconds
     \return Duration
@@ -150,85 +338,105 @@ public:
     }
 
     /*!
-    \brief Accesses the samples at the specified index
-    \return Constant reference to the requested samples
+    \brief Accesses the samples of every channel at the specified index
+    \return View of the constant samples of the requested frame
     */
-    const value_type& operator[](const size_type& index) const
+    signal_view<const T> operator[](const size_type& index) const
     {
         assert(index < this->size());
-        return m_data[index];
+        return this->frame_at(m_data.data() + index);
     }
 
     /*!
-    \brief Accesses samples at the specified index
-    \return Reference to the requested samples
+    \brief Accesses the samples of every channel at the specified index
+    \return View of the samples of the requested frame
     */
-    value_type& operator[](const size_type& index)
+    signal_view<T> operator[](const size_type& index)
     {
         assert(index < this->size());
-        return m_data[index];
+        return this->frame_at(m_data.data() + index);
     }
 
     /*!
     \brief Gets an iterator to the beginning of the signal
-    \return Iterator to the first sample
+    \return Iterator to the first frame
     */
     iterator begin()
     {
-        return m_data.begin();
+        return iterator(this->frame_at(m_data.data()));
     }
 
     /*!
     \brief Gets a constant iterator to the beginning of the signal
-    \return Constant iterator to the first sample
+    \return Constant iterator to the first frame
     */
     const_iterator begin() const
     {
-        return m_data.begin();
+        return const_iterator(this->frame_at(m_data.data()));
     }
 
     /*!
     \brief Gets a constant iterator to the beginning of the signal
-    \return Constant iterator to the first sample
+    \return Constant iterator to the first frame
     */
     const_iterator cbegin() const
     {
-        return m_data.cbegin();
+        return this->begin();
     }
 
     /*!
     \brief Gets an iterator to the end of the signal
-    \return Iterator to the sample *following* the last sample
+    \return Iterator to the frame *following* the last frame
     */
     iterator end()
     {
-        return m_data.end();
+        return iterator(this->frame_at(m_data.data() + this->size()));
     }
 
     /*!
     \brief Gets a constant iterator to the end of the signal
-    \return Constant iterator to the sample *following* the last sample
+    \return Constant iterator to the frame *following* the last frame
     */
     const_iterator end() const
     {
-        return m_data.end();
+        return const_iterator(this->frame_at(m_data.data() + this->size()));
     }
 
     /*!
     \brief Gets a constant iterator to the end of the signal
-    \return Constant iterator to the sample *following* the last sample
+    \return Constant iterator to the frame *following* the last frame
     */
     const_iterator cend() const
     {
-        return m_data.cend();
+        return this->end();
     }
 
     /*!
     \brief Adds a channel
     \param[in] signal Signal to put in the channel
     */
-    void add_channel(const signal<T>& signal)
+    void add_channel(const signal<T, Allocator>& signal)
+    {
+        this->add_channel(signal.view());
+    }
+
+    /*!
+    \brief Adds a channel
+    \param[in] signal View of the samples to put in the channel
+    */
+    void add_channel(const signal_view<const T>& signal)
     {
+        // Growing the buffer frees the samples of a view into this signal (a
+        // channel or a frame), so those are copied out first
+        const std::less<const T*> before;
+        if (signal.size() && !before(signal.data(), m_data.data())
+            && before(signal.data(), m_data.data() + m_data.size()))
+        {
+            const dsp::signal<T, Allocator> copy(signal);
+            this->add_channel(copy.view());
+            return;
+        }
+
         // Validate sample rate
         if (this->sample_rate())
         {
@@ -240,18 +448,46 @@ public:
         }
 
         // Validate size
-        if (this->size())
+        if (this->size() || this->channels())
         {
             assert(signal.size() == this->size());
         }
         else
         {
-            m_data.resize(signal.size());
+            m_size   = signal.size();
+            m_stride = aligned_stride(m_size);
         }
 
-        for (size_type n = 0; n < this->size(); ++n)
+        // The new channel is appended to the end of the buffer, so only the
+        // buffer itself is ever reallocated
+        m_data.resize((m_channels + 1) * m_stride);
+        std::copy(signal.begin(), signal.end(), this->channel_data(m_channels));
+        std::fill(this->channel_data(m_channels) + m_size, m_data.data() + m_data.size(), T());
+
+        ++m_channels;
+    }
+
+    /*!
+    \brief Copies the samples out interleaved
+    \param[out] data Destination for the samples of every channel at index 0, then at index 1, and
+    so on (size() * channels() samples)
+    */
+    void copy_interleaved(T* const data) const
+    {
+        impl::interleave(m_data.data(), m_stride, m_channels, m_size, data);
+    }
+
+    /*!
+    \brief Copies the samples out planar
+    \param[out] data Destination for all the samples of channel 0, then all the samples of channel
+    1, and so on (size() * channels() samples)
+    */
+    void copy_planar(T* const data) const
+    {
+        for (size_type c = 0; c < m_channels; ++c)
         {
-            m_data[n].push_back(signal[n]);
+            const auto* const channel = this->channel_data(c);
+            std::copy(channel, channel + m_size, data + c * m_size);
         }
     }
 
@@ -261,7 +497,7 @@ public:
     */
     size_type size() const
     {
-        return m_data.size();
+        return m_size;
     }
 
     /*!
@@ -270,16 +506,81 @@ public:
     */
     size_type channels() const
     {
-        return m_data.size() == 0 ? 0 : m_data[0].size();
+        return m_channels;
     }
 
     // Friend declaration for swap
-    template <typename U>
-    friend void swap(multisignal<U>& signal1, multisignal<U>& signal2);
+    template <typename U, typename A>
+    friend void swap(multisignal<U, A>& signal1, multisignal<U, A>& signal2);
 
 private:
-    size_t                      m_sample_rate;
-    std::vector<std::vector<T>> m_data;
+    // Selects the constructor that copies a range of channels
+    struct channels_tag
+    {};
+
+    // Copies each channel in [first, last) into a single allocation
+    template <typename It>
+    multisignal(It first, const It last, channels_tag)
+        : m_sample_rate(first == last ? 0 : first->sample_rate())
+        , m_size(first == last ? 0 : first->size())
+        , m_stride(aligned_stride(m_size))
+        , m_channels(static_cast<size_type>(std::distance(first, last)))
+        , m_data(m_channels * m_stride)
+    {
+        for (auto channel = this->channel_data(0); first != last; ++first, channel += m_stride)
+        {
+            assert(first->sample_rate() == m_sample_rate);
+            assert(first->size() == m_size);
+
+            std::copy(first->begin(), first->end(), channel);
+        }
+
+        this->clear_padding();
+    }
+
+    // Zeroes the samples between the end of each channel and the start of the
+    // next one, so that the padding never holds uninitialized values
+    void clear_padding()
+    {
+        for (size_type c = 0; c < m_channels; ++c)
+        {
+            std::fill(this->channel_data(c) + m_size, this->channel_data(c) + m_stride, T());
+        }
+    }
+
+    // Rounds the number of samples in a channel up to a whole number of cache
+    // lines so that every channel starts on a cache line
+    static size_type aligned_stride(const size_type& size)
+    {
+        constexpr auto line = std::max<size_type>(1, cache_line_size / sizeof(T));
+        return std::max<size_type>(1, (size + line - 1) / line * line);
+    }
+
+    const T* channel_data(const size_type& channel) const
+    {
+        return m_data.data() + channel * m_stride;
+    }
+
+    T* channel_data(const size_type& channel)
+    {
+        return m_data.data() + channel * m_stride;
+    }
+
+    // Gets a view of the frame whose first channel sample is at data
+    template <typename U>
+    signal_view<U> frame_at(U* const data) const
+    {
+        return signal_view<U>(m_sample_rate,
+                              data,
+                              m_channels,
+                              static_cast<typename signal_view<U>::difference_type>(m_stride));
+    }
+
+    size_t                                  m_sample_rate;
+    size_type                               m_size;
+    size_type                               m_stride;
+    size_type                               m_channels;
+    impl::default_init_vector<T, Allocator> m_data;
 };
 
 /*!
@@ -287,11 +588,14 @@ private:
 \param[in] signal1 First signal to swap
 \param[in] signal2 Second signal to swap
 */
-template <typename T>
-void swap(multisignal<T>& signal1, multisignal<T>& signal2)
+template <typename T, typename Allocator>
+void swap(multisignal<T, Allocator>& signal1, multisignal<T, Allocator>& signal2)
 {
     using std::swap;
     swap(signal1.m_sample_rate, signal2.m_sample_rate);
+    swap(signal1.m_size, signal2.m_size);
+    swap(signal1.m_stride, signal2.m_stride);
+    swap(signal1.m_channels, signal2.m_channels);
     swap(signal1.m_data, signal2.m_data);
 }
 
@@ -0,0 +1,281 @@
+#pragma once
+
+#include "impl/oscillator.hpp"
+#include "signal_view.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+
+namespace tnt::dsp
+{
+
+/*!
+\brief Generates a continuous wave one block at a time
+
+Unlike signal_generator, which produces whole signals starting at phase 0, an oscillator carries
+its phase from one block to the next, so blocks of any size can be generated back to back without
+discontinuities. Blocks are written into caller-provided views and nothing is allocated.
+
+Changes to the frequency and amplitude are not applied at once (which would cause audible clicks)
+but ramped linearly over a number of samples (see set_smoothing()). While nothing is changing the
+wave is generated with the same vectorized phasor bank as signal_generator.
+*/
+template <typename T>
+class oscillator final
+{
+public:
+    /*!
+    \brief Constructor
+
+    Changes are smoothed over 1 ms by default.
+
+    \param[in] sample_rate Sample rate of the generated blocks
+    \param[in] frequency Frequency in Hz
+    \param[in] amplitude Amplitude
+    \param[in] phase_shift Phase (in radians) of the first sample
+    */
+    oscillator(const size_t sample_rate,
+               const T      frequency,
+               const T      amplitude   = 1,
+               const T      phase_shift = 0)
+        : m_sample_rate(sample_rate)
+        , m_smoothing(std::max<size_t>(1, sample_rate / 1000))
+        , m_phase(phase_shift)
+        , m_omega(this->angular_frequency(frequency))
+        , m_omega_target(m_omega)
+        , m_omega_step()
+        , m_amplitude(amplitude)
+        , m_amplitude_target(amplitude)
+        , m_amplitude_step()
+        , m_remaining()
+    {}
+
+    /*!
+    \brief Gets the sample rate
+    \return Sample rate
+    */
+    size_t sample_rate() const
+    {
+        return m_sample_rate;
+    }
+
+    /*!
+    \brief Gets the frequency that the oscillator is at or ramping towards
+    \return Frequency in Hz
+    */
+    T frequency() const
+    {
+        return static_cast<T>(m_omega_target * static_cast<double>(m_sample_rate) / (2 * M_PI));
+    }
+
+    /*!
+    \brief Gets the amplitude that the oscillator is at or ramping towards
+    \return Amplitude
+    */
+    T amplitude() const
+    {
+        return m_amplitude_target;
+    }
+
+    /*!
+    \brief Gets the phase of the next sample
+    \return Phase in radians
+    */
+    T phase() const
+    {
+        return static_cast<T>(m_phase);
+    }
+
+    /*!
+    \brief Gets the number of samples that changes are ramped over
+    \return Number of samples
+    */
+    size_t smoothing() const
+    {
+        return m_smoothing;
+    }
+
+    /*!
+    \brief Sets the number of samples that changes are ramped over
+    \param[in] samples Number of samples (0 applies changes immediately)
+    */
+    void set_smoothing(const size_t samples)
+    {
+        m_smoothing = samples;
+    }
+
+    /*!
+    \brief Changes the frequency, starting with the next sample
+    \param[in] frequency Frequency in Hz
+    */
+    void set_frequency(const T frequency)
+    {
+        m_omega_target = this->angular_frequency(frequency);
+        this->start_ramp();
+    }
+
+    /*!
+    \brief Changes the amplitude, starting with the next sample
+    \param[in] amplitude Amplitude
+    */
+    void set_amplitude(const T amplitude)
+    {
+        m_amplitude_target = amplitude;
+        this->start_ramp();
+    }
+
+    /*!
+    \brief Fills a block with the next samples of a cosine wave
+    \param[out] y View of the samples to write
+    */
+    void cosine(const signal_view<T>& y)
+    {
+        this->fill(y, [](const T& re, const T&) {
+            return re;
+        });
+    }
+
+    /*!
+    \brief Fills a block with the next samples of a sine wave
+    \param[out] y View of the samples to write
+    */
+    void sine(const signal_view<T>& y)
+    {
+        this->fill(y, [](const T&, const T& im) {
+            return im;
+        });
+    }
+
+    /*!
+    \brief Fills a block with the next samples of a complex exponential
+    \param[out] y View of the samples to write
+    */
+    void complex_exponential(const signal_view<std::complex<T>>& y)
+    {
+        this->fill(y, [](const T& re, const T& im) {
+            return std::complex<T>(re, im);
+        });
+    }
+
+private:
+    // Phase advance per sample (in radians) of a wave at the given frequency
+    double angular_frequency(const T& frequency) const
+    {
+        return 2 * M_PI * static_cast<double>(frequency) / static_cast<double>(m_sample_rate);
+    }
+
+    // Ramps from the current frequency and amplitude to the targets
+    void start_ramp()
+    {
+        if (m_smoothing == 0)
+        {
+            m_omega     = m_omega_target;
+            m_amplitude = m_amplitude_target;
+            m_remaining = 0;
+
+            return;
+        }
+
+        m_omega_step     = (m_omega_target - m_omega) / static_cast<double>(m_smoothing);
+        m_amplitude_step = (m_amplitude_target - m_amplitude) / static_cast<T>(m_smoothing);
+        m_remaining      = m_smoothing;
+    }
+
+    template <typename U, typename Map>
+    void fill(const signal_view<U>& y, const Map& map)
+    {
+        assert(y.sample_rate() == m_sample_rate);
+
+        auto* const data   = y.data();
+        const auto  stride = y.stride();
+
+        if (stride == 1)
+        {
+            this->generate(y.size(), [=](const size_t n, const T& re, const T& im) {
+                data[n] = map(re, im);
+            });
+        }
+        else
+        {
+            this->generate(y.size(), [=](const size_t n, const T& re, const T& im) {
+                data[static_cast<std::ptrdiff_t>(n) * stride] = map(re, im);
+            });
+        }
+    }
+
+    // Calls store(n, re, im) with the next count samples and advances the phase
+    template <typename Store>
+    void generate(const size_t count, const Store& store)
+    {
+        constexpr auto R = impl::oscillator_reseed_interval<double>;
+
+        size_t n = 0;
+
+        // While ramping, the frequency changes every sample, so the phasor is
+        // rotated by a rotation that itself rotates. It is reseeded from the
+        // exact phase at the start of every segment to bound the drift.
+        while (n < count && m_remaining > 0)
+        {
+            const auto segment = std::min({count - n, m_remaining, R});
+
+            auto       z = std::polar(1.0, m_phase);
+            auto       w = std::polar(1.0, m_omega);
+            const auto d = std::polar(1.0, m_omega_step);
+            auto       a = m_amplitude;
+            for (size_t k = 0; k < segment; ++k, ++n)
+            {
+                store(n, a * static_cast<T>(z.real()), a * static_cast<T>(z.imag()));
+
+                z *= w;
+                w *= d;
+                a += m_amplitude_step;
+            }
+
+            const auto S = static_cast<double>(segment);
+
+            m_phase     += S * m_omega + m_omega_step * S * (S - 1) / 2;
+            m_omega     += m_omega_step * S;
+            m_amplitude += m_amplitude_step * static_cast<T>(segment);
+            m_remaining -= segment;
+
+            // Land exactly on the targets
+            if (m_remaining == 0)
+            {
+                m_omega     = m_omega_target;
+                m_amplitude = m_amplitude_target;
+            }
+        }
+
+        if (n < count)
+        {
+            const auto n_0    = n;
+            const auto a      = m_amplitude;
+            const auto scaled = [&](const size_t k, const T& re, const T& im) {
+                store(n_0 + k, a * re, a * im);
+            };
+
+            impl::oscillate<T>(m_phase, m_omega, count - n_0, scaled);
+
+            m_phase += m_omega * static_cast<double>(count - n_0);
+        }
+
+        // Keep the phase small so that it does not lose precision over time
+        m_phase = std::fmod(m_phase, 2 * M_PI);
+    }
+
+    size_t m_sample_rate;
+    size_t m_smoothing;
+    double m_phase;
+    double m_omega;
+    double m_omega_target;
+    double m_omega_step;
+    T      m_amplitude;
+    T      m_amplitude_target;
+    T      m_amplitude_step;
+    size_t m_remaining;
+};
+
+}  // namespace tnt::dsp
@@ -0,0 +1,626 @@
+#pragma once
+
+#include "aligned_allocator.hpp"
+#include "analysis.hpp"
+#include "fourier_transform.hpp"
+#include "multisignal.hpp"
+#include "signal.hpp"
+#include "signal_view.hpp"
+#include "thread_pool.hpp"
+#include "workspace.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <complex>
+#include <cstddef>
+#include <limits>
+#include <utility>
+
+namespace tnt::dsp
+{
+
+/*!
+\brief Specifies where the frames of a short-time Fourier transform are placed
+*/
+enum class stft_padding
+{
+    none,     //!< Frames lie entirely inside the signal, starting at the first sample
+    centered  //!< Frame f is centered on sample f * hop, with zeros outside the signal
+};
+
+/*!
+\brief Calculates short-time Fourier transforms of real signals, offline or in a stream
+
+Each frame of the signal is multiplied by the window, padded with zeros to the transform size and
+transformed. Since the signal is real only the non-negative frequencies are kept, so the result
+is a multi-channel signal with one channel per frame (time) and one sample per frequency bin. Every
+frame is contiguous and starts on a cache line.
+
+Frames are transformed two at a time, as the real and imaginary parts of one complex FFT, using
+the plan of the transform size and temporaries drawn from the workspace of the thread. Offline
+transforms can split the frames across threads.
+
+Samples can also be pushed in blocks of any size, in which case every frame is transformed as soon
+as it is complete. Streamed frames are the same as the frames of the offline transform of all of
+the samples pushed so far.
+
+The inverse transform adds up the frames multiplied by the window again (weighted overlap-add) and
+divides by the sum of the squared window, so every sample covered by a non-zero part of the window
+is reconstructed exactly.
+*/
+template <typename T>
+class short_time_fourier_transform final
+{
+public:
+    /*!
+    \brief Size type
+    */
+    using size_type = size_t;
+
+    /*!
+    \brief Constructor
+
+    The frames are as long as the window and are transformed without padding.
+
+    \param[in] window Window that every frame is multiplied by (its size is the frame size)
+    \param[in] hop Number of samples from the start of one frame to the start of the next
+    \param[in] padding Placement of the frames
+    */
+    short_time_fourier_transform(const signal<T>&   window,
+                                 const size_type&   hop,
+                                 const stft_padding padding = stft_padding::centered)
+        : short_time_fourier_transform(window, hop, window.size(), padding)
+    {}
+
+    /*!
+    \brief Constructor
+    \param[in] window Window that every frame is multiplied by (its size is the frame size)
+    \param[in] hop Number of samples from the start of one frame to the start of the next
+    \param[in] fft_size Size of the transform of each frame (at least the frame size)
+    \param[in] padding Placement of the frames
+    */
+    short_time_fourier_transform(const signal<T>&   window,
+                                 const size_type&   hop,
+                                 const size_type&   fft_size,
+                                 const stft_padding padding = stft_padding::centered)
+        : m_sample_rate(window.sample_rate())
+        , m_frame_size(window.size())
+        , m_hop(hop)
+        , m_fft_size(fft_size)
+        , m_bins(fft_size / 2 + 1)
+        , m_padding(padding)
+        , m_offset(padding == stft_padding::centered ? window.size() / 2 : 0)
+        , m_window(window.begin(), window.end())
+        , m_buffer(window.size())
+    {
+        assert(m_frame_size > 0);
+        assert(m_hop > 0);
+        assert(m_fft_size >= m_frame_size);
+
+        this->reset();
+    }
+
+    /*!
+    \brief Gets the sample rate
+    \return Sample rate
+    */
+    size_t sample_rate() const
+    {
+        return m_sample_rate;
+    }
+
+    /*!
+    \brief Gets the number of samples in each frame
+    \return Frame size
+    */
+    size_type frame_size() const
+    {
+        return m_frame_size;
+    }
+
+    /*!
+    \brief Gets the number of samples from the start of one frame to the start of the next
+    \return Hop size
+    */
+    size_type hop() const
+    {
+        return m_hop;
+    }
+
+    /*!
+    \brief Gets the size of the transform of each frame
+    \return FFT size
+    */
+    size_type fft_size() const
+    {
+        return m_fft_size;
+    }
+
+    /*!
+    \brief Gets the number of frequency bins of each frame (the non-negative frequencies)
+    \return Number of bins
+    */
+    size_type bins() const
+    {
+        return m_bins;
+    }
+
+    /*!
+    \brief Gets the placement of the frames
+    \return Padding
+    */
+    stft_padding padding() const
+    {
+        return m_padding;
+    }
+
+    /*!
+    \brief Gets the number of frames in the transform of a signal
+    \param[in] samples Number of samples in the signal
+    \return Number of frames
+    */
+    size_type frames(const size_type& samples) const
+    {
+        if (m_padding == stft_padding::centered)
+        {
+            return samples > 0 ? 1 + samples / m_hop : 0;
+        }
+
+        return samples >= m_frame_size ? 1 + (samples - m_frame_size) / m_hop : 0;
+    }
+
+    /*!
+    \brief Calculates the short-time Fourier transform of a signal
+    \param[in] x View of the samples
+    \param[in] threads Maximum number of threads (from default_thread_pool()) to split the frames
+    across
+    \return Multi-channel signal with the spectrum of each frame in one channel
+    */
+    multisignal<std::complex<T>> transform(const signal_view<const T>& x,
+                                           const size_type&            threads = 1) const
+    {
+        const auto F = this->frames(x.size());
+
+        multisignal<std::complex<T>> X(x.sample_rate(), m_bins, F, uninitialized);
+        this->transform(x, X, threads);
+
+        return X;
+    }
+
+    /*!
+    \brief Calculates the short-time Fourier transform of a signal
+    \param[in] x Signal
+    \param[in] threads Maximum number of threads (from default_thread_pool()) to split the frames
+    across
+    \return Multi-channel signal with the spectrum of each frame in one channel
+    */
+    template <typename Allocator>
+    multisignal<std::complex<T>> transform(const signal<T, Allocator>& x,
+                                           const size_type&            threads = 1) const
+    {
+        return this->transform(x.view(), threads);
+    }
+
+    /*!
+    \brief Calculates the short-time Fourier transform of a signal into an existing output
+
+    Nothing is allocated, so transforming signals of the same size over and over again reuses the
+    same output.
+
+    \param[in] x View of the samples
+    \param[out] X Spectra of the frames, with frames() channels of bins() samples
+    \param[in] threads Maximum number of threads (from default_thread_pool()) to split the frames
+    across
+    */
+    void transform(const signal_view<const T>&   x,
+                   multisignal<std::complex<T>>& X,
+                   const size_type&              threads = 1) const
+    {
+        assert(X.size() == m_bins);
+        assert(X.channels() == this->frames(x.size()));
+
+        this->analyze(x, threads, [&](const size_type f, const std::complex<T>* X_f) {
+            std::copy(X_f, X_f + m_bins, X.channel_view(f).data());
+        });
+    }
+
+    /*!
+    \brief Calculates the short-time Fourier transform of a signal into an existing output
+    \param[in] x Signal
+    \param[out] X Spectra of the frames, with frames() channels of bins() samples
+    \param[in] threads Maximum number of threads (from default_thread_pool()) to split the frames
+    across
+    */
+    template <typename Allocator>
+    void transform(const signal<T, Allocator>&   x,
+                   multisignal<std::complex<T>>& X,
+                   const size_type&              threads = 1) const
+    {
+        this->transform(x.view(), X, threads);
+    }
+
+    /*!
+    \brief Calculates the spectrogram (the power of the short-time Fourier transform) of a signal
+    \param[in] x View of the samples
+    \param[in] threads Maximum number of threads (from default_thread_pool()) to split the frames
+    across
+    \return Multi-channel signal with the power spectrum of each frame in one channel
+    */
+    multisignal<T> spectrogram(const signal_view<const T>& x, const size_type& threads = 1) const
+    {
+        const auto F = this->frames(x.size());
+
+        multisignal<T> S(x.sample_rate(), m_bins, F, uninitialized);
+
+        this->analyze(x, threads, [&](const size_type f, const std::complex<T>* X_f) {
+            const signal_view<const std::complex<T>> X_f_view(m_sample_rate, X_f, m_bins);
+            power(X_f_view, S.channel_view(f));
+        });
+
+        return S;
+    }
+
+    /*!
+    \brief Calculates the spectrogram (the power of the short-time Fourier transform) of a signal
+    \param[in] x Signal
+    \param[in] threads Maximum number of threads (from default_thread_pool()) to split the frames
+    across
+    \return Multi-channel signal with the power spectrum of each frame in one channel
+    */
+    template <typename Allocator>
+    multisignal<T> spectrogram(const signal<T, Allocator>& x, const size_type& threads = 1) const
+    {
+        return this->spectrogram(x.view(), threads);
+    }
+
+    /*!
+    \brief Reconstructs a signal from its short-time Fourier transform by weighted overlap-add
+
+    The spectra do not have to come from transform() unmodified. Samples that no frame covers with a
+    non-zero part of the window are 0.
+
+    \param[in] X Spectra of the frames, with frames(size) channels of bins() samples
+    \param[in] size Number of samples in the signal
+    \return Reconstructed signal
+    */
+    signal<T> inverse(const multisignal<std::complex<T>>& X, const size_type& size) const
+    {
+        assert(X.size() == m_bins);
+        assert(X.channels() == this->frames(size));
+
+        const auto  K    = m_fft_size;
+        const auto  F    = X.channels();
+        const auto  plan = impl::get_fft_plan<T>(K);
+
+        signal<T> y(X.sample_rate(), size);
+
+        impl::scratch_frame frame;
+        auto* const         Z        = frame.allocate<std::complex<T>>(K);
+        auto* const         envelope = frame.allocate<T>(size);
+        std::fill(envelope, envelope + size, T(0));
+
+        // Two frames are inverse transformed at once as the real and imaginary
+        // parts of Z. The negative frequencies of each frame are the conjugates
+        // of the positive frequencies.
+        for (size_type f = 0; f < F; f += 2)
+        {
+            const auto* const Y_1 = X.channel_view(f).data();
+            const auto* const Y_2 = f + 1 < F ? X.channel_view(f + 1).data() : nullptr;
+
+            for (size_type m = 0; m < K; ++m)
+            {
+                const auto Y_1_m = m < m_bins ? Y_1[m] : std::conj(Y_1[K - m]);
+                const auto Y_2_m = !Y_2        ? std::complex<T>()
+                                   : m < m_bins ? Y_2[m]
+                                                : std::conj(Y_2[K - m]);
+
+                Z[m] = {Y_1_m.real() - Y_2_m.imag(), Y_1_m.imag() + Y_2_m.real()};
+            }
+
+            impl::inverse_fft(Z, Z, *plan);
+
+            const auto* const z = reinterpret_cast<const T*>(Z);
+            for (size_type g = f; g < std::min(f + 2, F); ++g)
+            {
+                const auto [first, last] = this->overlap(g, size);
+
+                // Sample first of the frame is sample start of the signal
+                const auto        start = g * m_hop + first - m_offset;
+                const auto* const w     = m_window.data() + first;
+                const auto* const z_g   = z + 2 * first + (g - f);
+                auto* const       y_g   = y.data() + start;
+                auto* const       e_g   = envelope + start;
+                for (size_type n = 0; n < last - first; ++n)
+                {
+                    y_g[n] += w[n] * z_g[2 * n];
+                    e_g[n] += w[n] * w[n];
+                }
+            }
+        }
+
+        const auto floor = std::numeric_limits<T>::min();
+        for (size_type n = 0; n < size; ++n)
+        {
+            y[n] = envelope[n] > floor ? y[n] / envelope[n] : 0;
+        }
+
+        return y;
+    }
+
+    /*!
+    \brief Adds samples to the stream and transforms every frame that they complete
+
+    \a f is called with the spectrum of each completed frame in order. The spectrum is drawn from
+    the workspace and is only valid during the call.
+
+    \param[in] x View of the next samples of the stream
+    \param[in] f Function taking a view of the spectrum of a frame
+    */
+    template <typename Function>
+    void push(const signal_view<const T>& x, const Function& f)
+    {
+        assert(x.sample_rate() == m_sample_rate);
+
+        const auto N = x.size();
+        m_pushed    += N;
+
+        size_type n = 0;
+        while (n < N)
+        {
+            // Samples between frames that are further apart than their size
+            if (m_skip > 0)
+            {
+                const auto skipped = std::min(m_skip, N - n);
+
+                n      += skipped;
+                m_skip -= skipped;
+
+                continue;
+            }
+
+            const auto count = std::min(m_frame_size - m_buffered, N - n);
+            std::copy(x.begin() + n, x.begin() + (n + count), m_buffer.begin() + m_buffered);
+
+            n          += count;
+            m_buffered += count;
+
+            if (m_buffered == m_frame_size)
+            {
+                this->emit(f);
+            }
+        }
+    }
+
+    /*!
+    \brief Adds samples to the stream and transforms every frame that they complete
+    \param[in] x Next samples of the stream
+    \param[in] f Function taking a view of the spectrum of a frame
+    */
+    template <typename Allocator, typename Function>
+    void push(const signal<T, Allocator>& x, const Function& f)
+    {
+        this->push(x.view(), f);
+    }
+
+    /*!
+    \brief Ends the stream, transforming the frames that overlap its end
+
+    The samples after the end of the stream are taken to be 0, the same as in the offline
+    transform. The stream is then reset.
+
+    \param[in] f Function taking a view of the spectrum of a frame
+    */
+    template <typename Function>
+    void flush(const Function& f)
+    {
+        const auto F = this->frames(m_pushed);
+        while (m_emitted < F)
+        {
+            std::fill(m_buffer.begin() + m_buffered, m_buffer.end(), T(0));
+
+            m_skip     = 0;
+            m_buffered = m_frame_size;
+            this->emit(f);
+        }
+
+        this->reset();
+    }
+
+    /*!
+    \brief Discards the samples of the stream and starts a new one
+    */
+    void reset()
+    {
+        std::fill(m_buffer.begin(), m_buffer.end(), T(0));
+
+        // A centered stream starts with the padding before the first sample
+        m_buffered = m_offset;
+        m_skip     = 0;
+        m_pushed   = 0;
+        m_emitted  = 0;
+    }
+
+private:
+    // Gets the range [first, last) of the samples of frame f that lie inside a
+    // signal of the given size
+    std::pair<size_type, size_type> overlap(const size_type& f, const size_type& size) const
+    {
+        // The frame starts at f * hop - offset
+        const auto start = f * m_hop;
+        const auto first = std::min(m_offset > start ? m_offset - start : 0, m_frame_size);
+        const auto last  = std::clamp(size + m_offset - std::min(start, size + m_offset),
+                                     first,
+                                     m_frame_size);
+
+        return {first, last};
+    }
+
+    // Windows frames f and f + 1 (if there is one) of x and transforms both
+    // with one complex FFT, writing their bins to X_1 and X_2
+    void transform_pair(const T*                 x,
+                        const size_type&         N,
+                        const size_type&         f,
+                        const size_type&         F,
+                        const impl::fft_plan<T>& plan,
+                        std::complex<T>* const   Z,
+                        std::complex<T>* const   X_1,
+                        std::complex<T>* const   X_2) const
+    {
+        const auto K = m_fft_size;
+
+        const auto L = m_frame_size;
+        const auto w = m_window.data();
+
+        // Z[n] = x_f[n] + jx_(f + 1)[n], with zeros outside the signal and
+        // past the end of the frames
+        const auto [first_1, last_1] = this->overlap(f, N);
+        const auto [first_2, last_2] = f + 1 < F ? this->overlap(f + 1, N) : std::pair(L, L);
+
+        if (first_1 == 0 && first_2 == 0 && last_1 == L && last_2 == L)
+        {
+            // Both frames lie inside the signal (all but the first and last few)
+            const auto* const x_1 = x + f * m_hop - m_offset;
+            const auto* const x_2 = x_1 + m_hop;
+            for (size_type n = 0; n < L; ++n)
+            {
+                Z[n] = {w[n] * x_1[n], w[n] * x_2[n]};
+            }
+
+            std::fill(Z + L, Z + K, std::complex<T>(0));
+        }
+        else
+        {
+            std::fill(Z, Z + K, std::complex<T>(0));
+
+            auto* const z = reinterpret_cast<T*>(Z);
+            for (size_type g = f; g < std::min(f + 2, F); ++g)
+            {
+                const auto [first, last] = this->overlap(g, N);
+
+                // Sample first of the frame is sample start of the signal
+                const auto        start = g * m_hop + first - m_offset;
+                const auto* const x_g   = x + start;
+                auto* const       z_g   = z + 2 * first + (g - f);
+                for (size_type n = 0; n < last - first; ++n)
+                {
+                    z_g[2 * n] = w[first + n] * x_g[n];
+                }
+            }
+        }
+
+        impl::fft(Z, Z, plan);
+
+        // The FFT of a real frame is conjugate symmetric, so the two transforms
+        // are the conjugate symmetric and conjugate antisymmetric parts of Z:
+        // X_1[m] = (Z[m] + Z*[K-m]) / 2
+        // X_2[m] = (Z[m] - Z*[K-m]) / 2j
+        // The products are written out since complex multiplication is a
+        // library call (to handle infinities) unless the compiler may ignore them
+        for (size_type m = 0; m < m_bins; ++m)
+        {
+            const auto Z_m              = Z[m];
+            const auto Z_conj_K_minus_m = std::conj(Z[m == 0 ? 0 : K - m]);
+
+            const auto sum        = Z_m + Z_conj_K_minus_m;
+            const auto difference = Z_m - Z_conj_K_minus_m;
+
+            X_1[m] = {sum.real() / 2, sum.imag() / 2};
+            X_2[m] = {difference.imag() / 2, -difference.real() / 2};
+        }
+    }
+
+    // Calls store(f, X_f) with the bins of every frame f of x
+    template <typename Store>
+    void analyze(const signal_view<const T>& x, const size_type& threads, const Store& store) const
+    {
+        assert(x.sample_rate() == m_sample_rate);
+
+        const auto N     = x.size();
+        const auto F     = this->frames(N);
+        const auto pairs = (F + 1) / 2;
+
+        impl::scratch_frame frame;
+        const auto* const   data = impl::contiguous(x, frame);
+
+        // Every worker takes a contiguous run of frames, so consecutive frames
+        // (which share most of their samples) are read by the same thread.
+        // Workers draw their temporaries from their own thread's workspace.
+        const auto workers = std::max<size_type>(1, std::min(threads, pairs));
+        const auto work    = [&](const size_type worker) {
+            const auto plan = impl::get_fft_plan<T>(m_fft_size);
+
+            impl::scratch_frame worker_frame;
+            auto* const         Z = worker_frame.allocate<std::complex<T>>(m_fft_size);
+            auto* const         X = worker_frame.allocate<std::complex<T>>(2 * m_bins);
+
+            const auto first = worker * pairs / workers;
+            const auto last  = (worker + 1) * pairs / workers;
+            for (auto pair = first; pair < last; ++pair)
+            {
+                const auto f = 2 * pair;
+
+                this->transform_pair(data, N, f, F, *plan, Z, X, X + m_bins);
+
+                store(f, X);
+                if (f + 1 < F)
+                {
+                    store(f + 1, X + m_bins);
+                }
+            }
+        };
+
+        default_thread_pool().parallel_for(workers, work);
+    }
+
+    // Transforms the buffered frame, passes its spectrum to f and moves on to
+    // the next frame
+    template <typename Function>
+    void emit(const Function& f)
+    {
+        const auto K = m_fft_size;
+
+        impl::scratch_frame frame;
+        auto* const         y = frame.allocate<T>(K);
+        auto* const         Y = frame.allocate<std::complex<T>>(K);
+
+        for (size_type n = 0; n < m_frame_size; ++n)
+        {
+            y[n] = m_window[n] * m_buffer[n];
+        }
+        std::fill(y + m_frame_size, y + K, T(0));
+
+        impl::real_fft(y, Y, *impl::get_fft_plan<T>(K));
+
+        f(signal_view<const std::complex<T>>(m_sample_rate, Y, m_bins));
+        ++m_emitted;
+
+        if (m_hop < m_frame_size)
+        {
+            std::copy(m_buffer.begin() + m_hop, m_buffer.end(), m_buffer.begin());
+            m_buffered = m_frame_size - m_hop;
+        }
+        else
+        {
+            m_buffered = 0;
+            m_skip     = m_hop - m_frame_size;
+        }
+    }
+
+    size_t                  m_sample_rate;
+    size_type               m_frame_size;
+    size_type               m_hop;
+    size_type               m_fft_size;
+    size_type               m_bins;
+    stft_padding            m_padding;
+    size_type               m_offset;
+    impl::aligned_vector<T> m_window;
+
+    // State of the stream
+    impl::aligned_vector<T> m_buffer;
+    size_type               m_buffered;
+    size_type               m_skip;
+    size_type               m_pushed;
+    size_type               m_emitted;
+};
+
+}  // namespace tnt::dsp
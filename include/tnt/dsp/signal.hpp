@@ -1,59 +1,112 @@
 #pragma once
 
+#include "aligned_allocator.hpp"
+#include "signal_expression.hpp"
+#include "signal_view.hpp"
+
 #include <cassert>
 #include <complex>
+#include <functional>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 // TODO: Add additional container function support
-// TODO: Add arithmetic operators
 
 namespace tnt::dsp
 {
 
+/*!
+\brief Tag type that selects the constructors which leave the samples uninitialized
+*/
+struct uninitialized_t
+{
+    explicit uninitialized_t() = default;
+};
+
+/*!
+\brief Selects the constructors which leave the samples uninitialized
+
+Functions that overwrite every sample of their output use this to avoid zeroing the samples first.
+*/
+inline constexpr uninitialized_t uninitialized{};
+
 /*!
 \brief Represents a DSP signal to store and process sampled data
+
+By default the samples are stored in cache line aligned memory so that the transforms and analysis
+functions can use aligned SIMD loads and stores on them.
 */
-template <typename T>
+template <typename T, typename Allocator = aligned_allocator<T>>
 class signal final
 {
 public:
+    /*!
+    \brief Allocator type
+    */
+    using allocator_type = Allocator;
+
     /*!
     \brief Constant iterator
     */
-    using const_iterator = typename std::vector<T>::const_iterator;
+    using const_iterator = typename impl::default_init_vector<T, Allocator>::const_iterator;
 
     /*!
     \brief Iterator
     */
-    using iterator = typename std::vector<T>::iterator;
+    using iterator = typename impl::default_init_vector<T, Allocator>::iterator;
 
     /*!
     \brief Size type
     */
-    using size_type = typename std::vector<T>::size_type;
+    using size_type = typename impl::default_init_vector<T, Allocator>::size_type;
 
     /*!
     \brief Value type
     */
-    using value_type = typename std::vector<T>::value_type;
+    using value_type = typename impl::default_init_vector<T, Allocator>::value_type;
 
     /*!
     \brief Constructor
     \param[in] sample_rate Sample rate
+    \param[in] allocator Allocator for the sample storage
     */
-    explicit signal(const size_t sample_rate)
+    explicit signal(const size_t sample_rate, const Allocator& allocator = Allocator())
         : m_sample_rate(sample_rate)
+        , m_data(allocator)
     {}
 
     /*!
     \brief Constructor
+
+    The samples are initialized to zero.
+
+    \param[in] sample_rate Sample rate
+    \param[in] size Size
+    \param[in] allocator Allocator for the sample storage
+    */
+    explicit signal(const size_t     sample_rate,
+                    const size_type& size,
+                    const Allocator& allocator = Allocator())
+        : m_sample_rate(sample_rate)
+        , m_data(size, T(), allocator)
+    {}
+
+    /*!
+    \brief Constructor
+
+    The samples are left uninitialized, so every sample must be written before it is read.
+
     \param[in] sample_rate Sample rate
     \param[in] size Size
+    \param[in] allocator Allocator for the sample storage
     */
-    explicit signal(const size_t sample_rate, const size_type& size)
+    signal(const size_t     sample_rate,
+           const size_type& size,
+           uninitialized_t,
+           const Allocator& allocator = Allocator())
         : m_sample_rate(sample_rate)
-        , m_data(size)
+        , m_data(size, allocator)
     {}
 
     /*!
@@ -61,8 +114,8 @@ public:
     \param[in] real Signal containing the real samples
     \param[in] imaginary Signal containing the imaginary samples
     */
-    template <typename U>
-    signal(const signal<U>& real, const signal<U>& imaginary)
+    template <typename U, typename A>
+    signal(const signal<U, A>& real, const signal<U, A>& imaginary)
         : m_sample_rate(real.sample_rate())
         , m_data(real.size())
     {
@@ -75,31 +128,115 @@ public:
         }
     }
 
+    /*!
+    \brief Creates a signal from a copy of the viewed samples
+    \param[in] view View of the samples
+    */
+    template <typename U,
+              typename = std::enable_if_t<std::is_same_v<std::remove_cv_t<U>, T>>>
+    explicit signal(const signal_view<U>& view)
+        : m_sample_rate(view.sample_rate())
+        , m_data(view.begin(), view.end())
+    {}
+
+    /*!
+    \brief Creates a signal by evaluating an expression
+    \param[in] e Expression to evaluate
+    */
+    template <typename Op, typename... Operands>
+    signal(const signal_expression<Op, Operands...>& e)
+        : m_sample_rate(e.sample_rate())
+        , m_data(e.size())
+    {
+        impl::evaluate(m_data.data(), m_data.size(), e);
+    }
+
     /*!
     \brief Copy constructor
     \param[in] signal Signal
     */
-    signal(const signal<T>& signal) = default;
+    signal(const signal& signal) = default;
 
     /*!
     \brief Move constructor
     \param[in] signal Signal
     */
-    signal(signal<T>&& signal) = default;
+    signal(signal&& signal) = default;
 
     /*!
     \brief Copy assignment operator
     \param[in] signal Signal to assign from
     \return Signal equal to the input
     */
-    signal<T>& operator=(const signal<T>& signal) = default;
+    signal& operator=(const signal& signal) = default;
 
     /*!
     \brief Move assignment operator
     \param[in] signal Signal to assign from
     \return Signal equal to the input
     */
-    signal<T>& operator=(signal<T>&& signal) = default;
+    signal& operator=(signal&& signal) = default;
+
+    /*!
+    \brief Assigns the result of an expression
+    \param[in] e Expression to evaluate
+    \return Signal containing the result
+    */
+    template <typename Op, typename... Operands>
+    signal& operator=(const signal_expression<Op, Operands...>& e)
+    {
+        // Operands always match the size of the expression, so the storage is
+        // only reallocated when the expression does not refer to this signal
+        m_sample_rate = e.sample_rate();
+        m_data.resize(e.size());
+        impl::evaluate(m_data.data(), m_data.size(), e);
+
+        return *this;
+    }
+
+    /*!
+    \brief Adds a signal, view, expression, or scalar to the signal sample by sample
+    \param[in] x Value to add
+    \return This signal
+    */
+    template <typename E, typename = std::enable_if_t<impl::is_operand_pair_v<signal&, E>>>
+    signal& operator+=(E&& x)
+    {
+        return this->compound_assign(std::forward<E>(x), std::plus<>());
+    }
+
+    /*!
+    \brief Subtracts a signal, view, expression, or scalar from the signal sample by sample
+    \param[in] x Value to subtract
+    \return This signal
+    */
+    template <typename E, typename = std::enable_if_t<impl::is_operand_pair_v<signal&, E>>>
+    signal& operator-=(E&& x)
+    {
+        return this->compound_assign(std::forward<E>(x), std::minus<>());
+    }
+
+    /*!
+    \brief Multiplies the signal by a signal, view, expression, or scalar sample by sample
+    \param[in] x Value to multiply by
+    \return This signal
+    */
+    template <typename E, typename = std::enable_if_t<impl::is_operand_pair_v<signal&, E>>>
+    signal& operator*=(E&& x)
+    {
+        return this->compound_assign(std::forward<E>(x), std::multiplies<>());
+    }
+
+    /*!
+    \brief Divides the signal by a signal, view, expression, or scalar sample by sample
+    \param[in] x Value to divide by
+    \return This signal
+    */
+    template <typename E, typename = std::enable_if_t<impl::is_operand_pair_v<signal&, E>>>
+    signal& operator/=(E&& x)
+    {
+        return this->compound_assign(std::forward<E>(x), std::divides<>());
+    }
 
     /*!
     \brief Destructor
@@ -115,6 +252,15 @@ public:
         return this->size() / static_cast<double>(this->sample_rate());
     }
 
+    /*!
+    \brief Gets the allocator
+    \return Allocator used for the sample storage
+    */
+    allocator_type get_allocator() const
+    {
+        return m_data.get_allocator();
+    }
+
     /*!
     \brief Gets the sample rate
     \return Sample rate
@@ -144,6 +290,42 @@ public:
         return m_data[index];
     }
 
+    /*!
+    \brief Gets a pointer to the underlying sample storage
+    \return Constant pointer to the first sample
+    */
+    const value_type* data() const
+    {
+        return m_data.data();
+    }
+
+    /*!
+    \brief Gets a pointer to the underlying sample storage
+    \return Pointer to the first sample
+    */
+    value_type* data()
+    {
+        return m_data.data();
+    }
+
+    /*!
+    \brief Gets a view of the samples
+    \return View of constant samples
+    */
+    signal_view<const T> view() const
+    {
+        return signal_view<const T>(m_sample_rate, m_data.data(), m_data.size());
+    }
+
+    /*!
+    \brief Gets a view of the samples
+    \return View of mutable samples
+    */
+    signal_view<T> view()
+    {
+        return signal_view<T>(m_sample_rate, m_data.data(), m_data.size());
+    }
+
     /*!
     \brief Gets an iterator to the beginning of the signal
     \return Iterator to the first sample
@@ -227,9 +409,24 @@ public:
 
     /*!
     \brief Sets the size
+
+    Samples added to the end of the signal are initialized to zero.
+
     \param[in] size Desired size
     */
     void resize(const size_type& size)
+    {
+        m_data.resize(size, T());
+    }
+
+    /*!
+    \brief Sets the size
+
+    Samples added to the end of the signal are left uninitialized.
+
+    \param[in] size Desired size
+    */
+    void resize(const size_type& size, uninitialized_t)
     {
         m_data.resize(size);
     }
@@ -248,12 +445,28 @@ public:
     }
 
     // Friend declaration for swap
-    template <typename U>
-    friend void swap(signal<U>& signal1, signal<U>& signal2);
+    template <typename U, typename A>
+    friend void swap(signal<U, A>& signal1, signal<U, A>& signal2);
 
 private:
-    size_t         m_sample_rate;
-    std::vector<T> m_data;
+    // Applies y[n] = op(y[n], x[n]) in place without allocating
+    template <typename E, typename Op>
+    signal& compound_assign(E&& x, const Op& op)
+    {
+        const auto x_o = impl::make_operand_for<T>(std::forward<E>(x));
+
+        if constexpr (!impl::is_scalar_v<E>)
+        {
+            assert(x_o.size() == this->size());
+        }
+
+        impl::evaluate(m_data.data(), m_data.size(), x_o, op);
+
+        return *this;
+    }
+
+    size_t                                  m_sample_rate;
+    impl::default_init_vector<T, Allocator> m_data;
 };
 
 /*!
@@ -261,8 +474,8 @@ private:
 \param[in] signal1 First signal to swap
 \param[in] signal2 Second signal to swap
 */
-template <typename T>
-void swap(signal<T>& signal1, signal<T>& signal2)
+template <typename T, typename Allocator>
+void swap(signal<T, Allocator>& signal1, signal<T, Allocator>& signal2)
 {
     using std::swap;
     swap(signal1.m_sample_rate, signal2.m_sample_rate);
@@ -0,0 +1,567 @@
+#pragma once
+
+#include "aligned_allocator.hpp"
+#include "impl/type_traits.hpp"
+#include "signal_view.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <complex>
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace tnt::dsp
+{
+
+template <typename T, typename Allocator>
+class signal;
+
+template <typename Op, typename... Operands>
+class signal_expression;
+
+namespace impl
+{
+
+template <typename T>
+struct is_signal : std::false_type
+{};
+
+template <typename T, typename Allocator>
+struct is_signal<signal<T, Allocator>> : std::true_type
+{};
+
+template <typename T>
+struct is_signal_view : std::false_type
+{};
+
+template <typename T>
+struct is_signal_view<signal_view<T>> : std::true_type
+{};
+
+template <typename T>
+struct is_signal_expression : std::false_type
+{};
+
+template <typename Op, typename... Operands>
+struct is_signal_expression<signal_expression<Op, Operands...>> : std::true_type
+{};
+
+// Anything that has one sample per index: signals, views and expressions
+template <typename T>
+constexpr bool is_signal_like_v = is_signal<std::decay_t<T>>::value ||
+                                  is_signal_view<std::decay_t<T>>::value ||
+                                  is_signal_expression<std::decay_t<T>>::value;
+
+// Values that are applied to every sample
+template <typename T>
+constexpr bool is_scalar_v = std::is_arithmetic_v<std::decay_t<T>> || is_complex_v<std::decay_t<T>>;
+
+// Operand pairs accepted by the arithmetic operators
+template <typename L, typename R>
+constexpr bool is_operand_pair_v =
+    (is_signal_like_v<L> && (is_signal_like_v<R> || is_scalar_v<R>)) ||
+    (is_scalar_v<L> && is_signal_like_v<R>);
+
+// Refers to the samples of a signal that outlives the expression
+template <typename T>
+class reference_operand final
+{
+public:
+    template <typename Allocator>
+    explicit reference_operand(const signal<T, Allocator>& x)
+        : m_data(x.data())
+        , m_size(x.size())
+        , m_sample_rate(x.sample_rate())
+    {}
+
+    const T& operator[](const size_t n) const
+    {
+        return m_data[n];
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    size_t sample_rate() const
+    {
+        return m_sample_rate;
+    }
+
+private:
+    const T* m_data;
+    size_t   m_size;
+    size_t   m_sample_rate;
+};
+
+// Owns a temporary signal so that it lives as long as the expression
+template <typename S>
+class value_operand final
+{
+public:
+    explicit value_operand(S&& x)
+        : m_signal(std::move(x))
+    {}
+
+    const typename S::value_type& operator[](const size_t n) const
+    {
+        return m_signal.data()[n];
+    }
+
+    size_t size() const
+    {
+        return m_signal.size();
+    }
+
+    size_t sample_rate() const
+    {
+        return m_signal.sample_rate();
+    }
+
+private:
+    S m_signal;
+};
+
+// Applies the same value at every index
+template <typename T>
+class scalar_operand final
+{
+public:
+    explicit scalar_operand(const T& value)
+        : m_value(value)
+    {}
+
+    T operator[](const size_t) const
+    {
+        return m_value;
+    }
+
+private:
+    T m_value;
+};
+
+template <typename T>
+struct is_scalar_operand : std::false_type
+{};
+
+template <typename T>
+struct is_scalar_operand<scalar_operand<T>> : std::true_type
+{};
+
+// Number of samples that buffered operands generate at a time
+inline constexpr size_t expression_block_size = 512;
+
+// Operands that generate their samples a block at a time (rather than
+// calculating each one on its own) declare a constant named buffered. Before
+// the samples of a block are read with prepared(), prepare() is called with
+// the range of the block.
+template <typename O, typename = void>
+struct is_buffered : std::false_type
+{};
+
+template <typename O>
+struct is_buffered<O, std::void_t<decltype(O::buffered)>> : std::bool_constant<O::buffered>
+{};
+
+template <typename O>
+constexpr bool is_buffered_v = is_buffered<O>::value;
+
+template <typename O>
+void prepare(const O& o, const size_t first, const size_t count)
+{
+    if constexpr (is_buffered_v<O>)
+    {
+        o.prepare(first, count);
+    }
+}
+
+template <typename O>
+decltype(auto) prepared(const O& o, const size_t n)
+{
+    if constexpr (is_buffered_v<O>)
+    {
+        return o.prepared(n);
+    }
+    else
+    {
+        return o[n];
+    }
+}
+
+// Gets the type of the samples produced by an operand
+template <typename O>
+using operand_value_t = std::decay_t<decltype(std::declval<const O&>()[0])>;
+
+// Gets the type a scalar is converted to before it is applied to samples of
+// type V, so that e.g. float signals are not promoted by double scalars
+template <typename V, typename S>
+using scalar_type_t = std::conditional_t<is_complex_v<std::decay_t<S>>,
+                                         std::complex<real_type_t<V>>,
+                                         real_type_t<V>>;
+
+// Wraps a signal, view or expression as an expression operand. Signals are
+// referenced unless they are temporaries, in which case they are moved into
+// the expression.
+template <typename E>
+auto make_operand(E&& e)
+{
+    using D = std::decay_t<E>;
+
+    if constexpr (is_signal<D>::value)
+    {
+        if constexpr (std::is_lvalue_reference_v<E>)
+        {
+            return reference_operand<typename D::value_type>(e);
+        }
+        else
+        {
+            return value_operand<D>(std::move(e));
+        }
+    }
+    else
+    {
+        return D(std::forward<E>(e));
+    }
+}
+
+// Wraps any operand, converting scalars to suit samples of type V
+template <typename V, typename E>
+auto make_operand_for(E&& e)
+{
+    if constexpr (is_scalar_v<E>)
+    {
+        return scalar_operand<scalar_type_t<V, E>>(static_cast<scalar_type_t<V, E>>(e));
+    }
+    else
+    {
+        return make_operand(std::forward<E>(e));
+    }
+}
+
+template <typename Op, typename L, typename R>
+auto make_expression(L&& l, R&& r)
+{
+    if constexpr (is_scalar_v<L>)
+    {
+        auto r_o = make_operand(std::forward<R>(r));
+        auto l_o = make_operand_for<operand_value_t<decltype(r_o)>>(std::forward<L>(l));
+        return signal_expression<Op, decltype(l_o), decltype(r_o)>(std::move(l_o), std::move(r_o));
+    }
+    else
+    {
+        auto l_o = make_operand(std::forward<L>(l));
+        auto r_o = make_operand_for<operand_value_t<decltype(l_o)>>(std::forward<R>(r));
+        return signal_expression<Op, decltype(l_o), decltype(r_o)>(std::move(l_o), std::move(r_o));
+    }
+}
+
+template <typename Op, typename E>
+auto make_expression(E&& e)
+{
+    auto o = make_operand(std::forward<E>(e));
+    return signal_expression<Op, decltype(o)>(std::move(o));
+}
+
+// Writes op(y[n], e[n]) to y[n] for every sample. Expressions only read the
+// sample at the index being written, so e may refer to y.
+template <typename T, typename E, typename Op>
+void evaluate(T* const y, const size_t N, const E& e, const Op& op)
+{
+    if constexpr (is_buffered_v<E>)
+    {
+        for (size_t n_0 = 0; n_0 < N; n_0 += expression_block_size)
+        {
+            const auto end = std::min(N, n_0 + expression_block_size);
+
+            e.prepare(n_0, end - n_0);
+            for (size_t n = n_0; n < end; ++n)
+            {
+                y[n] = op(y[n], e.prepared(n));
+            }
+        }
+    }
+    else
+    {
+        for (size_t n = 0; n < N; ++n)
+        {
+            y[n] = op(y[n], e[n]);
+        }
+    }
+}
+
+// Writes e[n] to y[n] for every sample
+template <typename T, typename E>
+void evaluate(T* const y, const size_t N, const E& e)
+{
+    if constexpr (is_buffered_v<E>)
+    {
+        for (size_t n_0 = 0; n_0 < N; n_0 += expression_block_size)
+        {
+            const auto end = std::min(N, n_0 + expression_block_size);
+
+            e.prepare(n_0, end - n_0);
+            for (size_t n = n_0; n < end; ++n)
+            {
+                y[n] = e.prepared(n);
+            }
+        }
+    }
+    else
+    {
+        for (size_t n = 0; n < N; ++n)
+        {
+            y[n] = e[n];
+        }
+    }
+}
+
+// Gets a view of the samples of a signal, view or expression. Expressions are
+// evaluated into storage drawn from the frame, so they can be passed to
+// functions that take views without allocating a signal.
+template <typename E>
+auto const_view(const E& e, scratch_frame& frame)
+{
+    using T = std::remove_cv_t<typename E::value_type>;
+
+    if constexpr (is_signal_expression<E>::value)
+    {
+        auto* const y = frame.allocate<T>(e.size());
+        evaluate(y, e.size(), e);
+
+        return signal_view<const T>(e.sample_rate(), y, e.size());
+    }
+    else if constexpr (is_signal<E>::value)
+    {
+        return e.view();
+    }
+    else
+    {
+        return signal_view<const T>(e);
+    }
+}
+
+}  // namespace impl
+
+/*!
+\brief Lazily evaluated element-wise operation on signals
+
+Expressions are created by the arithmetic operators on signals, views, and other expressions. No
+samples are calculated until the expression is assigned to a signal, at which point the whole
+expression is evaluated in a single loop that writes directly into the signal. Expressions refer to
+the signals they are created from (unless those signals are temporaries), so they should be
+evaluated before those signals go out of scope.
+*/
+template <typename Op, typename... Operands>
+class signal_expression final
+{
+public:
+    /*!
+    \brief Size type
+    */
+    using size_type = size_t;
+
+    /*!
+    \brief Value type
+    */
+    using value_type = std::decay_t<decltype(
+        std::declval<const Op&>()(std::declval<const Operands&>()[0]...))>;
+
+    /*!
+    \brief Constructor
+    \param[in] operands Operands of the operation
+    */
+    explicit signal_expression(Operands... operands)
+        : m_operands(std::move(operands)...)
+    {
+        assert(this->consistent());
+    }
+
+    /*!
+    \brief Calculates the sample at the specified index
+    \return Sample of the result
+    */
+    value_type operator[](const size_type& index) const
+    {
+        return std::apply(
+            [&](const auto&... operands) {
+                return Op()(operands[index]...);
+            },
+            m_operands);
+    }
+
+    /*!
+    \brief Whether any operand generates its samples a block at a time
+    */
+    static constexpr bool buffered = (impl::is_buffered_v<Operands> || ...);
+
+    /*!
+    \brief Generates a block of samples in operands that produce them a block at a time
+
+    Blocks are consecutive ranges of at most 512 samples. Operands that generate their samples
+    sequentially (such as lazy waves) carry on from one block to the next, which is much faster than
+    calculating every sample on its own with operator[].
+
+    \param[in] first Index of the first sample of the block
+    \param[in] count Number of samples in the block
+    */
+    void prepare(const size_type first, const size_type count) const
+    {
+        std::apply(
+            [&](const auto&... operands) {
+                (impl::prepare(operands, first, count), ...);
+            },
+            m_operands);
+    }
+
+    /*!
+    \brief Calculates a sample of the block passed to the last call of prepare()
+    \return Sample of the result
+    */
+    value_type prepared(const size_type& index) const
+    {
+        return std::apply(
+            [&](const auto&... operands) {
+                return Op()(impl::prepared(operands, index)...);
+            },
+            m_operands);
+    }
+
+    /*!
+    \brief Gets the duration of the result in seconds
+    \return Duration
+    */
+    double duration() const
+    {
+        return this->size() / static_cast<double>(this->sample_rate());
+    }
+
+    /*!
+    \brief Gets the sample rate
+    \return Sample rate
+    */
+    size_t sample_rate() const
+    {
+        return this->signal_operand().sample_rate();
+    }
+
+    /*!
+    \brief Gets the size
+    \return Number of samples in the result
+    */
+    size_type size() const
+    {
+        return this->signal_operand().size();
+    }
+
+private:
+    // Gets the first operand that is not a scalar (there is always one)
+    template <size_t I = 0>
+    const auto& signal_operand() const
+    {
+        using O = std::tuple_element_t<I, std::tuple<Operands...>>;
+
+        if constexpr (impl::is_scalar_operand<O>::value)
+        {
+            return this->signal_operand<I + 1>();
+        }
+        else
+        {
+            return std::get<I>(m_operands);
+        }
+    }
+
+    // Checks that all non-scalar operands have the same size and sample rate
+    bool consistent() const
+    {
+        return std::apply(
+            [&](const auto&... operands) {
+                return (this->consistent(operands) && ...);
+            },
+            m_operands);
+    }
+
+    template <typename O>
+    bool consistent(const O& operand) const
+    {
+        if constexpr (impl::is_scalar_operand<O>::value)
+        {
+            return true;
+        }
+        else
+        {
+            return operand.size() == this->size() &&
+                   operand.sample_rate() == this->sample_rate();
+        }
+    }
+
+    std::tuple<Operands...> m_operands;
+};
+
+/*!
+\brief Evaluates an expression into a new signal
+\param[in] e Expression to evaluate
+\return Signal containing the result
+*/
+template <typename Op, typename... Operands>
+signal<typename signal_expression<Op, Operands...>::value_type,
+       aligned_allocator<typename signal_expression<Op, Operands...>::value_type>>
+evaluate(const signal_expression<Op, Operands...>& e)
+{
+    return e;
+}
+
+/*!
+\brief Adds two signals (or a signal and a scalar) sample by sample
+\return Expression representing \a l + \a r
+*/
+template <typename L, typename R, typename = std::enable_if_t<impl::is_operand_pair_v<L, R>>>
+auto operator+(L&& l, R&& r)
+{
+    return impl::make_expression<std::plus<>>(std::forward<L>(l), std::forward<R>(r));
+}
+
+/*!
+\brief Subtracts two signals (or a signal and a scalar) sample by sample
+\return Expression representing \a l - \a r
+*/
+template <typename L, typename R, typename = std::enable_if_t<impl::is_operand_pair_v<L, R>>>
+auto operator-(L&& l, R&& r)
+{
+    return impl::make_expression<std::minus<>>(std::forward<L>(l), std::forward<R>(r));
+}
+
+/*!
+\brief Multiplies two signals (or a signal and a scalar) sample by sample
+\return Expression representing \a l * \a r
+*/
+template <typename L, typename R, typename = std::enable_if_t<impl::is_operand_pair_v<L, R>>>
+auto operator*(L&& l, R&& r)
+{
+    return impl::make_expression<std::multiplies<>>(std::forward<L>(l), std::forward<R>(r));
+}
+
+/*!
+\brief Divides two signals (or a signal and a scalar) sample by sample
+\return Expression representing \a l / \a r
+*/
+template <typename L, typename R, typename = std::enable_if_t<impl::is_operand_pair_v<L, R>>>
+auto operator/(L&& l, R&& r)
+{
+    return impl::make_expression<std::divides<>>(std::forward<L>(l), std::forward<R>(r));
+}
+
+/*!
+\brief Negates a signal sample by sample
+\return Expression representing -\a x
+*/
+template <typename E, typename = std::enable_if_t<impl::is_signal_like_v<E>>>
+auto operator-(E&& x)
+{
+    return impl::make_expression<std::negate<>>(std::forward<E>(x));
+}
+
+}  // namespace tnt::dsp
@@ -1,15 +1,146 @@
 #pragma once
 
+#include "impl/oscillator.hpp"
+#include "impl/random.hpp"
 #include "signal.hpp"
 
+#include <cassert>
 #include <cmath>
 #include <complex>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace tnt::dsp
 {
 
+namespace impl
+{
+
+struct cosine_map
+{
+    template <typename T>
+    T operator()(const T& re, const T&) const
+    {
+        return re;
+    }
+};
+
+struct sine_map
+{
+    template <typename T>
+    T operator()(const T&, const T& im) const
+    {
+        return im;
+    }
+};
+
+struct complex_exponential_map
+{
+    template <typename T>
+    std::complex<T> operator()(const T& re, const T& im) const
+    {
+        return {re, im};
+    }
+};
+
+struct identity_map
+{
+    template <typename T>
+    T operator()(const T& sample) const
+    {
+        return sample;
+    }
+};
+
+// Produces the samples of a wave on demand, as an operand of an expression.
+// Blocks are generated by a phasor bank that carries on from one block to the
+// next, so a wave that is evaluated block by block costs no more than one that
+// is generated into a signal. Samples read outside of a block are calculated
+// on their own.
+template <typename T, typename Map>
+class wave_operand final
+{
+public:
+    static constexpr bool buffered = true;
+
+    using value_type = std::decay_t<std::invoke_result_t<const Map&, const T&, const T&>>;
+
+    wave_operand(const size_t sample_rate,
+                 const size_t size,
+                 const double phase,
+                 const double omega,
+                 const T      amplitude)
+        : m_sample_rate(sample_rate)
+        , m_size(size)
+        , m_amplitude(amplitude)
+        , m_bank(phase, omega)
+        , m_first()
+    {}
+
+    value_type operator[](const size_t n) const
+    {
+        const auto theta = m_bank.phase() + m_bank.omega() * static_cast<double>(n);
+
+        return Map()(m_amplitude * static_cast<T>(std::cos(theta)),
+                     m_amplitude * static_cast<T>(std::sin(theta)));
+    }
+
+    void prepare(const size_t first, const size_t count) const
+    {
+        assert(count <= expression_block_size);
+
+        auto* const y     = m_block;
+        const auto  a     = m_amplitude;
+        const auto  store = [=](const size_t n, const T& re, const T& im) {
+            y[n - first] = Map()(a * re, a * im);
+        };
+
+        m_bank.generate(first, count, store);
+        m_first = first;
+    }
+
+    const value_type& prepared(const size_t n) const
+    {
+        return m_block[n - m_first];
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    size_t sample_rate() const
+    {
+        return m_sample_rate;
+    }
+
+private:
+    size_t                 m_sample_rate;
+    size_t                 m_size;
+    T                      m_amplitude;
+    mutable phasor_bank<T> m_bank;
+    mutable size_t         m_first;
+
+    alignas(cache_line_size) mutable value_type m_block[expression_block_size];
+};
+
+// Expression that produces the samples of a wave on demand
+template <typename T, typename Map>
+using wave_expression = signal_expression<identity_map, wave_operand<T, Map>>;
+
+}  // namespace impl
+
 /*!
 \brief Generates signals of similar sample rates/sizes
+
+Waves are generated with a bank of rotating phasors instead of calling std::sin and std::cos for
+every sample, so generation costs a few multiplications per sample and vectorizes.
+
+Noise is drawn from a bank of xoshiro256++ generators that are advanced side by side. The same seed
+always gives the same signal. Different streams of the same seed never overlap, so long signals can
+be generated in parallel by giving each block (or channel) its own stream.
 */
 template <typename T>
 class signal_generator final
@@ -22,7 +153,6 @@ public:
     */
     signal_generator(size_t sample_rate, size_t size)
         : m_sample_rate(sample_rate)
-        , m_sample_interval(1 / static_cast<T>(m_sample_rate))
         , m_size(size)
     {}
 
@@ -53,14 +183,14 @@ public:
     */
     signal<T> cosine(T frequency, T amplitude = 1, T phase_shift = 0, T vertical_shift = 0) const
     {
-        signal<T> signal(m_sample_rate, m_size);
-        for (size_t n = 0; n < signal.size(); ++n)
-        {
-            signal[n] = amplitude
-                          * std::cos(2 * static_cast<T>(M_PI) * frequency * n * m_sample_interval
-                                     + phase_shift)
-                      + vertical_shift;
-        }
+        signal<T> signal(m_sample_rate, m_size, uninitialized);
+
+        auto* const y     = signal.data();
+        const auto  store = [=](const size_t n, const T& re, const T&) {
+            y[n] = amplitude * re + vertical_shift;
+        };
+
+        impl::oscillate<T>(phase_shift, this->angular_frequency(frequency), m_size, store);
 
         return signal;
     }
@@ -73,22 +203,300 @@ public:
     \param[in] vertical_shift Vertical shift
     */
     signal<T> sine(T frequency, T amplitude = 1, T phase_shift = 0, T vertical_shift = 0) const
+    {
+        signal<T> signal(m_sample_rate, m_size, uninitialized);
+
+        auto* const y     = signal.data();
+        const auto  store = [=](const size_t n, const T&, const T& im) {
+            y[n] = amplitude * im + vertical_shift;
+        };
+
+        impl::oscillate<T>(phase_shift, this->angular_frequency(frequency), m_size, store);
+
+        return signal;
+    }
+
+    /*!
+    \brief Generates a complex exponential
+    \param[in] frequency Frequency in Hz (negative frequencies rotate clockwise)
+    \param[in] amplitude Amplitude
+    \param[in] phase_shift Phase shift
+    */
+    signal<std::complex<T>> complex_exponential(T frequency,
+                                                T amplitude   = 1,
+                                                T phase_shift = 0) const
+    {
+        signal<std::complex<T>> signal(m_sample_rate, m_size, uninitialized);
+
+        // Written as interleaved real/imaginary pairs so that the stores vectorize
+        auto* const y     = reinterpret_cast<T*>(signal.data());
+        const auto  store = [=](const size_t n, const T& re, const T& im) {
+            y[2 * n]     = amplitude * re;
+            y[2 * n + 1] = amplitude * im;
+        };
+
+        impl::oscillate<T>(phase_shift, this->angular_frequency(frequency), m_size, store);
+
+        return signal;
+    }
+
+    /*!
+    \brief Generates a linear chirp (a cosine wave whose frequency changes linearly)
+    \param[in] start_frequency Frequency of the first sample in Hz
+    \param[in] end_frequency Frequency of the last sample in Hz
+    \param[in] amplitude Amplitude
+    \param[in] phase_shift Phase shift
+    */
+    signal<T> linear_chirp(T start_frequency,
+                           T end_frequency,
+                           T amplitude   = 1,
+                           T phase_shift = 0) const
+    {
+        signal<T> signal(m_sample_rate, m_size, uninitialized);
+
+        const auto omega_0 = this->angular_frequency(start_frequency);
+        const auto omega_1 = this->angular_frequency(end_frequency);
+        const auto delta   = m_size > 1 ? (omega_1 - omega_0) / static_cast<double>(m_size - 1) : 0;
+
+        auto* const y     = signal.data();
+        const auto  store = [=](const size_t n, const T& re, const T&) {
+            y[n] = amplitude * re;
+        };
+
+        impl::sweep<T>(phase_shift, omega_0, delta, m_size, store);
+
+        return signal;
+    }
+
+    /*!
+    \brief Generates a logarithmic chirp (a cosine wave whose frequency changes exponentially)
+
+    Each octave takes the same amount of time, which makes logarithmic chirps well suited to
+    measuring frequency responses. Unlike the other waves the phase of every sample is calculated
+    directly, so this is not faster than calling std::cos.
+
+    \param[in] start_frequency Frequency of the first sample in Hz (must be positive)
+    \param[in] end_frequency Frequency of the last sample in Hz (must be positive)
+    \param[in] amplitude Amplitude
+    \param[in] phase_shift Phase shift
+    */
+    signal<T> logarithmic_chirp(T start_frequency,
+                                T end_frequency,
+                                T amplitude   = 1,
+                                T phase_shift = 0) const
+    {
+        assert(start_frequency > 0 && end_frequency > 0);
+
+        if (m_size < 2 || start_frequency == end_frequency)
+        {
+            return this->cosine(start_frequency, amplitude, phase_shift);
+        }
+
+        signal<T> signal(m_sample_rate, m_size, uninitialized);
+
+        // theta[n] = phase_shift + omega_0 * (r^n - 1) / ln(r)
+        const auto ratio   = static_cast<double>(end_frequency) / start_frequency;
+        const auto log_r   = std::log(ratio) / static_cast<double>(m_size - 1);
+        const auto omega_0 = this->angular_frequency(start_frequency);
+        const auto scale   = omega_0 / log_r;
+
+        for (size_t n = 0; n < m_size; ++n)
+        {
+            const auto theta = phase_shift + scale * std::expm1(log_r * static_cast<double>(n));
+            signal[n]        = amplitude * static_cast<T>(std::cos(theta));
+        }
+
+        return signal;
+    }
+
+    /*!
+    \brief Generates the sum of several cosine waves of equal amplitude
+
+    The waves are given Schroeder phases (the k-th of K waves is shifted by -pi * k * (k - 1) / K),
+    which keeps the peaks of the sum low.
+
+    \param[in] frequencies Frequency of each wave in Hz
+    \param[in] amplitude Amplitude of each wave
+    */
+    signal<T> multitone(const std::vector<T>& frequencies, T amplitude = 1) const
     {
         signal<T> signal(m_sample_rate, m_size);
-        for (size_t n = 0; n < signal.size(); ++n)
+
+        const auto K = static_cast<double>(frequencies.size());
+
+        auto* const y     = signal.data();
+        const auto  store = [=](const size_t n, const T& re, const T&) {
+            y[n] += amplitude * re;
+        };
+
+        for (size_t k = 0; k < frequencies.size(); ++k)
         {
-            signal[n] = amplitude
-                          * std::sin(2 * static_cast<T>(M_PI) * frequency * n * m_sample_interval
-                                     + phase_shift)
-                      + vertical_shift;
+            const auto phase = -M_PI * static_cast<double>(k) * static_cast<double>(k - 1) / K;
+            impl::oscillate<T>(phase, this->angular_frequency(frequencies[k]), m_size, store);
         }
 
         return signal;
     }
 
+    /*!
+    \brief Generates white noise with a uniform distribution
+    \param[in] amplitude Samples are drawn from [-amplitude, amplitude)
+    \param[in] seed Seed of the random sequence
+    \param[in] stream Stream of the random sequence (streams never overlap)
+    */
+    signal<T> white_noise(T amplitude = 1, uint64_t seed = 0, uint64_t stream = 0) const
+    {
+        signal<T> signal(m_sample_rate, m_size, uninitialized);
+
+        auto* const y     = signal.data();
+        const auto  store = [=](const size_t n, const T& u) {
+            y[n] = amplitude * (2 * u - 1);
+        };
+
+        impl::uniform_noise<T>(seed, stream, m_size, store);
+
+        return signal;
+    }
+
+    /*!
+    \brief Generates white noise with a normal distribution
+    \param[in] standard_deviation Standard deviation
+    \param[in] seed Seed of the random sequence
+    \param[in] stream Stream of the random sequence (streams never overlap)
+    */
+    signal<T> gaussian_noise(T standard_deviation = 1, uint64_t seed = 0, uint64_t stream = 0) const
+    {
+        signal<T> signal(m_sample_rate, m_size, uninitialized);
+
+        auto* const y     = signal.data();
+        const auto  store = [=](const size_t n, const T& z) {
+            y[n] = standard_deviation * z;
+        };
+
+        impl::gaussian_noise<T>(seed, stream, m_size, store);
+
+        return signal;
+    }
+
+    /*!
+    \brief Generates pink noise (noise whose power falls by 3 dB per octave)
+
+    Gaussian white noise is shaped with Paul Kellet's filter, which is accurate to within 0.05 dB
+    above about 1/5000 of the sample rate. The result is scaled to the requested RMS level.
+
+    \param[in] rms Root mean square level
+    \param[in] seed Seed of the random sequence
+    \param[in] stream Stream of the random sequence (streams never overlap)
+    */
+    signal<T> pink_noise(T rms = 1, uint64_t seed = 0, uint64_t stream = 0) const
+    {
+        auto signal = this->gaussian_noise(1, seed, stream);
+
+        T b_0 = 0;
+        T b_1 = 0;
+        T b_2 = 0;
+        T b_3 = 0;
+        T b_4 = 0;
+        T b_5 = 0;
+        T b_6 = 0;
+
+        double energy = 0;
+        for (auto& sample : signal)
+        {
+            const auto white = sample;
+
+            b_0 = static_cast<T>(0.99886) * b_0 + white * static_cast<T>(0.0555179);
+            b_1 = static_cast<T>(0.99332) * b_1 + white * static_cast<T>(0.0750759);
+            b_2 = static_cast<T>(0.96900) * b_2 + white * static_cast<T>(0.1538520);
+            b_3 = static_cast<T>(0.86650) * b_3 + white * static_cast<T>(0.3104856);
+            b_4 = static_cast<T>(0.55000) * b_4 + white * static_cast<T>(0.5329522);
+            b_5 = static_cast<T>(-0.7616) * b_5 - white * static_cast<T>(0.0168980);
+
+            sample = b_0 + b_1 + b_2 + b_3 + b_4 + b_5 + b_6 + white * static_cast<T>(0.5362);
+            b_6    = white * static_cast<T>(0.115926);
+
+            energy += static_cast<double>(sample) * sample;
+        }
+
+        if (energy > 0)
+        {
+            const auto mean  = energy / static_cast<double>(m_size);
+            const auto scale = static_cast<T>(rms / std::sqrt(mean));
+            for (auto& sample : signal)
+            {
+                sample *= scale;
+            }
+        }
+
+        return signal;
+    }
+
+    /*!
+    \brief Creates a cosine wave that is generated on demand
+
+    No samples are generated until the expression is evaluated, at which point they are generated
+    a block at a time inside the loop that evaluates it. Mixing the wave into a signal (for example
+    x * generator.lazy_cosine(f)) therefore never stores the whole wave. The expression holds
+    everything it needs, so it can outlive the generator.
+
+    \param[in] frequency Frequency in Hz
+    \param[in] amplitude Amplitude
+    \param[in] phase_shift Phase shift
+    \return Expression representing the cosine wave
+    */
+    auto lazy_cosine(T frequency, T amplitude = 1, T phase_shift = 0) const
+    {
+        return this->template lazy_wave<impl::cosine_map>(frequency, amplitude, phase_shift);
+    }
+
+    /*!
+    \brief Creates a sine wave that is generated on demand (see lazy_cosine())
+    \param[in] frequency Frequency in Hz
+    \param[in] amplitude Amplitude
+    \param[in] phase_shift Phase shift
+    \return Expression representing the sine wave
+    */
+    auto lazy_sine(T frequency, T amplitude = 1, T phase_shift = 0) const
+    {
+        return this->template lazy_wave<impl::sine_map>(frequency, amplitude, phase_shift);
+    }
+
+    /*!
+    \brief Creates a complex exponential that is generated on demand (see lazy_cosine())
+    \param[in] frequency Frequency in Hz (negative frequencies rotate clockwise)
+    \param[in] amplitude Amplitude
+    \param[in] phase_shift Phase shift
+    \return Expression representing the complex exponential
+    */
+    auto lazy_complex_exponential(T frequency, T amplitude = 1, T phase_shift = 0) const
+    {
+        return this->template lazy_wave<impl::complex_exponential_map>(frequency,
+                                                                       amplitude,
+                                                                       phase_shift);
+    }
+
 private:
+    template <typename Map>
+    impl::wave_expression<T, Map> lazy_wave(const T& frequency,
+                                            const T& amplitude,
+                                            const T& phase_shift) const
+    {
+        impl::wave_operand<T, Map> wave(m_sample_rate,
+                                        m_size,
+                                        phase_shift,
+                                        this->angular_frequency(frequency),
+                                        amplitude);
+
+        return impl::wave_expression<T, Map>(std::move(wave));
+    }
+
+    // Phase advance per sample (in radians) of a wave at the given frequency
+    double angular_frequency(const T& frequency) const
+    {
+        return 2 * M_PI * static_cast<double>(frequency) / static_cast<double>(m_sample_rate);
+    }
+
     size_t m_sample_rate;
-    T      m_sample_interval;
     size_t m_size;
 };
 
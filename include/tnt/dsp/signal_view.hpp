@@ -0,0 +1,329 @@
+#pragma once
+
+#include "workspace.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace tnt::dsp
+{
+
+/*!
+\brief Non-owning view of sampled data
+
+A view refers to samples stored elsewhere (in a signal, a multi-channel signal, or an external
+buffer) without copying them. Samples may be spaced by a stride so that a view can select every
+other sample or a single channel of interleaved data. The viewed samples must outlive the view.
+
+Views of constant samples (signal_view<const T>) are accepted by every function that reads a signal.
+*/
+template <typename T>
+class signal_view final
+{
+public:
+    /*!
+    \brief Value type
+    */
+    using value_type = std::remove_cv_t<T>;
+
+    /*!
+    \brief Size type
+    */
+    using size_type = size_t;
+
+    /*!
+    \brief Difference type
+    */
+    using difference_type = std::ptrdiff_t;
+
+    /*!
+    \brief Iterator over the viewed samples
+    */
+    class iterator final
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = std::remove_cv_t<T>;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = T*;
+        using reference         = T&;
+
+        iterator() = default;
+
+        iterator(T* const data, const difference_type& stride)
+            : m_data(data)
+            , m_stride(stride)
+        {}
+
+        reference operator*() const
+        {
+            return *m_data;
+        }
+
+        pointer operator->() const
+        {
+            return m_data;
+        }
+
+        reference operator[](const difference_type& n) const
+        {
+            return m_data[n * m_stride];
+        }
+
+        iterator& operator++()
+        {
+            m_data += m_stride;
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            auto it = *this;
+            ++*this;
+            return it;
+        }
+
+        iterator& operator--()
+        {
+            m_data -= m_stride;
+            return *this;
+        }
+
+        iterator operator--(int)
+        {
+            auto it = *this;
+            --*this;
+            return it;
+        }
+
+        iterator& operator+=(const difference_type& n)
+        {
+            m_data += n * m_stride;
+            return *this;
+        }
+
+        iterator& operator-=(const difference_type& n)
+        {
+            m_data -= n * m_stride;
+            return *this;
+        }
+
+        friend iterator operator+(iterator it, const difference_type& n)
+        {
+            return it += n;
+        }
+
+        friend iterator operator+(const difference_type& n, iterator it)
+        {
+            return it += n;
+        }
+
+        friend iterator operator-(iterator it, const difference_type& n)
+        {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const iterator& it1, const iterator& it2)
+        {
+            return (it1.m_data - it2.m_data) / it1.m_stride;
+        }
+
+        friend bool operator==(const iterator& it1, const iterator& it2)
+        {
+            return it1.m_data == it2.m_data;
+        }
+
+        friend bool operator!=(const iterator& it1, const iterator& it2)
+        {
+            return it1.m_data != it2.m_data;
+        }
+
+        friend bool operator<(const iterator& it1, const iterator& it2)
+        {
+            return it2 - it1 > 0;
+        }
+
+        friend bool operator>(const iterator& it1, const iterator& it2)
+        {
+            return it2 < it1;
+        }
+
+        friend bool operator<=(const iterator& it1, const iterator& it2)
+        {
+            return !(it2 < it1);
+        }
+
+        friend bool operator>=(const iterator& it1, const iterator& it2)
+        {
+            return !(it1 < it2);
+        }
+
+    private:
+        T*              m_data   = nullptr;
+        difference_type m_stride = 1;
+    };
+
+    /*!
+    \brief Constructor
+    \param[in] sample_rate Sample rate
+    \param[in] data Pointer to the first sample
+    \param[in] size Number of samples
+    \param[in] stride Distance (in elements) between consecutive samples
+    */
+    signal_view(const size_t           sample_rate,
+                T* const               data,
+                const size_type&       size,
+                const difference_type& stride = 1)
+        : m_sample_rate(sample_rate)
+        , m_data(data)
+        , m_size(size)
+        , m_stride(stride)
+    {
+        assert(stride != 0);
+    }
+
+    /*!
+    \brief Creates a view of constant samples from a view of mutable samples
+    \param[in] view View of mutable samples
+    */
+    template <typename U,
+              typename = std::enable_if_t<std::is_same_v<T, const U> && !std::is_const_v<U>>>
+    signal_view(const signal_view<U>& view)
+        : signal_view(view.sample_rate(), view.data(), view.size(), view.stride())
+    {}
+
+    /*!
+    \brief Gets the duration of the viewed samples in seconds
+    \return Duration
+    */
+    double duration() const
+    {
+        return this->size() / static_cast<double>(this->sample_rate());
+    }
+
+    /*!
+    \brief Gets the sample rate
+    \return Sample rate
+    */
+    size_t sample_rate() const
+    {
+        return m_sample_rate;
+    }
+
+    /*!
+    \brief Accesses the sample at the specified index
+    \return Reference to the requested sample
+    */
+    T& operator[](const size_type& index) const
+    {
+        assert(index < this->size());
+        return m_data[static_cast<difference_type>(index) * m_stride];
+    }
+
+    /*!
+    \brief Gets a pointer to the first sample
+    \return Pointer to the first sample
+    */
+    T* data() const
+    {
+        return m_data;
+    }
+
+    /*!
+    \brief Gets an iterator to the beginning of the view
+    \return Iterator to the first sample
+    */
+    iterator begin() const
+    {
+        return iterator(m_data, m_stride);
+    }
+
+    /*!
+    \brief Gets an iterator to the end of the view
+    \return Iterator to the sample *following* the last sample
+    */
+    iterator end() const
+    {
+        return iterator(m_data + static_cast<difference_type>(m_size) * m_stride, m_stride);
+    }
+
+    /*!
+    \brief Gets the number of samples
+    \return Size
+    */
+    size_type size() const
+    {
+        return m_size;
+    }
+
+    /*!
+    \brief Gets the distance (in elements) between consecutive samples
+    \return Stride
+    */
+    difference_type stride() const
+    {
+        return m_stride;
+    }
+
+    /*!
+    \brief Checks whether the samples are stored contiguously
+    \return True if the stride is 1
+    */
+    bool contiguous() const
+    {
+        return m_stride == 1;
+    }
+
+    /*!
+    \brief Creates a view of a range of the viewed samples
+    \param[in] first Index of the first sample in the range
+    \param[in] size Number of samples in the range
+    \param[in] step Distance (in samples) between consecutive samples in the range
+    \return View of the samples first, first + step, ..., first + (size - 1) * step
+    */
+    signal_view subview(const size_type&       first,
+                        const size_type&       size,
+                        const difference_type& step = 1) const
+    {
+        assert(step > 0);
+        assert(size == 0 || first + (size - 1) * static_cast<size_type>(step) < this->size());
+
+        return signal_view(m_sample_rate,
+                           m_data + static_cast<difference_type>(first) * m_stride,
+                           size,
+                           m_stride * step);
+    }
+
+private:
+    size_t          m_sample_rate;
+    T*              m_data;
+    size_type       m_size;
+    difference_type m_stride;
+};
+
+namespace impl
+{
+
+// Gets a pointer to the viewed samples stored contiguously. Strided samples
+// are gathered into storage drawn from the frame, contiguous samples are used
+// where they are.
+template <typename T>
+const std::remove_cv_t<T>* contiguous(const signal_view<T>& x, scratch_frame& frame)
+{
+    if (x.contiguous())
+    {
+        return x.data();
+    }
+
+    auto* const buffer = frame.allocate<std::remove_cv_t<T>>(x.size());
+    std::copy(x.begin(), x.end(), buffer);
+
+    return buffer;
+}
+
+}  // namespace impl
+
+}  // namespace tnt::dsp
@@ -0,0 +1,296 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tnt::dsp
+{
+
+/*!
+\brief Pool of persistent worker threads that share work by stealing
+
+Every worker owns a queue of tasks. Workers take tasks from the back of their own queue and, once it
+is empty, steal from the front of the other queues, so uneven tasks still keep every thread busy.
+The thread that submits work runs tasks too instead of sitting idle until they are finished.
+
+Workers live as long as the pool, so the FFT plans and workspaces they build up (both of which are
+kept per thread) are reused from one batch of work to the next.
+*/
+class thread_pool final
+{
+public:
+    /*!
+    \brief Constructor
+    \param[in] threads Number of threads that run tasks, including the thread that submits them
+    */
+    explicit thread_pool(const size_t threads = default_concurrency())
+        : m_pending()
+        , m_stop()
+    {
+        const auto workers = std::max<size_t>(1, threads) - 1;
+
+        for (size_t w = 0; w < workers; ++w)
+        {
+            m_queues.push_back(std::make_unique<task_queue>());
+        }
+
+        for (size_t w = 0; w < workers; ++w)
+        {
+            m_workers.emplace_back([this, w] {
+                this->work(w);
+            });
+        }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    /*!
+    \brief Destructor
+
+    Waits for queued tasks to finish before the workers are joined.
+    */
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+
+        m_wake.notify_all();
+
+        for (auto& worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    /*!
+    \brief Calls a function once for each index in [0, count) and waits for all of the calls
+
+    Calls are spread across the pool and may run in any order and at the same time, so the function
+    must be safe to call concurrently for different indices. If any call throws, the first
+    exception is rethrown once every call has finished.
+
+    \param[in] count Number of indices
+    \param[in] f Function taking the index
+    */
+    template <typename Function>
+    void parallel_for(const size_t count, const Function& f)
+    {
+        if (m_queues.empty() || count <= 1)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                f(i);
+            }
+
+            return;
+        }
+
+        batch b(f, count);
+
+        // Deal the indices out across the queues, taking each lock only once
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending += count;
+
+            for (size_t q = 0; q < m_queues.size(); ++q)
+            {
+                std::lock_guard<std::mutex> queue_lock(m_queues[q]->mutex);
+                for (auto i = q; i < count; i += m_queues.size())
+                {
+                    m_queues[q]->tasks.push_back({&b, i});
+                }
+            }
+        }
+
+        m_wake.notify_all();
+
+        // Help out until there is nothing left to take, then wait for the
+        // tasks that other threads are still running
+        task t;
+        while (b.remaining.load() > 0 && this->steal(0, t))
+        {
+            t.run();
+        }
+
+        std::unique_lock<std::mutex> lock(b.mutex);
+        b.done.wait(lock, [&] {
+            return b.remaining.load() == 0;
+        });
+
+        if (b.exception)
+        {
+            std::rethrow_exception(b.exception);
+        }
+    }
+
+    /*!
+    \brief Gets the number of threads that run tasks, including the thread that submits them
+    \return Number of threads
+    */
+    size_t size() const
+    {
+        return m_workers.size() + 1;
+    }
+
+    /*!
+    \brief Gets the number of threads the hardware can run at once
+    \return Number of hardware threads (at least 1)
+    */
+    static size_t default_concurrency()
+    {
+        return std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+private:
+    // Calls made by one parallel_for. It lives on the stack of the submitting
+    // thread, which does not return until every call has finished.
+    struct batch
+    {
+        template <typename Function>
+        batch(const Function& f, const size_t count)
+            : function(&f)
+            , invoke([](const void* g, const size_t i) {
+                (*static_cast<const Function*>(g))(i);
+            })
+            , remaining(count)
+        {}
+
+        const void* function;
+        void (*invoke)(const void*, size_t);
+
+        std::atomic<size_t>     remaining;
+        std::mutex              mutex;
+        std::condition_variable done;
+        std::exception_ptr      exception;
+    };
+
+    // A single call of a batch
+    struct task
+    {
+        void run() const
+        {
+            try
+            {
+                b->invoke(b->function, index);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(b->mutex);
+                if (!b->exception)
+                {
+                    b->exception = std::current_exception();
+                }
+            }
+
+            // Count down while holding the lock so that the submitting thread
+            // cannot see the batch finish (and destroy it) before this returns
+            std::lock_guard<std::mutex> lock(b->mutex);
+            if (--b->remaining == 0)
+            {
+                b->done.notify_all();
+            }
+        }
+
+        batch* b     = nullptr;
+        size_t index = 0;
+    };
+
+    struct task_queue
+    {
+        std::mutex       mutex;
+        std::deque<task> tasks;
+    };
+
+    // Takes a task from the back of a worker's own queue
+    bool pop(const size_t q, task& t)
+    {
+        std::lock_guard<std::mutex> lock(m_queues[q]->mutex);
+        if (m_queues[q]->tasks.empty())
+        {
+            return false;
+        }
+
+        t = m_queues[q]->tasks.back();
+        m_queues[q]->tasks.pop_back();
+        --m_pending;
+
+        return true;
+    }
+
+    // Takes a task from the front of any queue, starting with queue q
+    bool steal(const size_t q, task& t)
+    {
+        for (size_t k = 0; k < m_queues.size(); ++k)
+        {
+            auto& queue = *m_queues[(q + k) % m_queues.size()];
+
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty())
+            {
+                t = queue.tasks.front();
+                queue.tasks.pop_front();
+                --m_pending;
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void work(const size_t w)
+    {
+        for (;;)
+        {
+            task t;
+            if (this->pop(w, t) || this->steal(w + 1, t))
+            {
+                t.run();
+                continue;
+            }
+
+            // Tasks are counted before they are queued, so a worker never
+            // sleeps while a task is waiting
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] {
+                return m_stop || m_pending.load() > 0;
+            });
+
+            if (m_stop && m_pending.load() == 0)
+            {
+                return;
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<task_queue>> m_queues;
+    std::vector<std::thread>                 m_workers;
+    std::mutex                               m_mutex;
+    std::condition_variable                  m_wake;
+    std::atomic<size_t>                      m_pending;
+    bool                                     m_stop;
+};
+
+/*!
+\brief Gets the pool shared by the parallel algorithms
+\return Pool with one thread per hardware thread
+*/
+inline thread_pool& default_thread_pool()
+{
+    static thread_pool pool;
+    return pool;
+}
+
+}  // namespace tnt::dsp
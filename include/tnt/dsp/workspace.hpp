@@ -0,0 +1,305 @@
+#pragma once
+
+#include "aligned_allocator.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace tnt::dsp
+{
+
+/*!
+\brief Arena that supplies the temporary buffers used inside transforms and convolutions
+
+Storage is handed out by bumping an offset through large cache line aligned blocks, and is given
+back in bulk by releasing everything allocated after a marker. Blocks are kept when they are
+released, so once a workspace has grown to fit the largest operation no further heap allocations
+are made for temporaries.
+
+Every thread has its own workspace (see thread_workspace()), so concurrent workers never contend
+on the heap or on each other. A caller-owned workspace can be used instead with workspace_scope.
+*/
+class workspace final
+{
+public:
+    /*!
+    \brief Position in the workspace that storage can be released back to
+    */
+    class marker final
+    {
+        friend class workspace;
+
+        size_t m_block;
+        size_t m_offset;
+    };
+
+    /*!
+    \brief Constructor
+    \param[in] capacity Number of bytes to reserve up front
+    */
+    explicit workspace(const size_t capacity = 0)
+        : m_block()
+        , m_offset()
+    {
+        if (capacity > 0)
+        {
+            m_blocks.emplace_back(round_up(capacity));
+        }
+    }
+
+    workspace(const workspace&) = delete;
+
+    workspace& operator=(const workspace&) = delete;
+
+    /*!
+    \brief Destructor
+    */
+    ~workspace() = default;
+
+    /*!
+    \brief Allocates storage for elements that are left uninitialized
+    \param[in] count Number of elements
+    \return Pointer to the first element (aligned to a cache line)
+
+    Trivially copyable elements are not constructed at all (the default constructor of
+    std::complex would zero them), so the storage holds whatever it held before and must be
+    written before it is read. Other elements are default constructed.
+    */
+    template <typename T>
+    T* allocate(const size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "Elements are never destroyed");
+        static_assert(alignof(T) <= cache_line_size, "Elements must fit cache line alignment");
+
+        auto* const data = reinterpret_cast<T*>(this->allocate_bytes(count * sizeof(T)));
+        if constexpr (!std::is_trivially_copyable_v<T>)
+        {
+            std::uninitialized_default_construct_n(data, count);
+        }
+
+        return data;
+    }
+
+    /*!
+    \brief Marks the current position so that later allocations can be released
+    \return Marker for the current position
+    */
+    marker mark() const
+    {
+        marker m;
+        m.m_block  = m_block;
+        m.m_offset = m_offset;
+
+        return m;
+    }
+
+    /*!
+    \brief Releases all storage allocated since the marker was taken
+    \param[in] m Marker obtained from mark()
+    */
+    void release(const marker& m)
+    {
+        m_block  = m.m_block;
+        m_offset = m.m_offset;
+    }
+
+    /*!
+    \brief Releases all storage
+
+    If the workspace had to grow into several blocks, they are merged into a single block so that
+    the next round of allocations is contiguous. The workspace must not be reset while any storage
+    drawn from it is still in use.
+    */
+    void reset()
+    {
+        if (m_blocks.size() > 1)
+        {
+            const auto bytes = this->capacity();
+
+            m_blocks.clear();
+            m_blocks.emplace_back(bytes);
+        }
+
+        m_block  = 0;
+        m_offset = 0;
+    }
+
+    /*!
+    \brief Gets the number of bytes reserved
+    \return Capacity
+    */
+    size_t capacity() const
+    {
+        size_t bytes = 0;
+        for (const auto& block : m_blocks)
+        {
+            bytes += block.size();
+        }
+
+        return bytes;
+    }
+
+    /*!
+    \brief Gets the number of bytes in use
+    \return Bytes allocated and not yet released
+    */
+    size_t used() const
+    {
+        size_t bytes = m_offset;
+        for (size_t b = 0; b < std::min(m_block, m_blocks.size()); ++b)
+        {
+            bytes += m_blocks[b].size();
+        }
+
+        return bytes;
+    }
+
+private:
+    // Smallest block worth allocating
+    static constexpr size_t minimum_block_size = 16 * 1024;
+
+    // Rounds a number of bytes up to a whole number of cache lines so that
+    // every allocation starts on a cache line
+    static size_t round_up(const size_t bytes)
+    {
+        return (bytes + cache_line_size - 1) / cache_line_size * cache_line_size;
+    }
+
+    std::byte* allocate_bytes(size_t bytes)
+    {
+        bytes = round_up(bytes);
+
+        // Use the first block (from the current one on) with enough room left
+        for (; m_block < m_blocks.size(); ++m_block, m_offset = 0)
+        {
+            if (m_offset + bytes <= m_blocks[m_block].size())
+            {
+                auto* const data = m_blocks[m_block].data() + m_offset;
+                m_offset += bytes;
+
+                return data;
+            }
+        }
+
+        // Grow geometrically so that the number of blocks stays small
+        const auto size = std::max({bytes, 2 * this->capacity(), minimum_block_size});
+
+        m_blocks.emplace_back(size);
+        m_offset = bytes;
+
+        return m_blocks.back().data();
+    }
+
+    std::vector<impl::aligned_vector<std::byte>> m_blocks;
+    size_t                                       m_block;
+    size_t                                       m_offset;
+};
+
+namespace impl
+{
+
+// Workspace installed on this thread by a workspace_scope (if any)
+inline workspace*& installed_workspace()
+{
+    thread_local workspace* w = nullptr;
+    return w;
+}
+
+}  // namespace impl
+
+/*!
+\brief Gets the default workspace of the calling thread
+\return Workspace owned by the calling thread
+*/
+inline workspace& thread_workspace()
+{
+    thread_local workspace w;
+    return w;
+}
+
+/*!
+\brief Gets the workspace that temporaries on the calling thread are drawn from
+\return Workspace installed by the innermost workspace_scope, or the thread's default workspace
+*/
+inline workspace& current_workspace()
+{
+    auto* const w = impl::installed_workspace();
+    return w != nullptr ? *w : thread_workspace();
+}
+
+/*!
+\brief Makes a caller-owned workspace the source of temporaries on the calling thread
+
+The workspace is used until the scope is destroyed, at which point the previously used workspace
+is restored. Scopes only affect the thread that creates them; worker threads started inside the
+scope still use their own default workspaces.
+*/
+class workspace_scope final
+{
+public:
+    /*!
+    \brief Constructor
+    \param[in] w Workspace to use (must outlive the scope)
+    */
+    explicit workspace_scope(workspace& w)
+        : m_previous(impl::installed_workspace())
+    {
+        impl::installed_workspace() = &w;
+    }
+
+    workspace_scope(const workspace_scope&) = delete;
+
+    workspace_scope& operator=(const workspace_scope&) = delete;
+
+    /*!
+    \brief Destructor
+    */
+    ~workspace_scope()
+    {
+        impl::installed_workspace() = m_previous;
+    }
+
+private:
+    workspace* m_previous;
+};
+
+namespace impl
+{
+
+// Draws temporaries from the current workspace and releases all of them when
+// it goes out of scope. Frames must be destroyed in the reverse order that
+// they were created, which scoping guarantees.
+class scratch_frame final
+{
+public:
+    scratch_frame()
+        : m_workspace(current_workspace())
+        , m_marker(m_workspace.mark())
+    {}
+
+    scratch_frame(const scratch_frame&) = delete;
+
+    scratch_frame& operator=(const scratch_frame&) = delete;
+
+    ~scratch_frame()
+    {
+        m_workspace.release(m_marker);
+    }
+
+    template <typename T>
+    T* allocate(const size_t count)
+    {
+        return m_workspace.template allocate<T>(count);
+    }
+
+private:
+    workspace&        m_workspace;
+    workspace::marker m_marker;
+};
+
+}  // namespace impl
+
+}  // namespace tnt::dsp
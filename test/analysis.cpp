@@ -1,10 +1,14 @@
+#include <algorithm>
 #include <catch2/catch_template_test_macros.hpp>
 #include <cmath>
 #include <complex>
+#include <limits>
 #include <tnt/dsp/analysis.hpp>
+#include <tnt/dsp/fourier_transform.hpp>
 #include <tnt/dsp/signal.hpp>
 #include <tnt/dsp/signal_generator.hpp>
 #include <tnt/math/comparison.hpp>
+#include <utility>
 
 using namespace tnt;
 
@@ -37,6 +41,20 @@ TEMPLATE_TEST_CASE("magnitude", "[magnitude]", double, float)
         CHECK(math::near(x_magnitude[3], 0));
     }
 
+    SECTION("magnitude of a temporary real signal")
+    {
+        dsp::signal<TestType> x    = g.cosine(1000) * -1;
+        const auto* const     data = x.data();
+
+        const auto x_magnitude = dsp::magnitude(std::move(x));
+
+        CHECK(x_magnitude.data() == data);
+        CHECK(math::near(x_magnitude[0], 1));
+        CHECK(math::near(x_magnitude[1], 0));
+        CHECK(math::near(x_magnitude[2], 1));
+        CHECK(math::near(x_magnitude[3], 0));
+    }
+
     SECTION("magnitude of a complex signal")
     {
         const auto x           = dsp::complex_signal(g.cosine(1000), g.sine(1000));
@@ -47,6 +65,49 @@ TEMPLATE_TEST_CASE("magnitude", "[magnitude]", double, float)
         CHECK(math::near(x_magnitude[2], 1));
         CHECK(math::near(x_magnitude[3], 1));
     }
+
+    SECTION("magnitude of a real signal in place")
+    {
+        dsp::signal<TestType> x = g.cosine(1000) * -1;
+        dsp::magnitude(x, x.view());
+
+        CHECK(math::near(x[0], 1));
+        CHECK(math::near(x[1], 0));
+        CHECK(math::near(x[2], 1));
+        CHECK(math::near(x[3], 0));
+    }
+
+    SECTION("magnitude of a complex signal into an existing signal")
+    {
+        const auto x = dsp::complex_signal(g.cosine(1000, 2), g.sine(1000, 2));
+
+        dsp::signal<TestType> x_magnitude(4000);
+        dsp::magnitude(x, x_magnitude);
+
+        REQUIRE(x_magnitude.size() == x.size());
+        CHECK(math::near(x_magnitude[0], 2));
+        CHECK(math::near(x_magnitude[1], 2));
+        CHECK(math::near(x_magnitude[2], 2));
+        CHECK(math::near(x_magnitude[3], 2));
+
+        // The same output is reused for the next input of the same size
+        const auto* const data = x_magnitude.data();
+        dsp::magnitude(x.view(), x_magnitude);
+
+        CHECK(x_magnitude.data() == data);
+        CHECK(math::near(x_magnitude[0], 2));
+    }
+
+    SECTION("magnitude of an expression")
+    {
+        const auto                  x           = dsp::complex_signal(g.cosine(1000), g.sine(1000));
+        const dsp::signal<TestType> x_magnitude = dsp::magnitude(x * 2) + 1;
+
+        CHECK(math::near(x_magnitude[0], 3));
+        CHECK(math::near(x_magnitude[1], 3));
+        CHECK(math::near(x_magnitude[2], 3));
+        CHECK(math::near(x_magnitude[3], 3));
+    }
 }
 
 TEMPLATE_TEST_CASE("phase", "[phase]", double, float)
@@ -78,6 +139,31 @@ TEMPLATE_TEST_CASE("phase", "[phase]", double, float)
         CHECK(math::near(x_phase[3], 0));
     }
 
+    SECTION("phase of a temporary real signal")
+    {
+        auto              x    = g.cosine(1000);
+        const auto* const data = x.data();
+
+        const auto x_phase = dsp::phase(std::move(x));
+
+        CHECK(x_phase.data() == data);
+        CHECK(math::near(x_phase[0], 0));
+        CHECK(math::near(x_phase[1], 0));
+        CHECK(math::near(x_phase[2], M_PI));
+        CHECK(math::near(x_phase[3], 0));
+    }
+
+    SECTION("phase of a real signal in place")
+    {
+        auto x = g.cosine(1000);
+        dsp::phase(x.view(), x.view());
+
+        CHECK(math::near(x[0], 0));
+        CHECK(math::near(x[1], 0));
+        CHECK(math::near(x[2], M_PI));
+        CHECK(math::near(x[3], 0));
+    }
+
     SECTION("phase of a complex signal")
     {
         auto       x       = dsp::complex_signal(g.cosine(1000), g.sine(1000));
@@ -88,6 +174,21 @@ TEMPLATE_TEST_CASE("phase", "[phase]", double, float)
         CHECK(math::near(x_phase[2], M_PI));
         CHECK(math::near(x_phase[3], -M_PI / 2));
     }
+
+    SECTION("phase of a complex signal into a view")
+    {
+        const auto x = dsp::complex_signal(g.cosine(1000), g.sine(1000));
+
+        // Every other sample of the output
+        dsp::signal<TestType> y(4000, 2 * x.size());
+        dsp::phase(x, y.view().subview(1, x.size(), 2));
+
+        CHECK(y[0] == 0);
+        CHECK(math::near(y[1], 0));
+        CHECK(math::near(y[3], M_PI / 2));
+        CHECK(math::near(y[5], M_PI));
+        CHECK(math::near(y[7], -M_PI / 2));
+    }
 }
 
 TEMPLATE_TEST_CASE("power", "[power]", double, float)
@@ -127,6 +228,20 @@ TEMPLATE_TEST_CASE("power", "[power]", double, float)
         CHECK(math::near(x2_power[3], 0));
     }
 
+    SECTION("power of a temporary real signal")
+    {
+        auto              x    = g.cosine(1000, 2);
+        const auto* const data = x.data();
+
+        const auto x_power = dsp::power(std::move(x));
+
+        CHECK(x_power.data() == data);
+        CHECK(math::near(x_power[0], 4));
+        CHECK(math::near(x_power[1], 0));
+        CHECK(math::near(x_power[2], 4));
+        CHECK(math::near(x_power[3], 0));
+    }
+
     SECTION("power of a complex signal")
     {
         const auto x1       = dsp::complex_signal(g.cosine(1000), g.sine(1000));
@@ -143,4 +258,353 @@ TEMPLATE_TEST_CASE("power", "[power]", double, float)
         CHECK(math::near(x2_power[2], 4));
         CHECK(math::near(x2_power[3], 4));
     }
+
+    SECTION("power of a real signal in place")
+    {
+        auto x = g.cosine(1000, 2);
+        dsp::power(x, x.view());
+
+        CHECK(math::near(x[0], 4));
+        CHECK(math::near(x[1], 0));
+        CHECK(math::near(x[2], 4));
+        CHECK(math::near(x[3], 0));
+    }
+
+    SECTION("power of a complex signal into an existing signal")
+    {
+        auto x = dsp::complex_signal(g.cosine(1000, 2), g.sine(1000, 2));
+
+        dsp::signal<TestType> x_power(4000, 1);
+        dsp::power(x.view(), x_power);
+
+        REQUIRE(x_power.size() == x.size());
+        CHECK(math::near(x_power[0], 4));
+        CHECK(math::near(x_power[1], 4));
+        CHECK(math::near(x_power[2], 4));
+        CHECK(math::near(x_power[3], 4));
+    }
+
+    SECTION("power of an expression")
+    {
+        const auto                  x1      = dsp::complex_signal(g.cosine(1000), g.sine(1000));
+        const auto                  x2      = g.cosine(1000);
+        const dsp::signal<TestType> x_power = dsp::power(x1 + x2);
+
+        CHECK(math::near(x_power[0], 4));
+        CHECK(math::near(x_power[1], 1));
+        CHECK(math::near(x_power[2], 4));
+        CHECK(math::near(x_power[3], 1));
+    }
+}
+
+TEMPLATE_TEST_CASE("spectral_stats", "[spectral_stats]", double, float)
+{
+    // More samples than fit in one block, with phases all around the circle
+    const size_t N = 1000;
+
+    const dsp::signal_generator<TestType> g(4000, N);
+
+    const auto X_noise = dsp::fourier_transform(g.white_noise());
+    const auto X_power = dsp::power(X_noise);
+
+    SECTION("all outputs")
+    {
+        dsp::signal<TestType> y_magnitude(4000, N);
+        dsp::signal<TestType> y_phase(4000, N);
+        dsp::signal<TestType> y_power(4000, N);
+        dsp::signal<TestType> y_db(4000, N);
+
+        dsp::spectral_outputs<TestType> y;
+        y.magnitude = y_magnitude.view();
+        y.phase     = y_phase.view();
+        y.power     = y_power.view();
+        y.decibels  = y_db.view();
+
+        dsp::spectral_stats(X_noise, y);
+
+        const auto X_magnitude = dsp::magnitude(X_noise);
+        const auto X_phase     = dsp::phase(X_noise);
+
+        for (size_t m = 0; m < N; ++m)
+        {
+            CHECK(math::near(y_magnitude[m], X_magnitude[m]));
+            CHECK(math::near(y_phase[m], X_phase[m]));
+            CHECK(math::near(y_power[m], X_power[m]));
+            CHECK(math::near(y_db[m], 10 * std::log10(X_power[m])));
+        }
+    }
+
+    SECTION("only the requested outputs are written")
+    {
+        dsp::signal<TestType> y_power(4000, N);
+
+        dsp::spectral_outputs<TestType> y;
+        y.power = y_power.view();
+
+        dsp::spectral_stats(X_noise, y);
+
+        for (size_t m = 0; m < N; ++m)
+        {
+            CHECK(math::near(y_power[m], X_power[m]));
+        }
+    }
+
+    SECTION("strided input and outputs")
+    {
+        // Every other sample of the spectrum, written to every other sample
+        // of the output
+        dsp::signal<TestType> y_db(4000, N);
+        std::fill(y_db.begin(), y_db.end(), TestType(1));
+
+        dsp::spectral_outputs<TestType> y;
+        y.decibels = y_db.view().subview(1, N / 2, 2);
+
+        dsp::spectral_stats(X_noise.view().subview(0, N / 2, 2), y);
+
+        for (size_t m = 0; m < N / 2; ++m)
+        {
+            CHECK(y_db[2 * m] == 1);
+            CHECK(math::near(y_db[2 * m + 1], 10 * std::log10(X_power[2 * m])));
+        }
+    }
+
+    SECTION("special values")
+    {
+        const TestType tiny = std::numeric_limits<TestType>::epsilon();
+
+        dsp::signal<std::complex<TestType>> X(4000);
+        X.push_back({0, 0});
+        X.push_back({-1, 0});
+        X.push_back({0, 1});
+        X.push_back({0, -1});
+        X.push_back({-1, tiny});
+        X.push_back({-1, -tiny});
+        X.push_back({tiny, -1});
+
+        dsp::signal<TestType> y_magnitude(4000, X.size());
+        dsp::signal<TestType> y_phase(4000, X.size());
+        dsp::to_polar(X, y_magnitude.view(), y_phase.view());
+
+        CHECK(y_magnitude[0] == 0);
+        CHECK(y_phase[0] == 0);
+
+        CHECK(math::near(y_magnitude[1], 1));
+        CHECK(math::near(y_phase[1], M_PI));
+        CHECK(math::near(y_phase[2], M_PI / 2));
+        CHECK(math::near(y_phase[3], -M_PI / 2));
+
+        // Components close to 0 are treated as 0, the same as phase()
+        CHECK(math::near(y_phase[4], M_PI));
+        CHECK(math::near(y_phase[5], M_PI));
+        CHECK(math::near(y_phase[6], -M_PI / 2));
+
+        for (size_t n = 0; n < X.size(); ++n)
+        {
+            CHECK(math::near(y_phase[n], dsp::phase(X[n])));
+        }
+
+        // Silence gives a large negative value in decibels rather than -inf
+        dsp::signal<TestType> y_db(4000, X.size());
+
+        dsp::spectral_outputs<TestType> y;
+        y.decibels = y_db.view();
+        dsp::spectral_stats(X, y);
+
+        CHECK(std::isfinite(y_db[0]));
+        CHECK(y_db[0] < -300);
+        CHECK(math::near(y_db[1], 0));
+    }
+
+    SECTION("extreme values")
+    {
+        using limits = std::numeric_limits<TestType>;
+
+        // Powers that overflow, are subnormal, or are 0 or infinite
+        const auto large = std::sqrt(limits::max()) * 4;
+        const auto small = std::sqrt(limits::min()) / 4;
+
+        dsp::signal<std::complex<TestType>> X(4000);
+        X.push_back({large, -large / 3});
+        X.push_back({limits::max() / 2, limits::max() / 4});
+        X.push_back({small, small / 3});
+        X.push_back({-limits::denorm_min() * 5, 0});
+        X.push_back({0, 0});
+        X.push_back({limits::infinity(), 1});
+
+        dsp::signal<TestType> y_magnitude(4000, X.size());
+        dsp::signal<TestType> y_phase(4000, X.size());
+        dsp::signal<TestType> y_power(4000, X.size());
+        dsp::signal<TestType> y_db(4000, X.size());
+        dsp::signal<TestType> y_log_magnitude(4000, X.size());
+
+        dsp::spectral_outputs<TestType> y;
+        y.magnitude     = y_magnitude.view();
+        y.phase         = y_phase.view();
+        y.power         = y_power.view();
+        y.decibels      = y_db.view();
+        y.log_magnitude = y_log_magnitude.view();
+
+        dsp::spectral_stats(X, y);
+
+        // The magnitude and logarithms are accurate wherever the magnitude is
+        // finite and not 0, even where the power is not
+        for (size_t n = 0; n < 4; ++n)
+        {
+            CHECK(math::near(y_magnitude[n], std::abs(X[n])));
+            CHECK(math::near(y_db[n], 20 * std::log10(std::abs(X[n]))));
+            CHECK(math::near(y_log_magnitude[n], std::log(std::abs(X[n]))));
+        }
+
+        CHECK(math::near(y_phase[0], std::arg(X[0])));
+        CHECK(math::near(y_phase[1], std::arg(X[1])));
+
+        CHECK(y_power[0] == limits::infinity());
+        CHECK(y_power[2] < limits::min());
+
+        CHECK(y_magnitude[4] == 0);
+        CHECK(y_power[4] == 0);
+        CHECK(std::isfinite(y_db[4]));
+        CHECK(y_db[4] < y_db[3]);
+
+        CHECK(y_magnitude[5] == limits::infinity());
+        CHECK(y_power[5] == limits::infinity());
+        CHECK(y_db[5] == limits::infinity());
+        CHECK(y_log_magnitude[5] == limits::infinity());
+    }
+}
+
+TEMPLATE_TEST_CASE("precision", "[precision]", double, float)
+{
+    const size_t N = 1000;
+
+    const dsp::signal_generator<TestType> g(4000, N);
+
+    // Spectrum with magnitudes over many orders of magnitude
+    auto X_noise = dsp::fourier_transform(g.white_noise());
+    for (size_t m = 0; m < N; ++m)
+    {
+        X_noise[m] *= std::pow(TestType(10), TestType(m % 13) - 6);
+    }
+
+    const auto X_power = dsp::power(X_noise);
+
+    SECTION("exact")
+    {
+        const auto X_magnitude     = dsp::magnitude(X_noise, dsp::precision::exact);
+        const auto X_phase         = dsp::phase(X_noise, dsp::precision::exact);
+        const auto X_log_magnitude = dsp::log_magnitude(X_noise);
+        const auto X_db            = dsp::decibels(X_power);
+
+        for (size_t m = 0; m < N; ++m)
+        {
+            CHECK(math::near(X_magnitude[m], std::abs(X_noise[m])));
+            CHECK(math::near(X_phase[m], dsp::phase(X_noise[m])));
+            CHECK(math::near(X_log_magnitude[m], std::log(std::abs(X_noise[m]))));
+            CHECK(math::near(X_db[m], 10 * std::log10(X_power[m])));
+        }
+    }
+
+    SECTION("fast is within the documented bounds")
+    {
+        const auto X_magnitude     = dsp::magnitude(X_noise);
+        const auto X_phase         = dsp::phase(X_noise);
+        const auto X_log_magnitude = dsp::log_magnitude(X_noise);
+        const auto X_db            = dsp::decibels(X_power);
+
+        const auto y_magnitude     = dsp::magnitude(X_noise, dsp::precision::fast);
+        const auto y_phase         = dsp::phase(X_noise, dsp::precision::fast);
+        const auto y_log_magnitude = dsp::log_magnitude(X_noise, dsp::precision::fast);
+        const auto y_db            = dsp::decibels(X_power, dsp::precision::fast);
+
+        // Allow for the rounding error of the exact values as well
+        const auto rounding = [](const TestType x) {
+            return 4 * std::numeric_limits<TestType>::epsilon() * std::abs(x);
+        };
+
+        for (size_t m = 0; m < N; ++m)
+        {
+            CHECK(std::abs(y_magnitude[m] - X_magnitude[m]) <= 5e-6 * X_magnitude[m]);
+            CHECK(std::abs(y_phase[m] - X_phase[m]) <= 1.2e-5 + rounding(X_phase[m]));
+            CHECK(std::abs(y_log_magnitude[m] - X_log_magnitude[m]) <=
+                  1e-5 + rounding(X_log_magnitude[m]));
+            CHECK(std::abs(y_db[m] - X_db[m]) <= 1e-4 + rounding(X_db[m]));
+        }
+    }
+
+    SECTION("spectral_stats with a precision")
+    {
+        dsp::signal<TestType> y_magnitude(4000, N);
+        dsp::signal<TestType> y_log_magnitude(4000, N);
+
+        dsp::spectral_outputs<TestType> y;
+        y.magnitude     = y_magnitude.view();
+        y.log_magnitude = y_log_magnitude.view();
+
+        dsp::spectral_stats(X_noise, y, dsp::precision::fast);
+
+        const auto X_magnitude     = dsp::magnitude(X_noise, dsp::precision::fast);
+        const auto X_log_magnitude = dsp::log_magnitude(X_noise, dsp::precision::fast);
+
+        for (size_t m = 0; m < N; ++m)
+        {
+            CHECK(y_magnitude[m] == X_magnitude[m]);
+            CHECK(y_log_magnitude[m] == X_log_magnitude[m]);
+        }
+    }
+
+    SECTION("both precisions at the extremes of the range")
+    {
+        using limits = std::numeric_limits<TestType>;
+
+        dsp::signal<std::complex<TestType>> X(4000);
+        X.push_back({std::sqrt(limits::max()) * 4, 1});
+        X.push_back({-limits::max() / 2, limits::max() / 3});
+        X.push_back({std::sqrt(limits::min()) / 4, 0});
+        X.push_back({0, -limits::denorm_min() * 7});
+
+        const auto check = [&](const auto& policy, const TestType magnitude_error) {
+            const auto y_magnitude     = dsp::magnitude(X, policy);
+            const auto y_phase         = dsp::phase(X, policy);
+            const auto y_log_magnitude = dsp::log_magnitude(X, policy);
+
+            for (size_t n = 0; n < X.size(); ++n)
+            {
+                CHECK(std::abs(y_magnitude[n] - std::abs(X[n])) <=
+                      magnitude_error * std::abs(X[n]));
+                CHECK(math::near(y_log_magnitude[n], std::log(std::abs(X[n]))));
+            }
+
+            // Components this small are treated as 0 in the phase
+            CHECK(std::abs(y_phase[0] - std::arg(X[0])) <= 1.2e-5);
+            CHECK(std::abs(y_phase[1] - std::arg(X[1])) <= 1.2e-5);
+
+            // Powers of 0, subnormal and infinite powers
+            dsp::signal<TestType> x_power(4000);
+            x_power.push_back(0);
+            x_power.push_back(limits::denorm_min() * 9);
+            x_power.push_back(limits::infinity());
+
+            const auto x_db = dsp::decibels(x_power, policy);
+
+            CHECK(std::isfinite(x_db[0]));
+            CHECK(math::near(x_db[1], 10 * std::log10(x_power[1])));
+            CHECK(x_db[2] == limits::infinity());
+        };
+
+        check(dsp::precision::exact, 4 * limits::epsilon());
+        check(dsp::precision::fast, TestType(5e-6));
+    }
+
+    SECTION("decibels of silence")
+    {
+        dsp::signal<TestType> x_power(4000);
+        x_power.push_back(0);
+        x_power.push_back(1);
+
+        const auto x_db = dsp::decibels(x_power.view(), dsp::precision::fast);
+
+        CHECK(std::isfinite(x_db[0]));
+        CHECK(x_db[0] < -300);
+        CHECK(std::abs(x_db[1]) <= 1e-4);
+    }
 }
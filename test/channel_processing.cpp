@@ -0,0 +1,125 @@
+#include <atomic>
+#include <catch2/catch_template_test_macros.hpp>
+#include <complex>
+#include <tnt/dsp/analysis.hpp>
+#include <tnt/dsp/channel_processing.hpp>
+#include <tnt/dsp/fourier_transform.hpp>
+#include <tnt/dsp/hilbert_transform.hpp>
+#include <tnt/dsp/multisignal.hpp>
+#include <tnt/dsp/signal.hpp>
+#include <tnt/dsp/signal_generator.hpp>
+#include <tnt/dsp/signal_view.hpp>
+#include <tnt/dsp/thread_pool.hpp>
+#include <tnt/math/comparison.hpp>
+#include <vector>
+
+using namespace tnt;
+
+TEMPLATE_TEST_CASE("channel processing", "[channel_processing]", double, float)
+{
+    const dsp::signal_generator<TestType> g(1000, 64);
+
+    std::vector<dsp::signal<TestType>> signals;
+    for (size_t c = 0; c < 16; ++c)
+    {
+        signals.push_back(g.cosine(static_cast<double>(10 * (c + 1)), 1, 0.1 * c));
+    }
+
+    const dsp::multisignal<TestType> x(signals);
+
+    SECTION("for_each_channel modifies each channel in place")
+    {
+        dsp::thread_pool pool(4);
+
+        auto y = x;
+        dsp::for_each_channel(
+            y,
+            [](const dsp::signal_view<TestType>& channel) {
+                for (auto& sample : channel)
+                {
+                    sample *= 2;
+                }
+            },
+            pool);
+
+        for (size_t c = 0; c < x.channels(); ++c)
+        {
+            for (size_t n = 0; n < x.size(); ++n)
+            {
+                CHECK(math::near(y.channel_view(c)[n], 2 * x.channel_view(c)[n]));
+            }
+        }
+    }
+
+    SECTION("for_each_channel visits every channel of a constant signal")
+    {
+        std::atomic<size_t> channels(0);
+        std::atomic<size_t> samples(0);
+        dsp::for_each_channel(x, [&](const dsp::signal_view<const TestType>& channel) {
+            ++channels;
+            samples += channel.size();
+        });
+
+        CHECK(channels.load() == x.channels());
+        CHECK(samples.load() == x.channels() * x.size());
+    }
+
+    SECTION("transform_channels matches transforming each channel")
+    {
+        for (size_t threads = 1; threads <= 4; ++threads)
+        {
+            dsp::thread_pool pool(threads);
+
+            const auto y = dsp::transform_channels(
+                x,
+                [](const dsp::signal_view<const TestType>& channel) {
+                    return dsp::magnitude(dsp::hilbert_transform(channel));
+                },
+                pool);
+
+            REQUIRE(y.sample_rate() == x.sample_rate());
+            REQUIRE(y.size() == x.size());
+            REQUIRE(y.channels() == x.channels());
+
+            for (size_t c = 0; c < x.channels(); ++c)
+            {
+                const auto envelope = dsp::magnitude(dsp::hilbert_transform(signals[c]));
+                for (size_t n = 0; n < x.size(); ++n)
+                {
+                    CHECK(math::near(y.channel_view(c)[n], envelope[n]));
+                }
+            }
+        }
+    }
+
+    SECTION("transform_channels can change the sample type")
+    {
+        const auto X = dsp::transform_channels(x, [](const dsp::signal_view<const TestType>& c) {
+            return dsp::fourier_transform(c);
+        });
+
+        REQUIRE(X.channels() == x.channels());
+
+        for (size_t c = 0; c < x.channels(); ++c)
+        {
+            const auto X_c = dsp::fourier_transform(signals[c]);
+            for (size_t m = 0; m < x.size(); ++m)
+            {
+                CHECK(math::near(X.channel_view(c)[m].real(), X_c[m].real()));
+                CHECK(math::near(X.channel_view(c)[m].imag(), X_c[m].imag()));
+            }
+        }
+    }
+
+    SECTION("transform_channels of no channels")
+    {
+        const dsp::multisignal<TestType> none(1000);
+
+        const auto y = dsp::transform_channels(none, [](const dsp::signal_view<const TestType>& c) {
+            return dsp::magnitude(c);
+        });
+
+        CHECK(y.channels() == 0);
+        CHECK(y.sample_rate() == 1000);
+    }
+}
@@ -2,6 +2,7 @@
 #include <tnt/dsp/convolution.hpp>
 #include <tnt/dsp/signal.hpp>
 #include <tnt/dsp/signal_generator.hpp>
+#include <tnt/dsp/signal_view.hpp>
 #include <tnt/math/comparison.hpp>
 
 using namespace tnt;
@@ -82,3 +83,109 @@ TEMPLATE_TEST_CASE("convolve", "[convolve]", double, float)
         CHECK(math::near(c[3].imag(), -4));
     }
 }
+
+TEMPLATE_TEST_CASE("convolve short kernels", "[convolve]", double, float)
+{
+    const dsp::signal_generator<TestType> g(4000, 100);
+
+    // Short kernel padded out to the size of the signal
+    auto h = g.cosine(100);
+    for (size_t n = 5; n < h.size(); ++n)
+    {
+        h[n] = 0;
+    }
+
+    using complex = std::complex<TestType>;
+
+    const auto crossover         = dsp::convolution_crossover<TestType>();
+    const auto crossover_mixed   = dsp::convolution_crossover<TestType, complex>();
+    const auto crossover_complex = dsp::convolution_crossover<complex>();
+
+    SECTION("each combination of sample types has its own crossover")
+    {
+        dsp::set_convolution_crossover<TestType>(3);
+        dsp::set_convolution_crossover<complex, TestType>(5);
+        dsp::set_convolution_crossover<complex>(7);
+
+        CHECK(dsp::convolution_crossover<TestType>() == 3);
+        CHECK(dsp::convolution_crossover<TestType, complex>() == 5);
+        CHECK(dsp::convolution_crossover<complex, TestType>() == 5);
+        CHECK(dsp::convolution_crossover<complex>() == 7);
+    }
+
+    SECTION("direct convolution matches FFT convolution for real signals")
+    {
+        const auto x = g.sine(300);
+
+        dsp::set_convolution_crossover<TestType>(0);
+        const auto c_fft = dsp::convolve(x, h);
+
+        dsp::set_convolution_crossover<TestType>(x.size());
+        const auto c_direct = dsp::convolve(x, h);
+
+        REQUIRE(c_direct.size() == c_fft.size());
+
+        for (size_t n = 0; n < c_direct.size(); ++n)
+        {
+            CHECK(math::near(c_direct[n], c_fft[n]));
+        }
+    }
+
+    SECTION("direct convolution matches FFT convolution for complex signals")
+    {
+        const auto x   = dsp::complex_signal(g.cosine(300), g.sine(300));
+        const auto h_c = dsp::complex_signal(h, h);
+
+        dsp::set_convolution_crossover<complex>(0);
+        dsp::set_convolution_crossover<TestType, complex>(0);
+        const auto c_fft   = dsp::convolve(x, h_c);
+        const auto c_fft_r = dsp::convolve(x, h);
+
+        dsp::set_convolution_crossover<complex>(x.size());
+        dsp::set_convolution_crossover<TestType, complex>(x.size());
+        const auto c_direct   = dsp::convolve(h_c, x);
+        const auto c_direct_r = dsp::convolve(h, x);
+
+        REQUIRE(c_direct.size() == c_fft.size());
+        REQUIRE(c_direct_r.size() == c_fft_r.size());
+
+        for (size_t n = 0; n < c_direct.size(); ++n)
+        {
+            CHECK(math::near(c_direct[n].real(), c_fft[n].real()));
+            CHECK(math::near(c_direct[n].imag(), c_fft[n].imag()));
+            CHECK(math::near(c_direct_r[n].real(), c_fft_r[n].real()));
+            CHECK(math::near(c_direct_r[n].imag(), c_fft_r[n].imag()));
+        }
+    }
+
+    SECTION("convolve strided views")
+    {
+        const auto x = dsp::complex_signal(g.cosine(300), g.sine(300));
+
+        // Every other sample of the kernel and the signal
+        const dsp::signal_view<const TestType> h_view = h.view().subview(0, h.size() / 2, 2);
+        const auto                             x_view = x.view().subview(1, x.size() / 2, 2);
+
+        const dsp::signal<TestType>               h_copy(h_view);
+        const dsp::signal<std::complex<TestType>> x_copy(x_view);
+
+        for (const size_t taps : {size_t{0}, x_view.size()})
+        {
+            dsp::set_convolution_crossover<complex, TestType>(taps);
+            const auto c      = dsp::convolve(x_copy, h_copy);
+            const auto c_view = dsp::convolve(x_view, h_view);
+
+            REQUIRE(c_view.size() == c.size());
+
+            for (size_t n = 0; n < c.size(); ++n)
+            {
+                CHECK(math::near(c_view[n].real(), c[n].real()));
+                CHECK(math::near(c_view[n].imag(), c[n].imag()));
+            }
+        }
+    }
+
+    dsp::set_convolution_crossover<TestType>(crossover);
+    dsp::set_convolution_crossover<TestType, complex>(crossover_mixed);
+    dsp::set_convolution_crossover<complex>(crossover_complex);
+}
@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <catch2/catch_template_test_macros.hpp>
+#include <complex>
+#include <memory>
+#include <tnt/dsp/correlation.hpp>
+#include <tnt/dsp/signal.hpp>
+#include <tnt/dsp/signal_generator.hpp>
+#include <tnt/dsp/signal_view.hpp>
+#include <tnt/math/comparison.hpp>
+#include <utility>
+
+using namespace tnt;
+
+TEMPLATE_TEST_CASE("cross_correlate", "[cross_correlate]", double, float)
+{
+    const dsp::signal_generator<TestType> g(4000, 4);
+
+    SECTION("cross-correlate a real signal with a real signal")
+    {
+        const auto a = g.cosine(1000);
+        const auto b = g.sine(1000);
+        const auto r = dsp::cross_correlate(a, b);
+
+        REQUIRE(r.size() == a.size());
+
+        CHECK(math::near(r[0], 0));
+        CHECK(math::near(r[1], -2));
+        CHECK(math::near(r[2], 0));
+        CHECK(math::near(r[3], 2));
+    }
+
+    SECTION("cross-correlate a complex signal with a complex signal")
+    {
+        const auto a = dsp::complex_signal(g.cosine(1000), g.sine(1000));
+        const auto b = dsp::complex_signal(g.cosine(1000), g.sine(1000));
+        const auto r = dsp::cross_correlate(a, b);
+
+        REQUIRE(r.size() == a.size());
+
+        CHECK(math::near(r[0].real(), 4));
+        CHECK(math::near(r[0].imag(), 0));
+        CHECK(math::near(r[1].real(), 0));
+        CHECK(math::near(r[1].imag(), 4));
+        CHECK(math::near(r[2].real(), -4));
+        CHECK(math::near(r[2].imag(), 0));
+        CHECK(math::near(r[3].real(), 0));
+        CHECK(math::near(r[3].imag(), -4));
+    }
+
+    SECTION("cross-correlation peaks at the delay between two signals")
+    {
+        const size_t N     = 50;
+        const size_t delay = 7;
+
+        dsp::signal<TestType> b(1000, N);
+        dsp::signal<TestType> a(1000, N);
+        for (size_t n = 0; n < N; ++n)
+        {
+            b[n]               = static_cast<TestType>((n * 37) % 11) - 5;
+            a[(n + delay) % N] = b[n];
+        }
+
+        const auto r    = dsp::cross_correlate(a, b);
+        const auto peak = std::max_element(r.begin(), r.end()) - r.begin();
+
+        CHECK(static_cast<size_t>(peak) == delay);
+    }
+
+    SECTION("cross-correlate a range of lags")
+    {
+        const auto a = g.cosine(1000);
+        const auto b = g.sine(1000);
+        const auto r = dsp::cross_correlate(a, b, 3, 3);
+
+        REQUIRE(r.size() == 3);
+
+        CHECK(math::near(r[0], 2));
+        CHECK(math::near(r[1], 0));
+        CHECK(math::near(r[2], -2));
+    }
+
+    SECTION("ranges of lags match the full cross-correlation")
+    {
+        const dsp::signal_generator<TestType> g_noise(4000, 256);
+
+        const auto a = g_noise.white_noise();
+        const auto b = g_noise.white_noise();
+        const auto r = dsp::cross_correlate(a, b);
+
+        // Short ranges that are calculated directly (one of them wrapping
+        // around the end) and a long one that is not
+        for (const auto& [first_lag, lags] : {std::pair<size_t, size_t>{10, 5},
+                                              std::pair<size_t, size_t>{250, 12},
+                                              std::pair<size_t, size_t>{200, 200}})
+        {
+            const auto r_range = dsp::cross_correlate(a, b, first_lag, lags);
+
+            REQUIRE(r_range.size() == lags);
+            for (size_t l = 0; l < lags; ++l)
+            {
+                CHECK(math::near(r_range[l], r[(first_lag + l) % a.size()]));
+            }
+        }
+
+        CHECK(dsp::cross_correlate(a, b, 0, 0).size() == 0);
+    }
+
+    SECTION("ranges of lags of views and signals with other allocators")
+    {
+        const dsp::signal_generator<TestType> g_noise(4000, 256);
+
+        const auto a = g_noise.white_noise();
+        const auto b = g_noise.white_noise(1, 1);
+        const auto r = dsp::cross_correlate(a, b);
+
+        // Every other sample of a signal twice as long
+        dsp::signal<TestType> a_2(a.sample_rate(), 2 * a.size());
+        for (size_t n = 0; n < a.size(); ++n)
+        {
+            a_2[2 * n] = a[n];
+        }
+
+        const dsp::signal_view<const TestType> a_v(a.sample_rate(), a_2.data(), a.size(), 2);
+
+        const dsp::signal<TestType, std::allocator<TestType>> b_a(b.view());
+
+        for (const size_t lags : {size_t(12), size_t(200)})
+        {
+            const auto r_v = dsp::cross_correlate(a_v, b.view(), 250, lags);
+            const auto r_a = dsp::cross_correlate(a, b_a, 250, lags);
+
+            REQUIRE(r_v.size() == lags);
+            REQUIRE(r_a.size() == lags);
+            for (size_t l = 0; l < lags; ++l)
+            {
+                CHECK(math::near(r_v[l], r[(250 + l) % a.size()]));
+                CHECK(math::near(r_a[l], r[(250 + l) % a.size()]));
+            }
+        }
+
+        const auto r_auto = dsp::autocorrelate(a);
+        const auto r_v    = dsp::autocorrelate(a_v, 3, 5);
+        for (size_t l = 0; l < 5; ++l)
+        {
+            CHECK(math::near(r_v[l], r_auto[3 + l]));
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("autocorrelate", "[autocorrelate]", double, float)
+{
+    const dsp::signal_generator<TestType> g(4000, 4);
+
+    SECTION("autocorrelate a real signal")
+    {
+        const auto x = g.cosine(1000);
+        const auto r = dsp::autocorrelate(x);
+
+        REQUIRE(r.size() == x.size());
+
+        CHECK(math::near(r[0], 2));
+        CHECK(math::near(r[1], 0));
+        CHECK(math::near(r[2], -2));
+        CHECK(math::near(r[3], 0));
+    }
+
+    SECTION("autocorrelate a complex signal")
+    {
+        const auto x = dsp::complex_signal(g.cosine(1000), g.sine(1000));
+        const auto r = dsp::autocorrelate(x);
+
+        REQUIRE(r.size() == x.size());
+
+        CHECK(math::near(r[0].real(), 4));
+        CHECK(math::near(r[0].imag(), 0));
+        CHECK(math::near(r[1].real(), 0));
+        CHECK(math::near(r[1].imag(), 4));
+        CHECK(math::near(r[2].real(), -4));
+        CHECK(math::near(r[2].imag(), 0));
+        CHECK(math::near(r[3].real(), 0));
+        CHECK(math::near(r[3].imag(), -4));
+    }
+
+    SECTION("autocorrelation matches cross-correlation with itself")
+    {
+        for (size_t N = 1; N <= 10; ++N)
+        {
+            const dsp::signal_generator<TestType> g2(1000, N);
+
+            const auto x  = g2.cosine(100, 1, 1, 1);
+            const auto r  = dsp::autocorrelate(x);
+            const auto r2 = dsp::cross_correlate(x, x);
+
+            REQUIRE(r.size() == N);
+            REQUIRE(r2.size() == N);
+
+            for (size_t l = 0; l < N; ++l)
+            {
+                CHECK(math::near(r[l], r2[l]));
+            }
+        }
+    }
+
+    SECTION("autocorrelate a range of lags")
+    {
+        const auto x = g.cosine(1000);
+        const auto r = dsp::autocorrelate(x, 2, 3);
+
+        REQUIRE(r.size() == 3);
+
+        CHECK(math::near(r[0], -2));
+        CHECK(math::near(r[1], 0));
+        CHECK(math::near(r[2], 2));
+    }
+
+    SECTION("ranges of lags of a complex signal match the full autocorrelation")
+    {
+        const dsp::signal_generator<TestType> g_noise(4000, 256);
+
+        const auto x = dsp::complex_signal(g_noise.white_noise(), g_noise.white_noise());
+        const auto r = dsp::autocorrelate(x);
+
+        for (const auto& [first_lag, lags] : {std::pair<size_t, size_t>{250, 12},
+                                              std::pair<size_t, size_t>{0, 256}})
+        {
+            const auto r_range = dsp::autocorrelate(x, first_lag, lags);
+
+            REQUIRE(r_range.size() == lags);
+            for (size_t l = 0; l < lags; ++l)
+            {
+                CHECK(math::near(r_range[l].real(), r[(first_lag + l) % x.size()].real()));
+                CHECK(math::near(r_range[l].imag(), r[(first_lag + l) % x.size()].imag()));
+            }
+        }
+
+        const dsp::signal<TestType> empty(4000);
+        CHECK(dsp::autocorrelate(empty, 0, 0).size() == 0);
+    }
+}
@@ -0,0 +1,172 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <cmath>
+#include <tnt/dsp/correlation.hpp>
+#include <tnt/dsp/correlator_bank.hpp>
+#include <tnt/dsp/signal.hpp>
+#include <tnt/dsp/signal_generator.hpp>
+#include <tnt/math/comparison.hpp>
+#include <vector>
+
+using namespace tnt;
+
+TEMPLATE_TEST_CASE("correlator_bank", "[correlator_bank]", double, float)
+{
+    const dsp::signal_generator<TestType> g(1000, 20);
+
+    const std::vector<dsp::signal<TestType>> templates = {
+        g.cosine(100),
+        g.sine(100),
+        g.cosine(200, 2, 1),
+    };
+
+    const dsp::correlator_bank<TestType> bank(templates, g.size());
+
+    const auto x = g.cosine(100, 1, 0.5, 0.25);
+
+    SECTION("construction")
+    {
+        CHECK(bank.sample_rate() == g.sample_rate());
+        CHECK(bank.block_size() == g.size());
+        CHECK(bank.templates() == templates.size());
+    }
+
+    SECTION("correlate matches cross_correlate against each template")
+    {
+        const auto r = bank.correlate(x);
+
+        REQUIRE(r.size() == x.size());
+        REQUIRE(r.channels() == templates.size());
+
+        for (size_t k = 0; k < templates.size(); ++k)
+        {
+            const auto r_k = dsp::cross_correlate(x, templates[k]);
+
+            for (size_t n = 0; n < x.size(); ++n)
+            {
+                CHECK(math::near(r[n][k], r_k[n]));
+            }
+        }
+    }
+
+    SECTION("peaks match the largest cross-correlation against each template")
+    {
+        const auto peaks = bank.peaks(x);
+
+        REQUIRE(peaks.size() == templates.size());
+
+        for (size_t k = 0; k < templates.size(); ++k)
+        {
+            const auto r_k = dsp::cross_correlate(x, templates[k]);
+
+            CHECK(math::near(peaks[k].value, r_k[peaks[k].lag]));
+            for (size_t n = 0; n < x.size(); ++n)
+            {
+                CHECK(std::abs(r_k[n]) <= std::abs(peaks[k].value) + static_cast<TestType>(1e-3));
+            }
+        }
+    }
+
+    SECTION("many templates are correlated in batches")
+    {
+        // Full batches and a partial one with an odd number of templates, for
+        // block sizes that are a power of 2 and that are not
+        for (const size_t N : {size_t(64), size_t(20)})
+        {
+            const dsp::signal_generator<TestType> g_N(1000, N);
+
+            std::vector<dsp::signal<TestType>> many;
+            for (size_t k = 0; k < 37; ++k)
+            {
+                many.push_back(g_N.cosine(10 * TestType(k + 1), 1, TestType(k) / 10));
+            }
+
+            const dsp::correlator_bank<TestType> many_bank(many, N);
+
+            const auto x_N   = g_N.white_noise();
+            const auto r     = many_bank.correlate(x_N);
+            const auto peaks = many_bank.peaks(x_N);
+
+            REQUIRE(r.channels() == many.size());
+            REQUIRE(peaks.size() == many.size());
+
+            for (size_t k = 0; k < many.size(); ++k)
+            {
+                const auto r_k = dsp::cross_correlate(x_N, many[k]);
+
+                for (size_t n = 0; n < N; ++n)
+                {
+                    CHECK(math::near(r[n][k], r_k[n]));
+                }
+
+                CHECK(math::near(peaks[k].value, r_k[peaks[k].lag]));
+            }
+        }
+    }
+
+    SECTION("strided views give the same results")
+    {
+        // Every other sample of a signal twice as long as the block
+        dsp::signal<TestType> x_2(x.sample_rate(), 2 * x.size());
+        for (size_t n = 0; n < x.size(); ++n)
+        {
+            x_2[2 * n] = x[n];
+        }
+
+        const dsp::signal_view<const TestType> x_v(x.sample_rate(), x_2.data(), x.size(), 2);
+
+        const auto r     = bank.correlate(x);
+        const auto r_v   = bank.correlate(x_v);
+        const auto peaks = bank.peaks(x_v);
+
+        for (size_t k = 0; k < templates.size(); ++k)
+        {
+            for (size_t n = 0; n < x.size(); ++n)
+            {
+                CHECK(r_v[n][k] == r[n][k]);
+            }
+
+            CHECK(peaks[k].lag == bank.peaks(x)[k].lag);
+        }
+    }
+
+    SECTION("templates shorter than the block are padded with zeros")
+    {
+        const dsp::signal_generator<TestType> g2(1000, 5);
+
+        const dsp::correlator_bank<TestType> short_bank({g2.cosine(100)}, g.size());
+
+        auto t = g.cosine(100);
+        for (size_t n = 5; n < t.size(); ++n)
+        {
+            t[n] = 0;
+        }
+
+        const auto r   = short_bank.correlate(x);
+        const auto r_k = dsp::cross_correlate(x, t);
+
+        for (size_t n = 0; n < x.size(); ++n)
+        {
+            CHECK(math::near(r[n][0], r_k[n]));
+        }
+    }
+
+    SECTION("smallest block size")
+    {
+        // With a single lag every correlation is the product of the samples
+        const auto sample = [&](const TestType value) {
+            dsp::signal<TestType> x_n(g.sample_rate());
+            x_n.push_back(value);
+            return x_n;
+        };
+
+        const dsp::correlator_bank<TestType> single_bank({sample(2), sample(-3)}, 1);
+
+        const auto peaks = single_bank.peaks(sample(5));
+
+        REQUIRE(peaks.size() == 2);
+        CHECK(peaks[0].lag == 0);
+        CHECK(math::near(peaks[0].value, TestType(10)));
+        CHECK(peaks[1].lag == 0);
+        CHECK(math::near(peaks[1].value, TestType(-15)));
+    }
+}
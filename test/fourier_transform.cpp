@@ -1,15 +1,28 @@
 #include <catch2/catch_template_test_macros.hpp>
 #include <cmath>
 #include <complex>
+#include <cstddef>
+#include <limits>
 #include <tnt/dsp/fourier_transform.hpp>
+#include <tnt/dsp/multisignal.hpp>
 #include <tnt/dsp/signal.hpp>
 #include <tnt/dsp/signal_generator.hpp>
+#include <tnt/dsp/signal_view.hpp>
 #include <tnt/math/comparison.hpp>
+#include <utility>
+#include <vector>
 
 // TODO: Test fourier_transform/inverse_fourier_transform of larger sizes for speed
 
 using namespace tnt;
 
+// Forward declarations
+template <typename T>
+dsp::signal<std::complex<T>> dft(const dsp::signal<T>& x);
+
+template <typename T>
+dsp::signal<std::complex<T>> dft(const dsp::signal<std::complex<T>>& x);
+
 TEMPLATE_TEST_CASE("fourier_transform", "[fourier_transform]", double, float)
 {
     SECTION("fourier transform of a real signal")
@@ -55,6 +68,166 @@ TEMPLATE_TEST_CASE("fourier_transform", "[fourier_transform]", double, float)
     }
 }
 
+TEMPLATE_TEST_CASE("fourier_transform of larger sizes", "[fourier_transform]", double, float)
+{
+    for (const size_t N : {16, 60, 64, 100, 127})
+    {
+        const dsp::signal_generator<TestType> g(1000, N);
+
+        const auto x  = dsp::complex_signal(g.cosine(100), g.sine(230, 2));
+        const auto X  = dft(x);
+        const auto X2 = dsp::fourier_transform(x);
+        const auto x2 = dsp::inverse_fourier_transform(X2);
+
+        REQUIRE(X2.size() == N);
+        REQUIRE(x2.size() == N);
+
+        // Rounding errors grow with the size of the transform
+        const auto tolerance = std::numeric_limits<TestType>::epsilon() * 100 * N;
+
+        for (size_t m = 0; m < N; ++m)
+        {
+            CHECK(std::abs(X[m] - X2[m]) < tolerance);
+            CHECK(std::abs(x[m] - x2[m]) < tolerance);
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("fourier_transform of two real signals",
+                   "[fourier_transform]",
+                   double,
+                   float)
+{
+    for (size_t N = 1; N <= 10; ++N)
+    {
+        const dsp::signal_generator<TestType> g(1000, N);
+
+        const auto x1 = g.cosine(100);
+        const auto x2 = g.sine(300, 2, 1);
+
+        const auto X1 = dft(x1);
+        const auto X2 = dft(x2);
+
+        const auto [Y1, Y2] = dsp::fourier_transform(x1, x2);
+
+        REQUIRE(Y1.size() == N);
+        REQUIRE(Y2.size() == N);
+
+        for (size_t m = 0; m < N; ++m)
+        {
+            CHECK(math::near(X1[m].real(), Y1[m].real()));
+            CHECK(math::near(X1[m].imag(), Y1[m].imag()));
+            CHECK(math::near(X2[m].real(), Y2[m].real()));
+            CHECK(math::near(X2[m].imag(), Y2[m].imag()));
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("fourier_transform of signal views", "[fourier_transform]", double, float)
+{
+    const dsp::signal_generator<TestType> g(1000, 20);
+
+    const auto x = dsp::complex_signal(g.cosine(100), g.sine(230, 2));
+    const auto y = g.cosine(100);
+
+    for (const auto& [first, step] : {std::pair<size_t, ptrdiff_t>{3, 1}, {1, 2}})
+    {
+        const auto x_view = x.view().subview(first, 8, step);
+        const auto y_view = y.view().subview(first, 8, step);
+
+        const auto X  = dsp::fourier_transform(dsp::signal<std::complex<TestType>>(x_view));
+        const auto Y  = dsp::fourier_transform(dsp::signal<TestType>(y_view));
+        const auto X2 = dsp::fourier_transform(x_view);
+        const auto Y2 = dsp::fourier_transform(y_view);
+        const auto x2 = dsp::inverse_fourier_transform(X2.view());
+
+        REQUIRE(X2.size() == 8);
+        REQUIRE(Y2.size() == 8);
+        REQUIRE(x2.size() == 8);
+
+        for (size_t m = 0; m < 8; ++m)
+        {
+            CHECK(math::near(X[m].real(), X2[m].real()));
+            CHECK(math::near(X[m].imag(), X2[m].imag()));
+            CHECK(math::near(Y[m].real(), Y2[m].real()));
+            CHECK(math::near(Y[m].imag(), Y2[m].imag()));
+            CHECK(math::near(x_view[m].real(), x2[m].real()));
+            CHECK(math::near(x_view[m].imag(), x2[m].imag()));
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("fourier_transform of multisignal channels",
+                   "[fourier_transform]",
+                   double,
+                   float)
+{
+    const dsp::signal_generator<TestType> g(1000, 20);
+
+    dsp::multisignal<TestType> x = {
+        g.cosine(100),
+        g.sine(230, 2),
+    };
+
+    for (size_t c = 0; c < x.channels(); ++c)
+    {
+        const auto X  = dsp::fourier_transform(x.channel(c));
+        const auto X2 = dsp::fourier_transform(x.channel_view(c));
+
+        REQUIRE(X2.size() == X.size());
+        for (size_t m = 0; m < X.size(); ++m)
+        {
+            CHECK(math::near(X[m].real(), X2[m].real()));
+            CHECK(math::near(X[m].imag(), X2[m].imag()));
+        }
+    }
+
+    const auto [X_0, X_1] = dsp::fourier_transform(x.channel_view(0), x.channel_view(1));
+    const auto X_0_2      = dsp::fourier_transform(x.channel(0));
+
+    REQUIRE(X_0.size() == X_0_2.size());
+    for (size_t m = 0; m < X_0.size(); ++m)
+    {
+        CHECK(math::near(X_0[m].real(), X_0_2[m].real()));
+        CHECK(math::near(X_0[m].imag(), X_0_2[m].imag()));
+    }
+}
+
+TEMPLATE_TEST_CASE("fourier_transform of temporary signals", "[fourier_transform]", double, float)
+{
+    for (size_t N = 1; N <= 10; ++N)
+    {
+        const dsp::signal_generator<TestType> g(1000, N);
+
+        const auto x  = dsp::complex_signal(g.cosine(100), g.sine(100));
+        const auto X  = dsp::fourier_transform(x);
+        auto       x2 = x;
+
+        // The transforms are calculated in the storage of the moved signal
+        const auto* const data = x2.data();
+
+        auto X2 = dsp::fourier_transform(std::move(x2));
+        CHECK(X2.data() == data);
+
+        REQUIRE(X2.size() == N);
+        for (size_t m = 0; m < N; ++m)
+        {
+            CHECK(math::near(X[m].real(), X2[m].real()));
+            CHECK(math::near(X[m].imag(), X2[m].imag()));
+        }
+
+        const auto x3 = dsp::inverse_fourier_transform(std::move(X2));
+        CHECK(x3.data() == data);
+
+        REQUIRE(x3.size() == N);
+        for (size_t n = 0; n < N; ++n)
+        {
+            CHECK(math::near(x[n].real(), x3[n].real()));
+            CHECK(math::near(x[n].imag(), x3[n].imag()));
+        }
+    }
+}
+
 TEMPLATE_TEST_CASE("inverse_fourier_transform", "[inverse_fourier_transform]", double, float)
 {
     SECTION("inverse fourier transform of a real signal")
@@ -99,6 +272,71 @@ TEMPLATE_TEST_CASE("inverse_fourier_transform", "[inverse_fourier_transform]", d
     }
 }
 
+TEMPLATE_TEST_CASE("fft plan cache", "[fourier_transform]", double, float)
+{
+    const auto plan = dsp::impl::get_fft_plan<TestType>(60);
+    CHECK(dsp::impl::get_fft_plan<TestType>(60) == plan);
+
+    // A plan as large as the whole cache evicts every other plan
+    const auto N_large = dsp::impl::fft_plan_cache_bytes / sizeof(std::complex<TestType>);
+    CHECK(dsp::impl::get_fft_plan<TestType>(N_large)->size() == N_large);
+    CHECK(dsp::impl::get_fft_plan<TestType>(60) != plan);
+
+    // A plan that is still in use stays valid after it has been evicted
+    const dsp::signal_generator<TestType> g(1000, 60);
+
+    const auto x = g.cosine(100);
+    const auto X = dsp::fourier_transform(x);
+
+    dsp::signal<std::complex<TestType>> X_plan(1000, 60);
+    dsp::impl::real_fft(x.data(), X_plan.data(), *plan);
+
+    for (size_t m = 0; m < X.size(); ++m)
+    {
+        CHECK(math::near(X_plan[m].real(), X[m].real()));
+        CHECK(math::near(X_plan[m].imag(), X[m].imag()));
+    }
+}
+
+TEMPLATE_TEST_CASE("batched inverse fft", "[fourier_transform]", double, float)
+{
+    // Sizes that are a power of 2 (transformed as a batch) and that are not
+    for (const size_t N : {size_t(1), size_t(64), size_t(60)})
+    {
+        const dsp::signal_generator<TestType> g(1000, N);
+
+        const size_t                                     B = 5;
+        std::vector<dsp::signal<std::complex<TestType>>> X;
+        for (size_t i = 0; i < B; ++i)
+        {
+            X.push_back(dsp::fourier_transform(g.white_noise(1, i)));
+        }
+
+        // Sample n of sequence i is at n * B + i
+        std::vector<std::complex<TestType>> X_b(N * B);
+        for (size_t i = 0; i < B; ++i)
+        {
+            for (size_t n = 0; n < N; ++n)
+            {
+                X_b[n * B + i] = X[i][n];
+            }
+        }
+
+        const auto plan = dsp::impl::get_fft_plan<TestType>(N);
+        dsp::impl::batched_inverse_fft(X_b.data(), X_b.data(), B, *plan);
+
+        for (size_t i = 0; i < B; ++i)
+        {
+            const auto x_i = dsp::inverse_fourier_transform(X[i]);
+            for (size_t n = 0; n < N; ++n)
+            {
+                CHECK(math::near(X_b[n * B + i].real(), x_i[n].real()));
+                CHECK(math::near(X_b[n * B + i].imag(), x_i[n].imag()));
+            }
+        }
+    }
+}
+
 // Implementation of slow Fourier transform to compare against
 template <typename T>
 dsp::signal<std::complex<T>> dft(const dsp::signal<T>& x)
@@ -0,0 +1,127 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <complex>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <tnt/dsp/analysis.hpp>
+#include <tnt/dsp/fourier_transform.hpp>
+#include <tnt/dsp/mapped_signal.hpp>
+#include <tnt/dsp/signal.hpp>
+#include <tnt/dsp/signal_generator.hpp>
+#include <tnt/math/comparison.hpp>
+#include <type_traits>
+
+using namespace tnt;
+
+namespace
+{
+
+// Writes the raw samples of a signal to a temporary file
+template <typename T>
+std::filesystem::path write_samples(const dsp::signal<T>& x, const std::string& name)
+{
+    const auto path = std::filesystem::temp_directory_path() / name;
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(x.data()), x.size() * sizeof(T));
+
+    return path;
+}
+
+}  // namespace
+
+TEMPLATE_TEST_CASE("mapped_signal", "[mapped_signal]", double, float)
+{
+    const dsp::signal_generator<TestType> g(1000, 100);
+
+    const auto x    = dsp::complex_signal(g.cosine(100), g.sine(230, 2));
+    const auto path = write_samples(x, "tnt_dsp_mapped_signal_" + std::to_string(sizeof(TestType)));
+
+    SECTION("map all samples")
+    {
+        const dsp::mapped_signal<std::complex<TestType>> x_mapped(path, x.sample_rate());
+
+        CHECK(x_mapped.sample_rate() == x.sample_rate());
+        CHECK(x_mapped.mode() == dsp::map_mode::read_only);
+        REQUIRE(x_mapped.size() == x.size());
+
+        x_mapped.advise(dsp::access_hint::sequential);
+
+        size_t n = 0;
+        for (const auto& sample : x_mapped)
+        {
+            CHECK(sample == x[n++]);
+        }
+    }
+
+    SECTION("map a range of samples")
+    {
+        const auto offset = 10 * sizeof(std::complex<TestType>);
+
+        const dsp::mapped_signal<std::complex<TestType>> x_mapped(
+            path, x.sample_rate(), offset, 50);
+
+        REQUIRE(x_mapped.size() == 50);
+
+        x_mapped.advise(dsp::access_hint::will_need, 10, 20);
+
+        for (size_t n = 0; n < x_mapped.size(); ++n)
+        {
+            CHECK(x_mapped[n] == x[n + 10]);
+        }
+    }
+
+    SECTION("transform a mapped signal")
+    {
+        const dsp::mapped_signal<std::complex<TestType>> x_mapped(path, x.sample_rate());
+
+        const auto X        = dsp::fourier_transform(x);
+        const auto X_mapped = dsp::fourier_transform(x_mapped.view());
+        const auto P_mapped = dsp::power(x_mapped.view());
+
+        REQUIRE(X_mapped.size() == X.size());
+        REQUIRE(P_mapped.size() == x.size());
+
+        for (size_t m = 0; m < X.size(); ++m)
+        {
+            CHECK(math::near(X_mapped[m].real(), X[m].real()));
+            CHECK(math::near(X_mapped[m].imag(), X[m].imag()));
+            CHECK(math::near(P_mapped[m], std::norm(x[m])));
+        }
+    }
+
+    SECTION("read-only mappings only give constant access")
+    {
+        using sample = std::complex<TestType>;
+
+        dsp::mapped_signal<sample> x_mapped(path, x.sample_rate());
+
+        CHECK((std::is_same_v<decltype(x_mapped[0]), const sample&>));
+        CHECK((std::is_same_v<decltype(x_mapped.data()), const sample*>));
+        CHECK((std::is_same_v<decltype(x_mapped.view()), dsp::signal_view<const sample>>));
+        CHECK((std::is_same_v<decltype(x_mapped.begin()), const sample*>));
+        CHECK((std::is_same_v<decltype(x_mapped.end()), const sample*>));
+
+        CHECK(x_mapped[0] == x[0]);
+    }
+
+    SECTION("copy-on-write does not modify the file")
+    {
+        {
+            dsp::mapped_signal<std::complex<TestType>, dsp::map_mode::copy_on_write> x_mapped(
+                path, x.sample_rate());
+
+            CHECK(x_mapped.mode() == dsp::map_mode::copy_on_write);
+
+            x_mapped[0] = 0;
+            CHECK(x_mapped[0] == std::complex<TestType>(0));
+        }
+
+        const dsp::mapped_signal<std::complex<TestType>> x_mapped(path, x.sample_rate());
+
+        REQUIRE(x_mapped.size() == x.size());
+        CHECK(x_mapped[0] == x[0]);
+    }
+
+    std::filesystem::remove(path);
+}
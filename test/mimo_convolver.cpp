@@ -0,0 +1,120 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <tnt/dsp/convolution.hpp>
+#include <tnt/dsp/mimo_convolver.hpp>
+#include <tnt/dsp/multisignal.hpp>
+#include <tnt/dsp/signal.hpp>
+#include <tnt/dsp/signal_generator.hpp>
+#include <tnt/math/comparison.hpp>
+#include <vector>
+
+using namespace tnt;
+
+TEMPLATE_TEST_CASE("mimo_convolver", "[mimo_convolver]", double, float)
+{
+    const dsp::signal_generator<TestType> g(1000, 12);
+
+    // 3 outputs x 2 inputs
+    const std::vector<std::vector<dsp::signal<TestType>>> filters = {
+        {g.cosine(100), g.sine(100)},
+        {g.sine(200, 2), g.cosine(50, 1, 1)},
+        {g.cosine(300, 1, 0, 1), g.sine(100, 3)},
+    };
+
+    const dsp::mimo_convolver<TestType> convolver(filters, g.size());
+
+    const dsp::multisignal<TestType> x = {
+        g.cosine(100, 1, 0.5),
+        g.sine(250, 2, 0.25),
+    };
+
+    SECTION("construction")
+    {
+        CHECK(convolver.sample_rate() == g.sample_rate());
+        CHECK(convolver.block_size() == g.size());
+        CHECK(convolver.inputs() == 2);
+        CHECK(convolver.outputs() == 3);
+    }
+
+    SECTION("process matches the sum of convolutions")
+    {
+        for (size_t threads = 1; threads <= 3; ++threads)
+        {
+            const auto y = convolver.process(x, threads);
+
+            REQUIRE(y.size() == x.size());
+            REQUIRE(y.channels() == filters.size());
+
+            for (size_t o = 0; o < filters.size(); ++o)
+            {
+                const auto y_0 = dsp::convolve(x.channel(0), filters[o][0]);
+                const auto y_1 = dsp::convolve(x.channel(1), filters[o][1]);
+
+                for (size_t n = 0; n < y.size(); ++n)
+                {
+                    CHECK(math::near(y[n][o], y_0[n] + y_1[n]));
+                }
+            }
+        }
+    }
+
+    SECTION("odd number of inputs")
+    {
+        // The last input is transformed on its own rather than in a pair, for
+        // block sizes that are a power of 2 and that are not
+        for (const size_t N : {size_t(12), size_t(16)})
+        {
+            const dsp::signal_generator<TestType> g_N(1000, N);
+
+            const std::vector<std::vector<dsp::signal<TestType>>> filters_3 = {
+                {g_N.cosine(100), g_N.sine(100), g_N.cosine(200, 2)},
+                {g_N.sine(50), g_N.cosine(300, 1, 1), g_N.sine(150, 3)},
+            };
+
+            const dsp::mimo_convolver<TestType> convolver_3(filters_3, N);
+            const dsp::multisignal<TestType>    x_3 = {
+                g_N.white_noise(1, 0),
+                g_N.white_noise(1, 1),
+                g_N.white_noise(1, 2),
+            };
+
+            const auto y = convolver_3.process(x_3);
+
+            REQUIRE(y.channels() == filters_3.size());
+
+            for (size_t o = 0; o < filters_3.size(); ++o)
+            {
+                dsp::signal<TestType> y_o(1000, N);
+                for (size_t i = 0; i < x_3.channels(); ++i)
+                {
+                    y_o += dsp::convolve(x_3.channel(i), filters_3[o][i]);
+                }
+
+                for (size_t n = 0; n < N; ++n)
+                {
+                    CHECK(math::near(y[n][o], y_o[n]));
+                }
+            }
+        }
+    }
+
+    SECTION("smallest block size")
+    {
+        // With one sample per block the filters are gains
+        const auto sample = [](const TestType value) {
+            dsp::signal<TestType> x_n(1000);
+            x_n.push_back(value);
+            return x_n;
+        };
+
+        const std::vector<std::vector<dsp::signal<TestType>>> gains = {{sample(2), sample(-3)}};
+
+        const dsp::mimo_convolver<TestType> convolver_1(gains, 1);
+        const dsp::multisignal<TestType>    x_1 = {sample(5), sample(7)};
+
+        const auto y = convolver_1.process(x_1);
+
+        REQUIRE(y.size() == 1);
+        REQUIRE(y.channels() == 1);
+        CHECK(math::near(y[0][0], 2 * 5 - 3 * 7));
+    }
+}
@@ -1,10 +1,13 @@
 #include <algorithm>
 #include <catch2/catch_template_test_macros.hpp>
 #include <complex>
+#include <memory>
 #include <tnt/dsp/multisignal.hpp>
 #include <tnt/dsp/signal.hpp>
 #include <tnt/dsp/signal_generator.hpp>
 #include <tnt/math/comparison.hpp>
+#include <utility>
+#include <vector>
 
 using namespace tnt;
 
@@ -86,6 +89,72 @@ TEMPLATE_TEST_CASE("multisignal construction", "[multisignal][construction]", do
         CHECK(x.channels() == 2);
     }
 
+    SECTION("construct a multi-channel signal from a vector of signals")
+    {
+        const std::vector<dsp::signal<TestType>> signals = {
+            g.cosine(100),
+            g.sine(100),
+            g.cosine(200),
+        };
+
+        const dsp::multisignal<TestType> x(signals);
+
+        CHECK(x.sample_rate() == 1000);
+        REQUIRE(x.size() == 10);
+        REQUIRE(x.channels() == 3);
+
+        for (size_t n = 0; n < x.size(); ++n)
+        {
+            for (size_t c = 0; c < x.channels(); ++c)
+            {
+                CHECK(x[n][c] == signals[c][n]);
+            }
+        }
+    }
+
+    SECTION("construct a multi-channel signal from interleaved samples")
+    {
+        for (const size_t channels : {1, 2, 3, 4, 8, 9, 17})
+        {
+            // Not a multiple of the transpose block size
+            const size_t size = 37;
+
+            std::vector<TestType> data(size * channels);
+            for (size_t i = 0; i < data.size(); ++i)
+            {
+                data[i] = static_cast<TestType>(i);
+            }
+
+            const dsp::multisignal<TestType> x(1000, data.data(), size, channels);
+
+            CHECK(x.sample_rate() == 1000);
+            REQUIRE(x.size() == size);
+            REQUIRE(x.channels() == channels);
+
+            for (size_t n = 0; n < size; ++n)
+            {
+                for (size_t c = 0; c < channels; ++c)
+                {
+                    CHECK(x[n][c] == data[n * channels + c]);
+                }
+            }
+
+            std::vector<TestType> interleaved(size * channels);
+            x.copy_interleaved(interleaved.data());
+            CHECK(interleaved == data);
+
+            std::vector<TestType> planar(size * channels);
+            x.copy_planar(planar.data());
+            for (size_t c = 0; c < channels; ++c)
+            {
+                for (size_t n = 0; n < size; ++n)
+                {
+                    CHECK(planar[c * size + n] == data[n * channels + c]);
+                }
+            }
+        }
+    }
+
     SECTION("copy constructor")
     {
         const dsp::multisignal<TestType> x1 = {
@@ -214,6 +283,54 @@ TEMPLATE_TEST_CASE("multisignal accessors", "[multisignal][accessors]", double,
         }
     }
 
+    SECTION("channel_view")
+    {
+        const auto c0 = g.cosine(100);
+        const auto c1 = g.sine(100);
+
+        dsp::multisignal<TestType> x = {
+            c0,
+            c1,
+        };
+
+        const auto x_c1 = x.channel_view(1);
+
+        CHECK(x_c1.sample_rate() == x.sample_rate());
+        CHECK(x_c1.contiguous());
+        REQUIRE(x_c1.size() == x.size());
+
+        for (size_t n = 0; n < x.size(); ++n)
+        {
+            CHECK(math::near(x_c1[n], c1[n]));
+        }
+
+        // Views refer to the samples of the multi-channel signal
+        x_c1[3] = 7;
+        CHECK(math::near(x[3][1], 7));
+        CHECK(math::near(std::as_const(x).channel_view(1)[3], 7));
+    }
+
+    SECTION("frame_view")
+    {
+        const auto c0 = g.cosine(100);
+        const auto c1 = g.sine(100);
+
+        dsp::multisignal<TestType> x = {
+            c0,
+            c1,
+        };
+
+        const auto x_4 = x.frame_view(4);
+
+        REQUIRE(x_4.size() == x.channels());
+        CHECK(math::near(x_4[0], c0[4]));
+        CHECK(math::near(x_4[1], c1[4]));
+
+        x_4[0] = 7;
+        CHECK(math::near(x.channel_view(0)[4], 7));
+        CHECK(math::near(std::as_const(x).frame_view(4)[0], 7));
+    }
+
     SECTION("duration")
     {
         const dsp::multisignal<TestType> x(1000, 2500);
@@ -374,6 +491,28 @@ TEMPLATE_TEST_CASE("multisignal modifiers", "[multisignal][modifiers]", double,
         }
     }
 
+    SECTION("add_channel from a view of its own channel")
+    {
+        dsp::multisignal<TestType> x = {g.cosine(100)};
+
+        // Each channel added grows the buffer the view points into
+        for (size_t c = 1; c < 8; ++c)
+        {
+            x.add_channel(x.channel_view(c - 1));
+        }
+
+        REQUIRE(x.channels() == 8);
+
+        const auto data = g.cosine(100);
+        for (size_t c = 0; c < x.channels(); ++c)
+        {
+            for (size_t n = 0; n < x.size(); ++n)
+            {
+                CHECK(x.channel_view(c)[n] == data[n]);
+            }
+        }
+    }
+
     SECTION("swap")
     {
         dsp::multisignal<TestType> x1 = {
@@ -407,3 +546,70 @@ TEMPLATE_TEST_CASE("multisignal modifiers", "[multisignal][modifiers]", double,
         }
     }
 }
+
+TEMPLATE_TEST_CASE("multisignal allocators", "[multisignal][allocators]", double, float)
+{
+    const dsp::signal_generator<TestType> g(1000, 10);
+
+    SECTION("samples of each channel are contiguous and cache line aligned")
+    {
+        const dsp::multisignal<TestType> x = {
+            g.cosine(100),
+            g.sine(100),
+            g.cosine(200),
+        };
+
+        for (size_t c = 0; c < x.channels(); ++c)
+        {
+            CHECK(dsp::impl::is_aligned(&x[0][c], dsp::cache_line_size));
+
+            for (size_t n = 1; n < x.size(); ++n)
+            {
+                CHECK(&x[n][c] == &x[n - 1][c] + 1);
+            }
+        }
+    }
+
+    SECTION("construct with uninitialized samples")
+    {
+        dsp::multisignal<std::complex<TestType>> x(1000, 10, 3, dsp::uninitialized);
+
+        CHECK(x.size() == 10);
+        CHECK(x.channels() == 3);
+
+        for (size_t n = 0; n < x.size(); ++n)
+        {
+            for (size_t c = 0; c < x.channels(); ++c)
+            {
+                x[n][c] = {static_cast<TestType>(n), static_cast<TestType>(c)};
+            }
+        }
+
+        const auto x1 = x.channel(1);
+        for (size_t n = 0; n < x.size(); ++n)
+        {
+            CHECK(x1[n] == std::complex<TestType>(static_cast<TestType>(n), 1));
+        }
+    }
+
+    SECTION("custom allocator")
+    {
+        using allocator = std::allocator<TestType>;
+
+        dsp::signal<TestType, allocator> x1(g.sample_rate(), g.size());
+        const auto                       data = g.cosine(100);
+        std::copy(data.begin(), data.end(), x1.begin());
+
+        dsp::multisignal<TestType, allocator> x(g.sample_rate());
+        x.add_channel(x1);
+
+        REQUIRE(x.channels() == 1);
+        const auto x2 = x.channel(0);
+        REQUIRE(x2.size() == data.size());
+
+        for (size_t n = 0; n < x2.size(); ++n)
+        {
+            CHECK(math::near(x2[n], data[n]));
+        }
+    }
+}
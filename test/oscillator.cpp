@@ -0,0 +1,174 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <cmath>
+#include <complex>
+#include <tnt/dsp/oscillator.hpp>
+#include <tnt/dsp/signal.hpp>
+#include <tnt/dsp/signal_generator.hpp>
+#include <tnt/dsp/signal_view.hpp>
+#include <tnt/math/comparison.hpp>
+#include <vector>
+
+using namespace tnt;
+
+TEMPLATE_TEST_CASE("oscillator construction", "[oscillator][construction]", double, float)
+{
+    const dsp::oscillator<TestType> osc(48000, 1000, 2, 1);
+
+    CHECK(osc.sample_rate() == 48000);
+    CHECK(math::near(osc.frequency(), TestType(1000)));
+    CHECK(osc.amplitude() == 2);
+    CHECK(math::near(osc.phase(), TestType(1)));
+    CHECK(osc.smoothing() == 48);
+}
+
+TEMPLATE_TEST_CASE("oscillator blocks", "[oscillator][blocks]", double, float)
+{
+    const size_t   f_s         = 1000;
+    const size_t   N           = 2000;
+    const TestType frequency   = 37;
+    const TestType amplitude   = 2;
+    const TestType phase_shift = static_cast<TestType>(0.5);
+
+    const dsp::signal_generator<TestType> g(f_s, N);
+
+    using complex_view = dsp::signal_view<std::complex<TestType>>;
+
+    // Blocks of uneven sizes, including empty ones
+    const std::vector<size_t> blocks = {0, 1, 7, 64, 100, 3, 0, 500, 1025, 300};
+
+    SECTION("consecutive blocks are phase continuous")
+    {
+        const auto c = g.cosine(frequency, amplitude, phase_shift);
+        const auto s = g.sine(frequency, amplitude, phase_shift);
+        const auto e = g.complex_exponential(frequency, amplitude, phase_shift);
+
+        dsp::oscillator<TestType> osc_c(f_s, frequency, amplitude, phase_shift);
+        dsp::oscillator<TestType> osc_s(f_s, frequency, amplitude, phase_shift);
+        dsp::oscillator<TestType> osc_e(f_s, frequency, amplitude, phase_shift);
+
+        dsp::signal<TestType>               y_c(f_s, N);
+        dsp::signal<TestType>               y_s(f_s, N);
+        dsp::signal<std::complex<TestType>> y_e(f_s, N);
+
+        size_t n = 0;
+        for (const auto& block : blocks)
+        {
+            osc_c.cosine(dsp::signal_view<TestType>(f_s, y_c.data() + n, block));
+            osc_s.sine(dsp::signal_view<TestType>(f_s, y_s.data() + n, block));
+            osc_e.complex_exponential(complex_view(f_s, y_e.data() + n, block));
+            n += block;
+        }
+
+        REQUIRE(n == N);
+
+        for (size_t n = 0; n < N; ++n)
+        {
+            CHECK(math::near(y_c[n], c[n]));
+            CHECK(math::near(y_s[n], s[n]));
+            CHECK(math::near(y_e[n].real(), e[n].real()));
+            CHECK(math::near(y_e[n].imag(), e[n].imag()));
+        }
+    }
+
+    SECTION("strided views")
+    {
+        const auto s = g.sine(frequency, amplitude, phase_shift);
+
+        dsp::oscillator<TestType> osc(f_s, frequency, amplitude, phase_shift);
+
+        std::vector<TestType> y(2 * N);
+        osc.sine(dsp::signal_view<TestType>(f_s, y.data(), N / 2, 2));
+        osc.sine(dsp::signal_view<TestType>(f_s, y.data() + N, N / 2, 2));
+
+        for (size_t n = 0; n < N; ++n)
+        {
+            CHECK(math::near(y[2 * n], s[n]));
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("oscillator changes", "[oscillator][changes]", double, float)
+{
+    const size_t f_s = 1000;
+    const size_t N   = 1000;
+
+    const TestType f_0 = 50;
+    const TestType f_1 = 120;
+
+    using complex_view = dsp::signal_view<std::complex<TestType>>;
+
+    dsp::signal<std::complex<TestType>> z(f_s, N);
+
+    // Phase advance between consecutive samples
+    const auto omega = [&](const size_t n) {
+        return std::arg(std::complex<double>(z[n + 1]) * std::conj(std::complex<double>(z[n])));
+    };
+
+    SECTION("frequency changes are ramped")
+    {
+        dsp::oscillator<TestType> osc(f_s, f_0);
+        osc.set_smoothing(200);
+
+        osc.complex_exponential(complex_view(f_s, z.data(), 100));
+        osc.set_frequency(f_1);
+        CHECK(math::near(osc.frequency(), f_1));
+        osc.complex_exponential(complex_view(f_s, z.data() + 100, N - 100));
+
+        const auto omega_0 = 2 * M_PI * f_0 / f_s;
+        const auto omega_1 = 2 * M_PI * f_1 / f_s;
+
+        for (size_t n = 0; n < N - 1; ++n)
+        {
+            CHECK(math::near(std::abs(z[n]), TestType(1)));
+
+            if (n <= 100)
+            {
+                CHECK(std::abs(omega(n) - omega_0) < 1e-3);
+            }
+            else if (n >= 300)
+            {
+                CHECK(std::abs(omega(n) - omega_1) < 1e-3);
+            }
+            else
+            {
+                // The frequency rises steadily during the ramp
+                CHECK(omega(n) > omega(n - 1));
+                CHECK(omega(n) - omega(n - 1) < 2 * (omega_1 - omega_0) / 200);
+            }
+        }
+    }
+
+    SECTION("amplitude changes are ramped")
+    {
+        dsp::oscillator<TestType> osc(f_s, f_0, 1);
+        osc.set_smoothing(100);
+
+        osc.complex_exponential(complex_view(f_s, z.data(), 10));
+        osc.set_amplitude(3);
+        CHECK(osc.amplitude() == 3);
+        osc.complex_exponential(complex_view(f_s, z.data() + 10, N - 10));
+
+        for (size_t n = 0; n < N; ++n)
+        {
+            const auto expected = n < 10 ? 1 : n < 110 ? 1 + 2 * TestType(n - 10) / 100 : 3;
+            CHECK(math::near(std::abs(z[n]), static_cast<TestType>(expected)));
+        }
+    }
+
+    SECTION("changes are applied at once without smoothing")
+    {
+        dsp::oscillator<TestType> osc(f_s, f_0, 1);
+        osc.set_smoothing(0);
+
+        osc.complex_exponential(complex_view(f_s, z.data(), 10));
+        osc.set_frequency(f_1);
+        osc.set_amplitude(2);
+        osc.complex_exponential(complex_view(f_s, z.data() + 10, N - 10));
+
+        for (size_t n = 10; n < N - 1; ++n)
+        {
+            CHECK(math::near(std::abs(z[n]), TestType(2)));
+            CHECK(std::abs(omega(n) - 2 * M_PI * f_1 / f_s) < 1e-3);
+        }
+    }
+}
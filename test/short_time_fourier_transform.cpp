@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <catch2/catch_template_test_macros.hpp>
+#include <complex>
+#include <cstddef>
+#include <tnt/dsp/analysis.hpp>
+#include <tnt/dsp/fourier_transform.hpp>
+#include <tnt/dsp/multisignal.hpp>
+#include <tnt/dsp/short_time_fourier_transform.hpp>
+#include <tnt/dsp/signal.hpp>
+#include <tnt/dsp/signal_generator.hpp>
+#include <tnt/math/comparison.hpp>
+#include <vector>
+
+using namespace tnt;
+
+TEMPLATE_TEST_CASE("short_time_fourier_transform",
+                   "[short_time_fourier_transform]",
+                   double,
+                   float)
+{
+    const size_t L = 64;
+
+    const dsp::signal_generator<TestType> g_w(1024, L);
+
+    // Periodic Hann window
+    const dsp::signal<TestType> window = TestType(0.5) - g_w.cosine(1024 / L, TestType(0.5));
+
+    const dsp::signal_generator<TestType> g(1024, 1000);
+    const auto                            x = g.white_noise();
+
+    // Transforms frame f of x directly
+    const auto transform_frame = [&](const dsp::short_time_fourier_transform<TestType>& stft,
+                                     const size_t                                       f) {
+        const auto offset = stft.padding() == dsp::stft_padding::centered ? L / 2 : 0;
+
+        dsp::signal<TestType> frame(x.sample_rate(), stft.fft_size());
+        for (size_t n = 0; n < L; ++n)
+        {
+            if (f * stft.hop() + n >= offset && f * stft.hop() + n - offset < x.size())
+            {
+                frame[n] = window[n] * x[f * stft.hop() + n - offset];
+            }
+        }
+
+        return dsp::fourier_transform(frame);
+    };
+
+    SECTION("construction")
+    {
+        const dsp::short_time_fourier_transform<TestType> stft(window, 16);
+
+        CHECK(stft.sample_rate() == 1024);
+        CHECK(stft.frame_size() == L);
+        CHECK(stft.hop() == 16);
+        CHECK(stft.fft_size() == L);
+        CHECK(stft.bins() == L / 2 + 1);
+        CHECK(stft.padding() == dsp::stft_padding::centered);
+
+        CHECK(stft.frames(0) == 0);
+        CHECK(stft.frames(1) == 1);
+        CHECK(stft.frames(1000) == 63);
+
+        const dsp::short_time_fourier_transform<TestType> stft_none(
+            window, 16, 100, dsp::stft_padding::none);
+
+        CHECK(stft_none.fft_size() == 100);
+        CHECK(stft_none.bins() == 51);
+
+        CHECK(stft_none.frames(L - 1) == 0);
+        CHECK(stft_none.frames(L) == 1);
+        CHECK(stft_none.frames(1000) == 59);
+    }
+
+    SECTION("transform matches the transforms of the windowed frames")
+    {
+        for (const auto padding : {dsp::stft_padding::none, dsp::stft_padding::centered})
+        {
+            // Power of 2 and padded to a size that is not
+            for (const size_t fft_size : {L, size_t(100)})
+            {
+                const dsp::short_time_fourier_transform<TestType> stft(
+                    window, 16, fft_size, padding);
+
+                const auto X = stft.transform(x);
+
+                REQUIRE(X.channels() == stft.frames(x.size()));
+                REQUIRE(X.size() == stft.bins());
+
+                for (size_t f = 0; f < X.channels(); ++f)
+                {
+                    const auto X_f = transform_frame(stft, f);
+                    for (size_t m = 0; m < X.size(); ++m)
+                    {
+                        CHECK(math::near(X.channel_view(f)[m].real(), X_f[m].real()));
+                        CHECK(math::near(X.channel_view(f)[m].imag(), X_f[m].imag()));
+                    }
+                }
+            }
+        }
+    }
+
+    SECTION("threads do not change the result")
+    {
+        const dsp::short_time_fourier_transform<TestType> stft(window, 16);
+
+        const auto X = stft.transform(x);
+        for (size_t threads = 2; threads <= 4; ++threads)
+        {
+            dsp::multisignal<std::complex<TestType>> X_t(
+                x.sample_rate(), stft.bins(), stft.frames(x.size()));
+            stft.transform(x, X_t, threads);
+
+            for (size_t f = 0; f < X.channels(); ++f)
+            {
+                for (size_t m = 0; m < X.size(); ++m)
+                {
+                    CHECK(X_t.channel_view(f)[m] == X.channel_view(f)[m]);
+                }
+            }
+        }
+    }
+
+    SECTION("spectrogram")
+    {
+        const dsp::short_time_fourier_transform<TestType> stft(window, 16);
+
+        const auto X = stft.transform(x);
+        const auto S = stft.spectrogram(x, 2);
+
+        REQUIRE(S.channels() == X.channels());
+        REQUIRE(S.size() == X.size());
+
+        for (size_t f = 0; f < X.channels(); ++f)
+        {
+            const auto X_power = dsp::power(X.channel_view(f));
+            for (size_t m = 0; m < X.size(); ++m)
+            {
+                CHECK(math::near(S.channel_view(f)[m], X_power[m]));
+            }
+        }
+    }
+
+    SECTION("streaming matches the offline transform")
+    {
+        // Frames that overlap and frames with gaps between them
+        for (const size_t hop : {size_t(16), size_t(80)})
+        {
+            for (const auto padding : {dsp::stft_padding::none, dsp::stft_padding::centered})
+            {
+                dsp::short_time_fourier_transform<TestType> stft(window, hop, padding);
+
+                const auto X = stft.transform(x);
+
+                using spectrum_view = dsp::signal_view<const std::complex<TestType>>;
+
+                std::vector<dsp::signal<std::complex<TestType>>> frames;
+                const auto collect = [&](const spectrum_view& X_f) {
+                    frames.emplace_back(X_f);
+                };
+
+                // Blocks of uneven sizes
+                size_t n = 0;
+                for (size_t block = 1; n < x.size(); block = block * 3 + 1)
+                {
+                    const auto count = std::min(block, x.size() - n);
+
+                    stft.push(x.view().subview(n, count), collect);
+                    n += count;
+                }
+
+                stft.flush(collect);
+
+                REQUIRE(frames.size() == X.channels());
+                for (size_t f = 0; f < X.channels(); ++f)
+                {
+                    for (size_t m = 0; m < X.size(); ++m)
+                    {
+                        CHECK(math::near(frames[f][m].real(), X.channel_view(f)[m].real()));
+                        CHECK(math::near(frames[f][m].imag(), X.channel_view(f)[m].imag()));
+                    }
+                }
+
+                // The stream starts over after a flush
+                frames.clear();
+                stft.push(x, collect);
+                stft.flush(collect);
+
+                CHECK(frames.size() == X.channels());
+            }
+        }
+    }
+
+    SECTION("inverse reconstructs the signal")
+    {
+        for (const size_t fft_size : {L, size_t(100)})
+        {
+            const dsp::short_time_fourier_transform<TestType> stft(window, 16, fft_size);
+
+            const auto y = stft.inverse(stft.transform(x), x.size());
+
+            REQUIRE(y.size() == x.size());
+            CHECK(y.sample_rate() == x.sample_rate());
+
+            for (size_t n = 0; n < x.size(); ++n)
+            {
+                CHECK(math::near(y[n], x[n]));
+            }
+        }
+    }
+
+    SECTION("inverse of modified spectra")
+    {
+        const dsp::short_time_fourier_transform<TestType> stft(
+            window, 16, dsp::stft_padding::none);
+
+        auto X = stft.transform(x);
+        for (size_t f = 0; f < X.channels(); ++f)
+        {
+            for (auto& X_f_m : X.channel_view(f))
+            {
+                X_f_m *= 2;
+            }
+        }
+
+        const auto y = stft.inverse(X, x.size());
+
+        // The first sample is only covered by the zero at the start of the
+        // window, so it cannot be reconstructed
+        CHECK(y[0] == 0);
+        for (size_t n = 1; n < 960; ++n)
+        {
+            CHECK(math::near(y[n], 2 * x[n]));
+        }
+    }
+}
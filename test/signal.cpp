@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <catch2/catch_template_test_macros.hpp>
 #include <complex>
+#include <memory>
 #include <tnt/dsp/signal.hpp>
 #include <tnt/dsp/signal_generator.hpp>
 #include <tnt/math/comparison.hpp>
@@ -43,6 +44,25 @@ TEMPLATE_TEST_CASE("signal construction", "[signal][construction]", double, floa
         CHECK(x.size() == 10);
     }
 
+    SECTION("construct a signal with uninitialized samples")
+    {
+        dsp::signal<TestType>               x1(1000, 10, dsp::uninitialized);
+        dsp::signal<std::complex<TestType>> x2(1000, 10, dsp::uninitialized);
+
+        CHECK(x1.sample_rate() == 1000);
+        CHECK(x2.sample_rate() == 1000);
+        CHECK(x1.size() == 10);
+        CHECK(x2.size() == 10);
+        CHECK(dsp::impl::is_aligned(x1.data(), dsp::cache_line_size));
+        CHECK(dsp::impl::is_aligned(x2.data(), dsp::cache_line_size));
+
+        std::fill(x1.begin(), x1.end(), 1);
+        std::fill(x2.begin(), x2.end(), std::complex<TestType>(1, 2));
+
+        CHECK(x1[9] == 1);
+        CHECK(x2[9] == std::complex<TestType>(1, 2));
+    }
+
     SECTION("construct a complex signal from two real signals")
     {
         const auto x1_real = g.cosine(100);
@@ -238,6 +258,31 @@ TEMPLATE_TEST_CASE("signal capacity", "[signal][capacity]", double, float)
         CHECK(x.size() == 10);
         CHECK(x.capacity() == capacity);
     }
+
+    SECTION("samples added by resize are zero")
+    {
+        dsp::signal<TestType>               x1(1000, 10);
+        dsp::signal<std::complex<TestType>> x2(1000, 10);
+        std::fill(x1.begin(), x1.end(), 1);
+        std::fill(x2.begin(), x2.end(), std::complex<TestType>(1, 2));
+
+        x1.resize(5);
+        x2.resize(5);
+        x1.resize(10);
+        x2.resize(10);
+
+        for (size_t n = 5; n < 10; ++n)
+        {
+            CHECK(x1[n] == 0);
+            CHECK(x2[n] == std::complex<TestType>());
+        }
+
+        x1.resize(20, dsp::uninitialized);
+        x2.resize(20, dsp::uninitialized);
+
+        CHECK(x1.size() == 20);
+        CHECK(x2.size() == 20);
+    }
 }
 
 TEMPLATE_TEST_CASE("signal modifiers", "[signal][modifiers]", double, float)
@@ -295,3 +340,28 @@ TEMPLATE_TEST_CASE("complex_signal", "[complex_signal]", double, float)
         CHECK(math::near(x2[n].imag(), x1_imag[n]));
     }
 }
+
+TEMPLATE_TEST_CASE("signal allocators", "[signal][allocators]", double, float)
+{
+    SECTION("samples are cache line aligned by default")
+    {
+        const dsp::signal<TestType>               x1(1000, 10);
+        const dsp::signal<std::complex<TestType>> x2(1000, 10);
+
+        CHECK(dsp::impl::is_aligned(x1.data(), dsp::cache_line_size));
+        CHECK(dsp::impl::is_aligned(x2.data(), dsp::cache_line_size));
+    }
+
+    SECTION("custom allocator")
+    {
+        dsp::signal<TestType, std::allocator<TestType>> x1(1000, 10);
+        dsp::signal<TestType, std::allocator<TestType>> x2(1000);
+        x1[3] = 1;
+
+        swap(x1, x2);
+
+        CHECK(x1.size() == 0);
+        REQUIRE(x2.size() == 10);
+        CHECK(x2[3] == 1);
+    }
+}
@@ -0,0 +1,151 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <complex>
+#include <tnt/dsp/signal.hpp>
+#include <tnt/dsp/signal_expression.hpp>
+#include <tnt/dsp/signal_generator.hpp>
+#include <tnt/math/comparison.hpp>
+
+using namespace tnt;
+
+TEMPLATE_TEST_CASE("signal_expression arithmetic", "[signal_expression][arithmetic]", double, float)
+{
+    const dsp::signal_generator<TestType> g(1000, 10);
+
+    const auto a = g.cosine(100);
+    const auto b = g.sine(100);
+    const auto w = g.cosine(50, 2, 1);
+
+    SECTION("element-wise operations")
+    {
+        const dsp::signal<TestType> sum        = a + b;
+        const dsp::signal<TestType> difference = a - b;
+        const dsp::signal<TestType> product    = a * b;
+        const dsp::signal<TestType> quotient   = a / w;
+        const dsp::signal<TestType> negation   = -a;
+
+        CHECK(sum.sample_rate() == a.sample_rate());
+        REQUIRE(sum.size() == a.size());
+
+        for (size_t n = 0; n < a.size(); ++n)
+        {
+            CHECK(math::near(sum[n], a[n] + b[n]));
+            CHECK(math::near(difference[n], a[n] - b[n]));
+            CHECK(math::near(product[n], a[n] * b[n]));
+            CHECK(math::near(quotient[n], a[n] / w[n]));
+            CHECK(math::near(negation[n], -a[n]));
+        }
+    }
+
+    SECTION("scalar operations")
+    {
+        const dsp::signal<TestType> x = 2 * a + b * 0.5 - 1;
+        const dsp::signal<TestType> y = 1 / w;
+
+        REQUIRE(x.size() == a.size());
+        REQUIRE(y.size() == w.size());
+
+        for (size_t n = 0; n < a.size(); ++n)
+        {
+            CHECK(math::near(x[n], 2 * a[n] + b[n] / 2 - 1));
+            CHECK(math::near(y[n], 1 / w[n]));
+        }
+    }
+
+    SECTION("mixed real and complex operations")
+    {
+        const auto x = dsp::complex_signal(a, b);
+
+        const dsp::signal<std::complex<TestType>> y = x * w + std::complex<TestType>(0, 1);
+
+        REQUIRE(y.size() == x.size());
+
+        for (size_t n = 0; n < x.size(); ++n)
+        {
+            CHECK(math::near(y[n].real(), a[n] * w[n]));
+            CHECK(math::near(y[n].imag(), b[n] * w[n] + 1));
+        }
+    }
+
+    SECTION("operations on views and temporaries")
+    {
+        const auto x = dsp::evaluate(a.view().subview(0, 5, 2) + g.sine(100).view().subview(0, 5));
+        const auto y = dsp::evaluate(dsp::signal<TestType>(a) * 3);
+
+        REQUIRE(x.size() == 5);
+        REQUIRE(y.size() == a.size());
+
+        for (size_t n = 0; n < x.size(); ++n)
+        {
+            CHECK(math::near(x[n], a[2 * n] + b[n]));
+        }
+
+        for (size_t n = 0; n < y.size(); ++n)
+        {
+            CHECK(math::near(y[n], 3 * a[n]));
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("signal_expression assignment", "[signal_expression][assignment]", double, float)
+{
+    const dsp::signal_generator<TestType> g(1000, 10);
+
+    const auto a = g.cosine(100);
+    const auto b = g.sine(100);
+
+    SECTION("assignment")
+    {
+        dsp::signal<TestType> x(1000);
+
+        x = a * b;
+
+        REQUIRE(x.size() == a.size());
+
+        for (size_t n = 0; n < x.size(); ++n)
+        {
+            CHECK(math::near(x[n], a[n] * b[n]));
+        }
+    }
+
+    SECTION("assignment of an expression that refers to the signal")
+    {
+        auto x = a;
+
+        x = x * x + b;
+
+        for (size_t n = 0; n < x.size(); ++n)
+        {
+            CHECK(math::near(x[n], a[n] * a[n] + b[n]));
+        }
+    }
+
+    SECTION("compound assignment")
+    {
+        auto x = a;
+
+        x += b;
+        x *= 2;
+        x -= a * b;
+        x /= 4;
+
+        for (size_t n = 0; n < x.size(); ++n)
+        {
+            CHECK(math::near(x[n], ((a[n] + b[n]) * 2 - a[n] * b[n]) / 4));
+        }
+    }
+
+    SECTION("compound assignment does not reallocate")
+    {
+        auto        x    = a;
+        const auto* data = x.data();
+
+        x += x * b;
+
+        CHECK(x.data() == data);
+
+        for (size_t n = 0; n < x.size(); ++n)
+        {
+            CHECK(math::near(x[n], a[n] + a[n] * b[n]));
+        }
+    }
+}
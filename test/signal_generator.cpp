@@ -1,7 +1,16 @@
+#include <algorithm>
 #include <catch2/catch_template_test_macros.hpp>
+#include <cmath>
+#include <complex>
+#include <tnt/dsp/analysis.hpp>
+#include <tnt/dsp/convolution.hpp>
+#include <tnt/dsp/fourier_transform.hpp>
 #include <tnt/dsp/signal.hpp>
 #include <tnt/dsp/signal_generator.hpp>
 #include <tnt/math/comparison.hpp>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 using namespace tnt;
 
@@ -97,3 +106,387 @@ TEMPLATE_TEST_CASE("signal_generator::sine", "[signal_generator][sine]", double,
         CHECK(math::near(x[n], sine[n]));
     }
 }
+
+TEMPLATE_TEST_CASE("signal_generator::complex_exponential",
+                   "[signal_generator][complex_exponential]",
+                   double,
+                   float)
+{
+    const size_t f_s = 1000;
+    const size_t N   = 10;
+
+    const TestType frequency   = -100;
+    const TestType amplitude   = 2;
+    const TestType phase_shift = static_cast<TestType>(M_PI) / 3;
+
+    const dsp::signal_generator<TestType> g(f_s, N);
+
+    const auto x = g.complex_exponential(frequency, amplitude, phase_shift);
+
+    REQUIRE(x.size() == N);
+    REQUIRE(x.sample_rate() == f_s);
+
+    for (size_t n = 0; n < N; ++n)
+    {
+        const auto theta = 2 * M_PI * frequency * static_cast<double>(n) / f_s + phase_shift;
+
+        CHECK(math::near(x[n].real(), static_cast<TestType>(amplitude * std::cos(theta))));
+        CHECK(math::near(x[n].imag(), static_cast<TestType>(amplitude * std::sin(theta))));
+    }
+}
+
+TEMPLATE_TEST_CASE("signal_generator long signals", "[signal_generator][accuracy]", double, float)
+{
+    // Long enough to cross many reseeds of the oscillator, with a size that is
+    // not a multiple of the number of lanes
+    const size_t f_s = 48000;
+    const size_t N   = 100003;
+
+    const TestType frequency   = 997;
+    const TestType phase_shift = static_cast<TestType>(0.25);
+
+    const dsp::signal_generator<TestType> g(f_s, N);
+
+    const auto c = g.cosine(frequency, 1, phase_shift);
+    const auto s = g.sine(frequency, 1, phase_shift);
+    const auto e = g.complex_exponential(frequency, 1, phase_shift);
+
+    REQUIRE(c.size() == N);
+    REQUIRE(s.size() == N);
+    REQUIRE(e.size() == N);
+
+    // Largest error against the exact waves
+    double error = 0;
+    for (size_t n = 0; n < N; ++n)
+    {
+        const auto theta = 2 * M_PI * frequency * static_cast<double>(n) / f_s + phase_shift;
+
+        error = std::max({error,
+                          std::abs(c[n] - std::cos(theta)),
+                          std::abs(s[n] - std::sin(theta)),
+                          std::abs(e[n].real() - std::cos(theta)),
+                          std::abs(e[n].imag() - std::sin(theta))});
+    }
+
+    INFO("error: " << error);
+    CHECK(error < (std::is_same_v<TestType, float> ? 1e-5 : 1e-10));
+}
+
+TEMPLATE_TEST_CASE("signal_generator lazy waves", "[signal_generator][lazy]", double, float)
+{
+    // Several blocks of the expression, with a size that is not a multiple of
+    // the block size or the number of lanes
+    const size_t f_s = 8000;
+    const size_t N   = 1500;
+
+    const TestType frequency   = 440;
+    const TestType amplitude   = 2;
+    const TestType phase_shift = static_cast<TestType>(0.5);
+
+    const dsp::signal_generator<TestType> g(f_s, N);
+
+    const auto cosine = g.cosine(frequency, amplitude, phase_shift);
+    const auto sine   = g.sine(frequency, amplitude, phase_shift);
+    const auto x      = g.white_noise();
+
+    SECTION("evaluated waves match the generated ones")
+    {
+        const dsp::signal<TestType> c = g.lazy_cosine(frequency, amplitude, phase_shift);
+        const dsp::signal<TestType> s = g.lazy_sine(frequency, amplitude, phase_shift);
+
+        REQUIRE(c.size() == N);
+        REQUIRE(c.sample_rate() == f_s);
+
+        for (size_t n = 0; n < N; ++n)
+        {
+            CHECK(math::near(c[n], cosine[n]));
+            CHECK(math::near(s[n], sine[n]));
+        }
+    }
+
+    SECTION("samples can be read one at a time")
+    {
+        const auto c = g.lazy_cosine(frequency, amplitude, phase_shift);
+
+        CHECK(c.size() == N);
+        CHECK(c.sample_rate() == f_s);
+
+        for (const auto n : {size_t(0), size_t(1), size_t(777), N - 1})
+        {
+            CHECK(math::near(c[n], cosine[n]));
+        }
+    }
+
+    SECTION("waves mix into other signals")
+    {
+        const dsp::signal<TestType> y = x * g.lazy_sine(frequency, amplitude, phase_shift) + x;
+
+        auto z  = x;
+        z      += g.lazy_cosine(frequency, amplitude, phase_shift);
+
+        REQUIRE(y.size() == N);
+        REQUIRE(z.size() == N);
+
+        for (size_t n = 0; n < N; ++n)
+        {
+            CHECK(math::near(y[n], x[n] * sine[n] + x[n]));
+            CHECK(math::near(z[n], x[n] + cosine[n]));
+        }
+    }
+
+    SECTION("complex exponential")
+    {
+        const auto e = g.complex_exponential(frequency, amplitude, phase_shift);
+
+        const dsp::signal<std::complex<TestType>> y =
+            g.lazy_complex_exponential(frequency, amplitude, phase_shift);
+
+        REQUIRE(y.size() == N);
+
+        for (size_t n = 0; n < N; ++n)
+        {
+            CHECK(math::near(y[n].real(), e[n].real()));
+            CHECK(math::near(y[n].imag(), e[n].imag()));
+        }
+    }
+
+    SECTION("fourier_transform of a lazy wave")
+    {
+        const auto X = dsp::fourier_transform(x * g.lazy_cosine(frequency, amplitude, phase_shift));
+        const auto Y = dsp::fourier_transform(dsp::signal<TestType>(x * cosine));
+
+        const auto Z = dsp::fourier_transform(g.lazy_complex_exponential(frequency));
+        const auto W = dsp::fourier_transform(g.complex_exponential(frequency));
+
+        REQUIRE(X.size() == N);
+        REQUIRE(Z.size() == N);
+
+        for (size_t m = 0; m < N; ++m)
+        {
+            CHECK(math::near(X[m].real(), Y[m].real()));
+            CHECK(math::near(X[m].imag(), Y[m].imag()));
+            CHECK(math::near(Z[m].real(), W[m].real()));
+            CHECK(math::near(Z[m].imag(), W[m].imag()));
+        }
+    }
+
+    SECTION("convolve with a lazy wave")
+    {
+        const auto y = dsp::convolve(x, g.lazy_sine(frequency, amplitude, phase_shift));
+        const auto z = dsp::convolve(x, sine);
+
+        REQUIRE(y.size() == N);
+
+        for (size_t n = 0; n < N; ++n)
+        {
+            CHECK(math::near(y[n], z[n]));
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("signal_generator chirps", "[signal_generator][chirp]", double, float)
+{
+    const size_t f_s = 8000;
+    const size_t N   = 10001;
+
+    const dsp::signal_generator<TestType> g(f_s, N);
+
+    const TestType f_0         = 20;
+    const TestType f_1         = 3000;
+    const TestType amplitude   = 2;
+    const TestType phase_shift = static_cast<TestType>(0.3);
+
+    // Time of the last sample
+    const auto T = static_cast<double>(N - 1) / f_s;
+
+    const auto tolerance = std::is_same_v<TestType, float> ? 1e-4 : 1e-9;
+
+    SECTION("linear_chirp")
+    {
+        const auto x = g.linear_chirp(f_0, f_1, amplitude, phase_shift);
+
+        REQUIRE(x.size() == N);
+        REQUIRE(x.sample_rate() == f_s);
+
+        double error = 0;
+        for (size_t n = 0; n < N; ++n)
+        {
+            const auto t     = static_cast<double>(n) / f_s;
+            const auto theta = phase_shift + 2 * M_PI * (f_0 * t + (f_1 - f_0) * t * t / (2 * T));
+
+            error = std::max(error, std::abs(x[n] - amplitude * std::cos(theta)));
+        }
+
+        INFO("error: " << error);
+        CHECK(error < tolerance);
+    }
+
+    SECTION("logarithmic_chirp")
+    {
+        const auto x = g.logarithmic_chirp(f_0, f_1, amplitude, phase_shift);
+
+        REQUIRE(x.size() == N);
+        REQUIRE(x.sample_rate() == f_s);
+
+        const auto k = static_cast<double>(f_1) / f_0;
+
+        double error = 0;
+        for (size_t n = 0; n < N; ++n)
+        {
+            const auto t      = static_cast<double>(n) / f_s;
+            const auto cycles = f_0 * T * (std::pow(k, t / T) - 1) / std::log(k);
+            const auto theta  = phase_shift + 2 * M_PI * cycles;
+
+            error = std::max(error, std::abs(x[n] - amplitude * std::cos(theta)));
+        }
+
+        INFO("error: " << error);
+        CHECK(error < tolerance);
+    }
+
+    SECTION("chirps between equal frequencies are waves")
+    {
+        const auto x = g.linear_chirp(f_0, f_0, amplitude, phase_shift);
+        const auto y = g.logarithmic_chirp(f_0, f_0, amplitude, phase_shift);
+        const auto c = g.cosine(f_0, amplitude, phase_shift);
+
+        for (size_t n = 0; n < N; ++n)
+        {
+            REQUIRE(math::near(x[n], c[n]));
+            REQUIRE(math::near(y[n], c[n]));
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("signal_generator::multitone", "[signal_generator][multitone]", double, float)
+{
+    const size_t f_s = 1000;
+    const size_t N   = 1000;
+
+    const dsp::signal_generator<TestType> g(f_s, N);
+
+    const std::vector<TestType> frequencies = {50, 110, 170, 230};
+
+    const auto x = g.multitone(frequencies, 2);
+
+    REQUIRE(x.size() == N);
+
+    const auto K = static_cast<double>(frequencies.size());
+    for (size_t n = 0; n < N; ++n)
+    {
+        double expected = 0;
+        for (size_t k = 0; k < frequencies.size(); ++k)
+        {
+            const auto phase = -M_PI * static_cast<double>(k) * (static_cast<double>(k) - 1) / K;
+            const auto t     = static_cast<double>(n) / f_s;
+
+            expected += 2 * std::cos(2 * M_PI * frequencies[k] * t + phase);
+        }
+
+        CHECK(math::near(x[n], static_cast<TestType>(expected)));
+    }
+}
+
+TEMPLATE_TEST_CASE("signal_generator noise", "[signal_generator][noise]", double, float)
+{
+    const size_t f_s = 48000;
+    const size_t N   = 100003;
+
+    const dsp::signal_generator<TestType> g(f_s, N);
+
+    // Sample mean and standard deviation
+    const auto statistics = [](const dsp::signal<TestType>& x) {
+        double sum    = 0;
+        double sum_sq = 0;
+        for (const auto& sample : x)
+        {
+            sum    += sample;
+            sum_sq += static_cast<double>(sample) * sample;
+        }
+
+        const auto mean     = sum / static_cast<double>(x.size());
+        const auto variance = sum_sq / static_cast<double>(x.size()) - mean * mean;
+
+        return std::make_pair(mean, std::sqrt(variance));
+    };
+
+    SECTION("noise is reproducible from the seed")
+    {
+        const auto a = g.white_noise(1, 42);
+        const auto b = g.white_noise(1, 42);
+        const auto c = g.white_noise(1, 43);
+        const auto d = g.white_noise(1, 42, 1);
+
+        REQUIRE(a.size() == N);
+        CHECK(std::equal(a.begin(), a.end(), b.begin()));
+        CHECK(!std::equal(a.begin(), a.end(), c.begin()));
+        CHECK(!std::equal(a.begin(), a.end(), d.begin()));
+
+        const auto e = g.gaussian_noise(1, 42);
+        const auto f = g.gaussian_noise(1, 42);
+        CHECK(std::equal(e.begin(), e.end(), f.begin()));
+    }
+
+    SECTION("white_noise")
+    {
+        const auto x = g.white_noise(2, 7);
+
+        CHECK(*std::min_element(x.begin(), x.end()) >= -2);
+        CHECK(*std::max_element(x.begin(), x.end()) < 2);
+
+        // Uniform on [-a, a) has a standard deviation of a / sqrt(3)
+        const auto [mean, deviation] = statistics(x);
+        CHECK(std::abs(mean) < 0.02);
+        CHECK(std::abs(deviation - 2 / std::sqrt(3.0)) < 0.02);
+    }
+
+    SECTION("gaussian_noise")
+    {
+        const auto x = g.gaussian_noise(3, 7);
+
+        const auto [mean, deviation] = statistics(x);
+        CHECK(std::abs(mean) < 0.05);
+        CHECK(std::abs(deviation - 3) < 0.05);
+
+        // About 68% of the samples lie within one standard deviation
+        const auto within = std::count_if(x.begin(), x.end(), [](const auto& sample) {
+            return std::abs(sample) < 3;
+        });
+        CHECK(std::abs(static_cast<double>(within) / N - 0.6827) < 0.01);
+    }
+
+    SECTION("pink_noise")
+    {
+        const auto x = g.pink_noise(static_cast<TestType>(0.5), 7);
+
+        double energy = 0;
+        for (const auto& sample : x)
+        {
+            energy += static_cast<double>(sample) * sample;
+        }
+
+        CHECK(std::abs(std::sqrt(energy / N) - 0.5) < 1e-3);
+
+        // Power per Hz falls as 1 / f, so every octave holds the same power.
+        // Compare the power of two octaves that are 6 octaves apart.
+        const auto P = dsp::power(dsp::fourier_transform(x));
+
+        const auto octave_power = [&](const double f) {
+            const auto first = static_cast<size_t>(f * N / f_s);
+            const auto last  = static_cast<size_t>(2 * f * N / f_s);
+
+            double power = 0;
+            for (auto m = first; m < last; ++m)
+            {
+                power += P[m];
+            }
+
+            return power;
+        };
+
+        const auto ratio = octave_power(50) / octave_power(3200);
+        INFO("ratio: " << ratio);
+        CHECK(ratio > 0.5);
+        CHECK(ratio < 2);
+    }
+}
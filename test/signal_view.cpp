@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <catch2/catch_template_test_macros.hpp>
+#include <complex>
+#include <tnt/dsp/multisignal.hpp>
+#include <tnt/dsp/signal.hpp>
+#include <tnt/dsp/signal_generator.hpp>
+#include <tnt/dsp/signal_view.hpp>
+#include <tnt/math/comparison.hpp>
+#include <vector>
+
+using namespace tnt;
+
+TEMPLATE_TEST_CASE("signal_view construction", "[signal_view][construction]", double, float)
+{
+    const dsp::signal_generator<TestType> g(1000, 10);
+
+    SECTION("construct a view of an external buffer")
+    {
+        std::vector<TestType> buffer = {1, 2, 3, 4, 5, 6};
+
+        const dsp::signal_view<TestType> x(1000, buffer.data(), 3, 2);
+
+        CHECK(x.sample_rate() == 1000);
+        CHECK(x.size() == 3);
+        CHECK(x.stride() == 2);
+        CHECK(!x.contiguous());
+        CHECK(x[0] == 1);
+        CHECK(x[1] == 3);
+        CHECK(x[2] == 5);
+
+        x[1] = 7;
+        CHECK(buffer[2] == 7);
+    }
+
+    SECTION("construct a view of a signal")
+    {
+        const auto x      = g.cosine(100);
+        const auto x_view = x.view();
+
+        CHECK(x_view.sample_rate() == x.sample_rate());
+        CHECK(x_view.contiguous());
+        CHECK(x_view.data() == x.data());
+        REQUIRE(x_view.size() == x.size());
+
+        for (size_t n = 0; n < x.size(); ++n)
+        {
+            CHECK(math::near(x_view[n], x[n]));
+        }
+    }
+
+    SECTION("construct a constant view from a mutable view")
+    {
+        auto x = g.cosine(100);
+
+        const dsp::signal_view<const TestType> x_view = x.view();
+
+        CHECK(x_view.data() == x.data());
+        CHECK(x_view.size() == x.size());
+    }
+
+    SECTION("construct a signal from a view")
+    {
+        const auto x = g.cosine(100);
+
+        const dsp::signal<TestType> x_copy(x.view().subview(1, 4, 2));
+
+        CHECK(x_copy.sample_rate() == x.sample_rate());
+        REQUIRE(x_copy.size() == 4);
+
+        for (size_t n = 0; n < x_copy.size(); ++n)
+        {
+            CHECK(math::near(x_copy[n], x[1 + 2 * n]));
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("signal_view accessors", "[signal_view][accessors]", double, float)
+{
+    const dsp::signal_generator<TestType> g(1000, 10);
+
+    const auto x = g.cosine(100);
+
+    SECTION("duration")
+    {
+        CHECK(math::near(x.view().subview(0, 5).duration(), 0.005));
+    }
+
+    SECTION("subview")
+    {
+        const auto x_view = x.view().subview(2, 3, 3);
+
+        CHECK(x_view.stride() == 3);
+        REQUIRE(x_view.size() == 3);
+
+        for (size_t n = 0; n < x_view.size(); ++n)
+        {
+            CHECK(math::near(x_view[n], x[2 + 3 * n]));
+        }
+
+        const auto x_subview = x_view.subview(1, 2);
+
+        CHECK(x_subview.stride() == 3);
+        REQUIRE(x_subview.size() == 2);
+        CHECK(math::near(x_subview[0], x[5]));
+        CHECK(math::near(x_subview[1], x[8]));
+    }
+}
+
+TEMPLATE_TEST_CASE("signal_view iterators", "[signal_view][iterators]", double, float)
+{
+    const dsp::signal_generator<TestType> g(1000, 10);
+
+    SECTION("constant iterators")
+    {
+        const auto x      = g.cosine(100);
+        const auto x_view = x.view().subview(1, 5, 2);
+
+        REQUIRE(x_view.end() - x_view.begin() == 5);
+
+        size_t n = 1;
+        for (const auto& sample : x_view)
+        {
+            CHECK(math::near(sample, x[n]));
+            n += 2;
+        }
+    }
+
+    SECTION("mutable iterators")
+    {
+        auto       x      = g.cosine(100);
+        const auto x_view = x.view().subview(0, 5, 2);
+
+        std::fill(x_view.begin(), x_view.end(), TestType{1});
+
+        for (size_t n = 0; n < x.size(); ++n)
+        {
+            if (n % 2 == 0)
+            {
+                CHECK(x[n] == 1);
+            }
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("signal_view channels", "[signal_view][multisignal]", double, float)
+{
+    // Two interleaved channels
+    std::vector<TestType> buffer = {1, -1, 2, -2, 3, -3};
+
+    const dsp::signal_view<const TestType> left(1000, buffer.data(), 3, 2);
+    const dsp::signal_view<const TestType> right(1000, buffer.data() + 1, 3, 2);
+
+    dsp::multisignal<TestType> x(1000);
+    x.add_channel(left);
+    x.add_channel(right);
+
+    REQUIRE(x.size() == 3);
+    REQUIRE(x.channels() == 2);
+
+    for (size_t n = 0; n < x.size(); ++n)
+    {
+        CHECK(x[n][0] == static_cast<TestType>(n + 1));
+        CHECK(x[n][1] == -static_cast<TestType>(n + 1));
+    }
+}
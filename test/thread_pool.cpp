@@ -0,0 +1,88 @@
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <stdexcept>
+#include <tnt/dsp/thread_pool.hpp>
+#include <vector>
+
+using namespace tnt;
+
+TEST_CASE("thread_pool", "[thread_pool]")
+{
+    SECTION("parallel_for calls the function once for each index")
+    {
+        for (size_t threads = 1; threads <= 4; ++threads)
+        {
+            dsp::thread_pool pool(threads);
+            REQUIRE(pool.size() == threads);
+
+            std::vector<std::atomic<size_t>> calls(100);
+            pool.parallel_for(calls.size(), [&](const size_t i) {
+                ++calls[i];
+            });
+
+            for (const auto& count : calls)
+            {
+                CHECK(count.load() == 1);
+            }
+        }
+    }
+
+    SECTION("parallel_for handles no indices")
+    {
+        dsp::thread_pool pool(2);
+
+        size_t calls = 0;
+        pool.parallel_for(0, [&](const size_t) {
+            ++calls;
+        });
+
+        CHECK(calls == 0);
+    }
+
+    SECTION("parallel_for can be nested")
+    {
+        dsp::thread_pool pool(3);
+
+        std::atomic<size_t> calls(0);
+        pool.parallel_for(8, [&](const size_t) {
+            pool.parallel_for(8, [&](const size_t) {
+                ++calls;
+            });
+        });
+
+        CHECK(calls.load() == 64);
+    }
+
+    SECTION("exceptions are rethrown once every call has finished")
+    {
+        dsp::thread_pool pool(4);
+
+        std::atomic<size_t> calls(0);
+        CHECK_THROWS_AS(pool.parallel_for(16,
+                                          [&](const size_t i) {
+                                              ++calls;
+                                              if (i == 5)
+                                              {
+                                                  throw std::runtime_error("failed");
+                                              }
+                                          }),
+                        std::runtime_error);
+
+        CHECK(calls.load() == 16);
+    }
+
+    SECTION("the pool can be reused")
+    {
+        dsp::thread_pool pool(4);
+
+        for (size_t round = 0; round < 50; ++round)
+        {
+            std::atomic<size_t> sum(0);
+            pool.parallel_for(10, [&](const size_t i) {
+                sum += i;
+            });
+
+            REQUIRE(sum.load() == 45);
+        }
+    }
+}
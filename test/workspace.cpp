@@ -0,0 +1,159 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <complex>
+#include <thread>
+#include <tnt/dsp/aligned_allocator.hpp>
+#include <tnt/dsp/convolution.hpp>
+#include <tnt/dsp/fourier_transform.hpp>
+#include <tnt/dsp/hilbert_transform.hpp>
+#include <tnt/dsp/signal.hpp>
+#include <tnt/dsp/signal_generator.hpp>
+#include <tnt/dsp/workspace.hpp>
+#include <tnt/math/comparison.hpp>
+
+using namespace tnt;
+
+TEMPLATE_TEST_CASE("workspace allocation", "[workspace][allocation]", double, float)
+{
+    SECTION("allocations are aligned")
+    {
+        dsp::workspace w;
+
+        auto* const a = w.template allocate<std::complex<TestType>>(3);
+        auto* const b = w.template allocate<TestType>(5);
+
+        CHECK(dsp::impl::is_aligned(a));
+        CHECK(dsp::impl::is_aligned(b));
+        CHECK(w.used() >= 3 * sizeof(std::complex<TestType>) + 5 * sizeof(TestType));
+        CHECK(w.capacity() >= w.used());
+    }
+
+    SECTION("released storage is reused")
+    {
+        dsp::workspace w(1024);
+
+        const auto  m = w.mark();
+        auto* const a = w.template allocate<TestType>(100);
+        w.release(m);
+        auto* const b = w.template allocate<TestType>(100);
+
+        CHECK(a == b);
+        CHECK(w.capacity() == 1024);
+    }
+
+    SECTION("samples are not zeroed")
+    {
+        dsp::workspace w(1024);
+
+        const auto  m = w.mark();
+        auto* const a = w.template allocate<std::complex<TestType>>(4);
+        a[3]          = std::complex<TestType>(1, 2);
+        w.release(m);
+
+        auto* const b = w.template allocate<std::complex<TestType>>(4);
+
+        REQUIRE(a == b);
+        CHECK(b[3] == std::complex<TestType>(1, 2));
+    }
+
+    SECTION("growing past the reserved capacity keeps earlier allocations")
+    {
+        dsp::workspace w(64);
+
+        auto* const a = w.template allocate<TestType>(4);
+        a[3]          = 7;
+
+        auto* const b = w.template allocate<TestType>(100000);
+        b[99999]      = 8;
+
+        CHECK(a[3] == 7);
+        CHECK(b[99999] == 8);
+        CHECK(w.capacity() >= 64 + 100000 * sizeof(TestType));
+    }
+
+    SECTION("reset merges the blocks")
+    {
+        dsp::workspace w(64);
+
+        w.template allocate<TestType>(4);
+        w.template allocate<TestType>(100000);
+
+        const auto capacity = w.capacity();
+        w.reset();
+
+        CHECK(w.used() == 0);
+        CHECK(w.capacity() == capacity);
+
+        // Everything fits in the merged block
+        w.template allocate<TestType>(4);
+        w.template allocate<TestType>(100000);
+        CHECK(w.capacity() == capacity);
+    }
+}
+
+TEMPLATE_TEST_CASE("workspace use by transforms", "[workspace][transforms]", double, float)
+{
+    const dsp::signal_generator<TestType> g(1000, 1000);
+
+    // Non-power of 2 size so the Bluestein algorithm is used as well
+    const dsp::signal<TestType> x = g.cosine(100) + g.sine(230);
+
+    SECTION("transforms release everything they draw from the workspace")
+    {
+        auto& w = dsp::current_workspace();
+
+        const auto used = w.used();
+        dsp::fourier_transform(x);
+        dsp::hilbert_transform(x);
+        dsp::convolve(x, x);
+
+        CHECK(w.used() == used);
+    }
+
+    SECTION("repeated transforms do not grow the workspace")
+    {
+        auto& w = dsp::current_workspace();
+
+        dsp::fourier_transform(x);
+        const auto capacity = w.capacity();
+        dsp::fourier_transform(x);
+
+        CHECK(w.capacity() == capacity);
+    }
+
+    SECTION("use a caller-owned workspace")
+    {
+        const auto X = dsp::fourier_transform(x);
+
+        dsp::workspace w;
+        {
+            dsp::workspace_scope scope(w);
+            CHECK(&dsp::current_workspace() == &w);
+
+            const auto X_w = dsp::fourier_transform(x);
+
+            REQUIRE(X_w.size() == X.size());
+            for (size_t m = 0; m < X.size(); ++m)
+            {
+                CHECK(math::near(X_w[m].real(), X[m].real()));
+                CHECK(math::near(X_w[m].imag(), X[m].imag()));
+            }
+        }
+
+        CHECK(&dsp::current_workspace() == &dsp::thread_workspace());
+        CHECK(w.capacity() > 0);
+        CHECK(w.used() == 0);
+    }
+
+    SECTION("each thread uses its own workspace")
+    {
+        const auto* main  = &dsp::current_workspace();
+        const auto* other = main;
+
+        std::thread t([&] {
+            other = &dsp::current_workspace();
+        });
+        t.join();
+
+        CHECK(other != main);
+    }
+}